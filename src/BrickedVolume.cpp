@@ -0,0 +1,186 @@
+#include "BrickedVolume.h"
+#include "VolumeKernels.h"
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+	// Copy the voxels of `box` from `src` (laid out over srcExt) to `dst` (laid out over
+	// dstExt), both x-fastest. E is the copy unit and k the units per voxel, so the common
+	// 1/2/4/8-byte voxels move as single loads and stores.
+	template <typename E>
+	void copyBoxTyped(const unsigned char* src, const int srcExt[6], unsigned char* dst, const int dstExt[6],
+		const int box[6], std::size_t k)
+	{
+		const std::size_t sx = static_cast<std::size_t>(srcExt[1] - srcExt[0] + 1);
+		const std::size_t sy = static_cast<std::size_t>(srcExt[3] - srcExt[2] + 1);
+		const std::size_t dx = static_cast<std::size_t>(dstExt[1] - dstExt[0] + 1);
+		const std::size_t dy = static_cast<std::size_t>(dstExt[3] - dstExt[2] + 1);
+		const std::size_t n = static_cast<std::size_t>(box[1] - box[0] + 1) * k;
+
+		const E* s0 = reinterpret_cast<const E*>(src);
+		E* d0 = reinterpret_cast<E*>(dst);
+		for (int z = box[4]; z <= box[5]; ++z) {
+			for (int y = box[2]; y <= box[3]; ++y) {
+				const E* s = s0 + k * ((box[0] - srcExt[0]) + sx * ((y - srcExt[2]) + sy * static_cast<std::size_t>(z - srcExt[4])));
+				E* d = d0 + k * ((box[0] - dstExt[0]) + dx * ((y - dstExt[2]) + dy * static_cast<std::size_t>(z - dstExt[4])));
+				for (std::size_t i = 0; i < n; ++i) d[i] = s[i];
+			}
+		}
+	}
+
+	void copyBox(int elementSize, const unsigned char* src, const int srcExt[6], unsigned char* dst,
+		const int dstExt[6], const int box[6])
+	{
+		switch (elementSize) {
+			case 1: copyBoxTyped<std::uint8_t>(src, srcExt, dst, dstExt, box, 1); break;
+			case 2: copyBoxTyped<std::uint16_t>(src, srcExt, dst, dstExt, box, 1); break;
+			case 4: copyBoxTyped<std::uint32_t>(src, srcExt, dst, dstExt, box, 1); break;
+			case 8: copyBoxTyped<std::uint64_t>(src, srcExt, dst, dstExt, box, 1); break;
+			default: copyBoxTyped<std::uint8_t>(src, srcExt, dst, dstExt, box, static_cast<std::size_t>(elementSize)); break;
+		}
+	}
+}
+
+std::shared_ptr<BrickedVolume> BrickedVolume::fromImage(vtkImageData* image)
+{
+	vtkDataArray* scalars = image && image->GetPointData() ? image->GetPointData()->GetScalars() : nullptr;
+	if (!scalars || scalars->GetNumberOfTuples() == 0) return nullptr;
+
+	std::shared_ptr<BrickedVolume> volume(new BrickedVolume());
+	image->GetExtent(volume->m_extent);
+	image->GetSpacing(volume->m_spacing);
+	image->GetOrigin(volume->m_origin);
+	volume->m_scalarType = scalars->GetDataType();
+	volume->m_numComponents = scalars->GetNumberOfComponents();
+	volume->m_elementSize = scalars->GetDataTypeSize() * volume->m_numComponents;
+
+	for (int a = 0; a < 3; ++a) {
+		const int n = volume->m_extent[2 * a + 1] - volume->m_extent[2 * a] + 1;
+		if (n <= 0) return nullptr;
+		volume->m_bricks[a] = (n + BrickSize - 1) / BrickSize;
+	}
+
+	// Lay out the bricks back to back; edge bricks are cropped
+	const std::size_t brickCount = static_cast<std::size_t>(volume->m_bricks[0]) * volume->m_bricks[1] * volume->m_bricks[2];
+	volume->m_brickOffset.resize(brickCount);
+	std::size_t offset = 0;
+	for (int bz = 0; bz < volume->m_bricks[2]; ++bz) {
+		for (int by = 0; by < volume->m_bricks[1]; ++by) {
+			for (int bx = 0; bx < volume->m_bricks[0]; ++bx) {
+				int be[6];
+				volume->brickExtent(bx, by, bz, be);
+				volume->m_brickOffset[volume->brickIndex(bx, by, bz)] = offset;
+				offset += static_cast<std::size_t>(be[1] - be[0] + 1) * (be[3] - be[2] + 1) * (be[5] - be[4] + 1) *
+					static_cast<std::size_t>(volume->m_elementSize);
+			}
+		}
+	}
+
+	// The parallel copy below is the first touch
+	volume->m_data.reset(static_cast<unsigned char*>(VolumeAllocator::allocate(offset, false)));
+	if (!volume->m_data) return nullptr;
+	volume->m_bytes = offset;
+
+	const unsigned char* src = static_cast<const unsigned char*>(scalars->GetVoidPointer(0));
+	BrickedVolume* v = volume.get();
+	vtkSMPTools::For(0, static_cast<vtkIdType>(brickCount), [v, src](vtkIdType begin, vtkIdType end) {
+		for (vtkIdType n = begin; n < end; ++n) {
+			const int index = static_cast<int>(n);
+			const int bx = index % v->m_bricks[0];
+			const int by = (index / v->m_bricks[0]) % v->m_bricks[1];
+			const int bz = index / (v->m_bricks[0] * v->m_bricks[1]);
+			int be[6];
+			v->brickExtent(bx, by, bz, be);
+			copyBox(v->m_elementSize, src, v->m_extent, v->m_data.get() + v->m_brickOffset[index], be, be);
+		}
+	});
+	return volume;
+}
+
+void BrickedVolume::brickExtent(int bx, int by, int bz, int ext[6]) const
+{
+	const int b[3] = { bx, by, bz };
+	for (int a = 0; a < 3; ++a) {
+		ext[2 * a] = m_extent[2 * a] + b[a] * BrickSize;
+		ext[2 * a + 1] = std::min(ext[2 * a] + BrickSize - 1, m_extent[2 * a + 1]);
+	}
+}
+
+std::size_t BrickedVolume::offsetInBrick(const int brickExt[6], int i, int j, int k)
+{
+	const std::size_t bw = static_cast<std::size_t>(brickExt[1] - brickExt[0] + 1);
+	const std::size_t bh = static_cast<std::size_t>(brickExt[3] - brickExt[2] + 1);
+	return (i - brickExt[0]) + bw * ((j - brickExt[2]) + bh * static_cast<std::size_t>(k - brickExt[4]));
+}
+
+void BrickedVolume::getExtent(int extent[6]) const { std::copy(m_extent, m_extent + 6, extent); }
+void BrickedVolume::getSpacing(double spacing[3]) const { std::copy(m_spacing, m_spacing + 3, spacing); }
+void BrickedVolume::getOrigin(double origin[3]) const { std::copy(m_origin, m_origin + 3, origin); }
+
+bool BrickedVolume::extractSlice(int axis, int index, vtkImageData* slice)
+{
+	if (!slice || !m_data || axis < 0 || axis > 2) return false;
+	if (index < m_extent[2 * axis] || index > m_extent[2 * axis + 1]) return false;
+
+	int outExt[6];
+	std::copy(m_extent, m_extent + 6, outExt);
+	outExt[2 * axis] = outExt[2 * axis + 1] = index;
+
+	slice->SetExtent(outExt);
+	slice->SetSpacing(m_spacing);
+	slice->SetOrigin(m_origin);
+	slice->AllocateScalars(m_scalarType, m_numComponents);
+	unsigned char* out = static_cast<unsigned char*>(slice->GetScalarPointer());
+
+	// One layer of bricks along `axis` crosses the plane
+	const int u = (axis + 1) % 3;
+	const int v = (axis + 2) % 3;
+	const int layer = (index - m_extent[2 * axis]) / BrickSize;
+	const vtkIdType count = static_cast<vtkIdType>(m_bricks[u]) * m_bricks[v];
+
+	vtkSMPTools::For(0, count, [&](vtkIdType begin, vtkIdType end) {
+		for (vtkIdType n = begin; n < end; ++n) {
+			int b[3];
+			b[axis] = layer;
+			b[u] = static_cast<int>(n % m_bricks[u]);
+			b[v] = static_cast<int>(n / m_bricks[u]);
+			int be[6];
+			brickExtent(b[0], b[1], b[2], be);
+			int box[6];
+			std::copy(be, be + 6, box);
+			box[2 * axis] = box[2 * axis + 1] = index;
+			copyBox(m_elementSize, m_data.get() + m_brickOffset[brickIndex(b[0], b[1], b[2])], be, out, outExt, box);
+		}
+	});
+
+	slice->Modified();
+	return true;
+}
+
+double BrickedVolume::voxelValue(int i, int j, int k)
+{
+	if (!m_data) return 0.0;
+	const int p[3] = { i, j, k };
+	int b[3];
+	for (int a = 0; a < 3; ++a) {
+		if (p[a] < m_extent[2 * a] || p[a] > m_extent[2 * a + 1]) return 0.0;
+		b[a] = (p[a] - m_extent[2 * a]) / BrickSize;
+	}
+	int be[6];
+	brickExtent(b[0], b[1], b[2], be);
+	const unsigned char* voxel = m_data.get() + m_brickOffset[brickIndex(b[0], b[1], b[2])] +
+		offsetInBrick(be, i, j, k) * static_cast<std::size_t>(m_elementSize);
+
+	// First component
+	double value = 0.0;
+	VolumeKernels::dispatch(m_scalarType, [&](auto tag) {
+		value = static_cast<double>(*reinterpret_cast<const VolumeKernels::ValueType<decltype(tag)>*>(voxel));
+	});
+	return value;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "SliceProvider.h"
+#include "VolumeAllocator.h"
+
+#include <vtkType.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class vtkImageData;
+
+// Uncompressed copy of a volume in BrickSize^3 bricks, for orthogonal slicing.
+//
+// In vtkImageData's x-fastest layout an XY slice is one contiguous run, but YZ and XZ
+// slices touch one voxel (YZ) or one row (XZ) per x-y plane, so on multi-GB volumes
+// every voxel is a cache miss and every plane a TLB miss. Here each brick is contiguous
+// (32 KB-256 KB), so a slice in any orientation reads whole bricks and all three
+// orientations scrub at similar speed.
+//
+// Bricks at the upper faces are cropped to the extent rather than padded, so thin
+// volumes do not pay for unused voxels.
+class BrickedVolume : public SliceProvider
+{
+public:
+	static constexpr int BrickSize = 32;
+
+	// Re-layout `image` in parallel; nullptr if it has no scalars
+	static std::shared_ptr<BrickedVolume> fromImage(vtkImageData* image);
+
+	// SliceProvider
+	void getExtent(int extent[6]) const override;
+	void getSpacing(double spacing[3]) const override;
+	void getOrigin(double origin[3]) const override;
+	int scalarType() const override { return m_scalarType; }
+	bool extractSlice(int axis, int index, vtkImageData* slice) override;
+	double voxelValue(int i, int j, int k) override;
+
+	int numberOfComponents() const { return m_numComponents; }
+	unsigned long long memoryBytes() const { return m_bytes; }
+
+private:
+	BrickedVolume() = default;
+
+	int brickIndex(int bx, int by, int bz) const { return bx + m_bricks[0] * (by + m_bricks[1] * bz); }
+	void brickExtent(int bx, int by, int bz, int ext[6]) const;
+	// Offset (in elements) of voxel (i, j, k) inside its brick
+	static std::size_t offsetInBrick(const int brickExt[6], int i, int j, int k);
+
+	int m_extent[6] = { 0, -1, 0, -1, 0, -1 };
+	double m_spacing[3] = { 1.0, 1.0, 1.0 };
+	double m_origin[3] = { 0.0, 0.0, 0.0 };
+	int m_scalarType = VTK_VOID;
+	int m_numComponents = 1;
+	int m_elementSize = 0;     // bytes per voxel (all components)
+	int m_bricks[3] = { 0, 0, 0 };
+
+	// Bricks in x-fastest brick order; each brick is x-fastest inside
+	std::unique_ptr<unsigned char, void (*)(void*)> m_data{ nullptr, &VolumeAllocator::release };
+	std::vector<std::size_t> m_brickOffset; // byte offset of each brick in m_data
+	unsigned long long m_bytes = 0;
+};
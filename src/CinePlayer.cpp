@@ -0,0 +1,95 @@
+#include "CinePlayer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	constexpr double kMinFrameRate = 0.5;
+	constexpr double kMaxFrameRate = 240.0;
+}
+
+CinePlayer::CinePlayer(QObject* parent)
+	: QObject(parent)
+{
+	m_timer.setTimerType(Qt::PreciseTimer);
+	connect(&m_timer, &QTimer::timeout, this, &CinePlayer::onTick);
+}
+
+void CinePlayer::setRange(int first, int last)
+{
+	m_first = std::min(first, last);
+	m_last = std::max(first, last);
+}
+
+void CinePlayer::setFrameRate(double fps)
+{
+	fps = std::clamp(fps, kMinFrameRate, kMaxFrameRate);
+	if (fps == m_fps) return;
+
+	// Continue from the current frame at the new rate
+	if (isPlaying()) m_startPosition += m_shown;
+	m_fps = fps;
+	if (isPlaying()) restartClock();
+}
+
+void CinePlayer::setMode(Mode mode)
+{
+	m_mode = mode;
+}
+
+void CinePlayer::start(int index)
+{
+	m_startPosition = std::clamp(index, m_first, m_last) - m_first;
+	m_dropped = 0;
+	const bool wasPlaying = isPlaying();
+	restartClock();
+	if (!wasPlaying) emit playingChanged(true);
+}
+
+void CinePlayer::stop()
+{
+	if (!isPlaying()) return;
+	m_timer.stop();
+	emit playingChanged(false);
+}
+
+void CinePlayer::restartClock()
+{
+	m_shown = 0;
+	m_clock.start();
+	m_statsClock.start();
+	m_statsFrames = 0;
+	// Tick no slower than the frame period; ticks with no frame due are no-ops
+	m_timer.start(std::max(1, static_cast<int>(1000.0 / m_fps)));
+}
+
+int CinePlayer::indexAt(long long position) const
+{
+	const long long n = static_cast<long long>(m_last) - m_first + 1;
+	if (n <= 1) return m_first;
+	if (m_mode == Loop) return m_first + static_cast<int>(position % n);
+
+	// Bounce: first .. last .. first + 1, then repeat
+	const long long period = 2 * (n - 1);
+	const long long q = position % period;
+	return m_first + static_cast<int>(q < n ? q : period - q);
+}
+
+void CinePlayer::onTick()
+{
+	const long long due = static_cast<long long>(std::floor(m_clock.nsecsElapsed() * 1e-9 * m_fps));
+	if (due <= m_shown) return;
+
+	// Everything between the last shown frame and the due one is skipped
+	m_dropped += static_cast<int>(due - m_shown - 1);
+	m_shown = due;
+	++m_statsFrames;
+	emit frame(indexAt(m_startPosition + m_shown));
+
+	const qint64 ms = m_statsClock.elapsed();
+	if (ms >= 1000) {
+		emit statistics(m_statsFrames * 1000.0 / ms, m_dropped);
+		m_statsClock.start();
+		m_statsFrames = 0;
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+// Clock for cine playback of a slice range.
+//
+// Frames are scheduled against wall time rather than counted per timer tick: each tick
+// shows the frame that is due now, so playback keeps its rate when rendering or slice
+// extraction falls behind, and the frames skipped on the way are counted as dropped.
+// Loop restarts at the first slice; Bounce reverses at both ends.
+class CinePlayer : public QObject
+{
+	Q_OBJECT
+public:
+	enum Mode { Loop, Bounce };
+	Q_ENUM(Mode)
+
+	explicit CinePlayer(QObject* parent = nullptr);
+
+	void setRange(int first, int last);
+	void setFrameRate(double fps);
+	double frameRate() const { return m_fps; }
+	void setMode(Mode mode);
+	Mode mode() const { return m_mode; }
+
+	// Play from `index` (clamped to the range)
+	void start(int index);
+	void stop();
+	bool isPlaying() const { return m_timer.isActive(); }
+
+	// Frames skipped since start()
+	int droppedFrames() const { return m_dropped; }
+
+signals:
+	// Show slice `index` now
+	void frame(int index);
+	// Shown frame rate over the last second and frames dropped since start()
+	void statistics(double shownFps, int droppedFrames);
+	void playingChanged(bool playing);
+
+private:
+	void onTick();
+	// Slice for frame `position` frames after the first of the range
+	int indexAt(long long position) const;
+	void restartClock();
+
+	QTimer m_timer;
+	QElapsedTimer m_clock;
+	double m_fps = 30.0;
+	Mode m_mode = Loop;
+	int m_first = 0;
+	int m_last = 0;
+
+	long long m_startPosition = 0; // position of the slice start() was called with
+	long long m_shown = 0;         // frames since the clock started, including dropped ones
+	int m_dropped = 0;
+
+	QElapsedTimer m_statsClock;
+	int m_statsFrames = 0;
+};
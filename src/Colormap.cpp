@@ -0,0 +1,97 @@
+#include "Colormap.h"
+
+#include <vtkLookupTable.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	struct Stop
+	{
+		double t;
+		double r, g, b;
+	};
+
+	constexpr Stop kInverse[] = { { 0.0, 1.0, 1.0, 1.0 }, { 1.0, 0.0, 0.0, 0.0 } };
+	constexpr Stop kHot[] = {
+		{ 0.0, 0.0, 0.0, 0.0 }, { 0.375, 1.0, 0.0, 0.0 }, { 0.75, 1.0, 1.0, 0.0 }, { 1.0, 1.0, 1.0, 1.0 },
+	};
+	constexpr Stop kBone[] = {
+		{ 0.0, 0.0, 0.0, 0.0 }, { 0.375, 0.319, 0.319, 0.444 }, { 0.75, 0.652, 0.777, 0.777 }, { 1.0, 1.0, 1.0, 1.0 },
+	};
+	constexpr Stop kJet[] = {
+		{ 0.0, 0.0, 0.0, 0.5 }, { 0.125, 0.0, 0.0, 1.0 }, { 0.375, 0.0, 1.0, 1.0 },
+		{ 0.625, 1.0, 1.0, 0.0 }, { 0.875, 1.0, 0.0, 0.0 }, { 1.0, 0.5, 0.0, 0.0 },
+	};
+	constexpr Stop kViridis[] = {
+		{ 0.0, 0.267, 0.005, 0.329 }, { 0.25, 0.229, 0.322, 0.546 }, { 0.5, 0.128, 0.567, 0.551 },
+		{ 0.75, 0.369, 0.789, 0.383 }, { 1.0, 0.993, 0.906, 0.144 },
+	};
+
+	// Piecewise-linear colour at t in [0, 1]
+	template <std::size_t N>
+	void sample(const Stop (&stops)[N], double t, double rgb[3])
+	{
+		std::size_t i = 1;
+		while (i + 1 < N && stops[i].t < t) ++i;
+		const Stop& a = stops[i - 1];
+		const Stop& b = stops[i];
+		const double f = b.t > a.t ? std::clamp((t - a.t) / (b.t - a.t), 0.0, 1.0) : 0.0;
+		rgb[0] = a.r + f * (b.r - a.r);
+		rgb[1] = a.g + f * (b.g - a.g);
+		rgb[2] = a.b + f * (b.b - a.b);
+	}
+
+	// Colour of entry i of 256; false for Grayscale
+	bool entry(Colormap::Preset preset, int i, double rgb[3])
+	{
+		const double t = i / 255.0;
+		switch (preset) {
+			case Colormap::InverseGrayscale: sample(kInverse, t, rgb); return true;
+			case Colormap::Hot:              sample(kHot, t, rgb); return true;
+			case Colormap::Bone:             sample(kBone, t, rgb); return true;
+			case Colormap::Jet:              sample(kJet, t, rgb); return true;
+			case Colormap::Viridis:          sample(kViridis, t, rgb); return true;
+			default:                         return false;
+		}
+	}
+}
+
+const char* Colormap::name(Preset preset)
+{
+	switch (preset) {
+		case Grayscale:        return "Grayscale";
+		case InverseGrayscale: return "Inverse Grayscale";
+		case Hot:              return "Hot";
+		case Bone:             return "Bone";
+		case Jet:              return "Jet";
+		case Viridis:          return "Viridis";
+		default:               return "";
+	}
+}
+
+vtkSmartPointer<vtkLookupTable> Colormap::lookupTable(Preset preset)
+{
+	if (preset == Grayscale) return nullptr;
+	auto table = vtkSmartPointer<vtkLookupTable>::New();
+	table->SetNumberOfTableValues(256);
+	double rgb[3];
+	for (int i = 0; i < 256; ++i) {
+		if (!entry(preset, i, rgb)) return nullptr;
+		table->SetTableValue(i, rgb[0], rgb[1], rgb[2], 1.0);
+	}
+	return table;
+}
+
+std::vector<std::uint32_t> Colormap::packedTable(Preset preset)
+{
+	std::vector<std::uint32_t> table;
+	double rgb[3];
+	for (int i = 0; i < 256; ++i) {
+		if (!entry(preset, i, rgb)) return {};
+		std::uint32_t word = 0xFF000000u;
+		for (int c = 0; c < 3; ++c) word |= static_cast<std::uint32_t>(std::lround(rgb[c] * 255.0)) << (8 * c);
+		table.push_back(word);
+	}
+	return table;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vtkSmartPointer.h>
+
+#include <cstdint>
+#include <vector>
+
+class vtkLookupTable;
+
+// Colour maps for the slice views, applied across the window (lower edge = first entry,
+// upper edge = last entry).
+namespace Colormap
+{
+	enum Preset { Grayscale, InverseGrayscale, Hot, Bone, Jet, Viridis, PresetCount };
+
+	const char* name(Preset preset);
+
+	// 256-entry table for vtkImageProperty; nullptr for Grayscale (the property's own ramp)
+	vtkSmartPointer<vtkLookupTable> lookupTable(Preset preset);
+	// The same 256 entries as packed RGBA words (R in the low byte), for SliceCompositor;
+	// empty for Grayscale
+	std::vector<std::uint32_t> packedTable(Preset preset);
+}
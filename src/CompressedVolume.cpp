@@ -0,0 +1,441 @@
+#include "CompressedVolume.h"
+#include "VolumeAllocator.h"
+#include "VolumeIndex.h"
+#include "VolumeKernels.h"
+
+#include <vtkImageData.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace {
+	// Integer types that fit the int32 brick base and a <= 32-bit packed offset
+	template <typename T>
+	constexpr bool isStorable = std::is_integral_v<T> && sizeof(T) <= 2;
+
+	// Invoke f with a typed null pointer for each storable scalar type
+	template <typename F>
+	bool dispatchStorable(int scalarType, F&& f)
+	{
+		bool storable = false;
+		VolumeKernels::dispatch(scalarType, [&](auto tag) {
+			if constexpr (isStorable<VolumeKernels::ValueType<decltype(tag)>>) {
+				f(tag);
+				storable = true;
+			}
+		});
+		return storable;
+	}
+
+	int bitsFor(std::uint32_t range)
+	{
+		int bits = 0;
+		while (bits < 32 && (std::uint64_t(1) << bits) <= range) ++bits;
+		return bits;
+	}
+}
+
+bool CompressedVolume::supportsScalarType(int scalarType)
+{
+	return dispatchStorable(scalarType, [](auto*) {});
+}
+
+std::shared_ptr<CompressedVolume> CompressedVolume::fromImage(vtkImageData* image)
+{
+	if (!image || image->GetNumberOfScalarComponents() != 1) return nullptr;
+	if (!supportsScalarType(image->GetScalarType())) return nullptr;
+
+	auto volume = std::make_shared<CompressedVolume>(image->GetExtent(), image->GetSpacing(),
+		image->GetOrigin(), image->GetScalarType());
+	if (!volume->appendSlab(image) || !volume->isComplete()) return nullptr;
+	return volume;
+}
+
+CompressedVolume::CompressedVolume(const int extent[6], const double spacing[3], const double origin[3], int scalarType)
+	: m_scalarType(scalarType)
+	, m_scalarSize(0)
+{
+	std::copy(extent, extent + 6, m_extent);
+	std::copy(spacing, spacing + 3, m_spacing);
+	std::copy(origin, origin + 3, m_origin);
+
+	dispatchStorable(scalarType, [this](auto* tag) { m_scalarSize = sizeof(*tag); });
+
+	for (int a = 0; a < 3; ++a) {
+		const int n = std::max(m_extent[2 * a + 1] - m_extent[2 * a] + 1, 0);
+		m_bricks[a] = (n + BrickSize - 1) / BrickSize;
+	}
+	m_brickData.resize(static_cast<std::size_t>(m_bricks[0]) * m_bricks[1] * m_bricks[2]);
+	m_cacheBudget = defaultCacheBudgetBytes();
+}
+
+std::size_t CompressedVolume::defaultCacheBudgetBytes() const
+{
+	const std::size_t layers[3] = {
+		static_cast<std::size_t>(m_bricks[1]) * m_bricks[2],
+		static_cast<std::size_t>(m_bricks[0]) * m_bricks[2],
+		static_cast<std::size_t>(m_bricks[0]) * m_bricks[1] };
+	const std::size_t bricks = layers[0] + layers[1] + layers[2] + std::max({ layers[0], layers[1], layers[2] });
+	return std::max(bricks * brickBytes(), std::size_t(256) << 20);
+}
+
+void CompressedVolume::brickExtent(int bx, int by, int bz, int ext[6]) const
+{
+	const int b[3] = { bx, by, bz };
+	for (int a = 0; a < 3; ++a) {
+		ext[2 * a] = m_extent[2 * a] + b[a] * BrickSize;
+		ext[2 * a + 1] = std::min(ext[2 * a] + BrickSize - 1, m_extent[2 * a + 1]);
+	}
+}
+
+bool CompressedVolume::appendSlab(vtkImageData* slab)
+{
+	if (!slab || m_scalarSize == 0 || isComplete()) return false;
+	if (slab->GetScalarType() != m_scalarType || slab->GetNumberOfScalarComponents() != 1) return false;
+
+	int slabExt[6];
+	slab->GetExtent(slabExt);
+	if (slabExt[0] > m_extent[0] || slabExt[1] < m_extent[1] ||
+		slabExt[2] > m_extent[2] || slabExt[3] < m_extent[3]) {
+		return false;
+	}
+
+	bool consumed = false;
+	while (!isComplete()) {
+		int rowExt[6];
+		brickExtent(0, 0, m_nextBrickZ, rowExt);
+		if (slabExt[4] > rowExt[4] || slabExt[5] < rowExt[5]) break;
+
+		// Compress one row of bricks in parallel; bricks are independent
+		const int bz = m_nextBrickZ;
+		const vtkIdType rowCount = static_cast<vtkIdType>(m_bricks[0]) * m_bricks[1];
+		dispatchStorable(m_scalarType, [&](auto* tag) {
+			using T = std::remove_pointer_t<decltype(tag)>;
+			vtkSMPTools::For(0, rowCount, [&](vtkIdType begin, vtkIdType end) {
+				std::vector<std::int32_t> values;
+				for (vtkIdType r = begin; r < end; ++r) {
+					const int bx = static_cast<int>(r % m_bricks[0]);
+					const int by = static_cast<int>(r / m_bricks[0]);
+					int be[6];
+					brickExtent(bx, by, bz, be);
+
+					values.clear();
+					std::int32_t lo = std::numeric_limits<std::int32_t>::max();
+					std::int32_t hi = std::numeric_limits<std::int32_t>::lowest();
+					for (int z = be[4]; z <= be[5]; ++z) {
+						for (int y = be[2]; y <= be[3]; ++y) {
+							const T* p = static_cast<const T*>(slab->GetScalarPointer(be[0], y, z));
+							for (int x = be[0]; x <= be[1]; ++x, ++p) {
+								const std::int32_t v = static_cast<std::int32_t>(*p);
+								lo = std::min(lo, v);
+								hi = std::max(hi, v);
+								values.push_back(v);
+							}
+						}
+					}
+
+					Brick& brick = m_brickData[brickIndex(bx, by, bz)];
+					brick.base = lo;
+					brick.bits = static_cast<std::uint8_t>(bitsFor(static_cast<std::uint32_t>(hi - lo)));
+					brick.words.clear();
+					if (brick.bits == 0) continue;
+
+					// LSB-first bit stream, offsets may straddle word boundaries
+					const int bits = brick.bits;
+					brick.words.reserve((values.size() * bits + 63) / 64);
+					std::uint64_t acc = 0;
+					int filled = 0;
+					for (const std::int32_t v : values) {
+						const std::uint64_t d = static_cast<std::uint32_t>(v - lo);
+						acc |= d << filled;
+						filled += bits;
+						if (filled >= 64) {
+							brick.words.push_back(acc);
+							filled -= 64;
+							acc = filled ? (d >> (bits - filled)) : 0;
+						}
+					}
+					if (filled > 0) brick.words.push_back(acc);
+					brick.words.shrink_to_fit();
+				}
+			});
+		});
+
+		++m_nextBrickZ;
+		consumed = true;
+	}
+	return consumed;
+}
+
+void CompressedVolume::decodeInto(int index, unsigned char* out) const
+{
+	const Brick& brick = m_brickData[index];
+	const int bx = index % m_bricks[0];
+	const int by = (index / m_bricks[0]) % m_bricks[1];
+	const int bz = index / (m_bricks[0] * m_bricks[1]);
+	int be[6];
+	brickExtent(bx, by, bz, be);
+	const std::size_t n = static_cast<std::size_t>(be[1] - be[0] + 1) * (be[3] - be[2] + 1) * (be[5] - be[4] + 1);
+
+	dispatchStorable(m_scalarType, [&](auto* tag) {
+		using T = std::remove_pointer_t<decltype(tag)>;
+		T* o = reinterpret_cast<T*>(out);
+		if (brick.bits == 0) {
+			std::fill(o, o + n, static_cast<T>(brick.base));
+			return;
+		}
+		const int bits = brick.bits;
+		const std::uint64_t mask = (std::uint64_t(1) << bits) - 1;
+		const std::uint64_t* w = brick.words.data();
+		std::size_t bitPos = 0;
+		for (std::size_t i = 0; i < n; ++i, bitPos += bits) {
+			const std::size_t word = bitPos >> 6;
+			const int off = static_cast<int>(bitPos & 63);
+			std::uint64_t d = w[word] >> off;
+			if (off + bits > 64) d |= w[word + 1] << (64 - off);
+			o[i] = static_cast<T>(brick.base + static_cast<std::int32_t>(d & mask));
+		}
+	});
+}
+
+CompressedVolume::Decoded CompressedVolume::decodedBrick(int index)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_cacheMutex);
+		auto it = m_cache.find(index);
+		if (it != m_cache.end()) {
+			m_lru.splice(m_lru.begin(), m_lru, it->second.first);
+			return it->second.second;
+		}
+	}
+
+	// Decode outside the lock so concurrent misses on different bricks run in parallel
+	const std::size_t bytes = brickBytes();
+	auto buffer = std::make_shared<std::vector<unsigned char>>(bytes);
+	decodeInto(index, buffer->data());
+
+	std::lock_guard<std::mutex> lock(m_cacheMutex);
+	auto it = m_cache.find(index);
+	if (it != m_cache.end()) return it->second.second; // another thread won the race
+
+	m_lru.push_front(index);
+	m_cache.emplace(index, std::make_pair(m_lru.begin(), Decoded(buffer)));
+	m_cacheBytes += bytes;
+	while (m_cacheBytes > m_cacheBudget && m_lru.size() > 1) {
+		const int victim = m_lru.back();
+		m_lru.pop_back();
+		m_cache.erase(victim);
+		m_cacheBytes -= bytes;
+	}
+	return buffer;
+}
+
+void CompressedVolume::setCacheBudgetBytes(std::size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(m_cacheMutex);
+	m_cacheBudget = bytes > 0 ? bytes : defaultCacheBudgetBytes();
+	while (m_cacheBytes > m_cacheBudget && !m_lru.empty()) {
+		m_cache.erase(m_lru.back());
+		m_lru.pop_back();
+		m_cacheBytes -= brickBytes();
+	}
+}
+
+void CompressedVolume::getExtent(int extent[6]) const { std::copy(m_extent, m_extent + 6, extent); }
+void CompressedVolume::getSpacing(double spacing[3]) const { std::copy(m_spacing, m_spacing + 3, spacing); }
+void CompressedVolume::getOrigin(double origin[3]) const { std::copy(m_origin, m_origin + 3, origin); }
+
+bool CompressedVolume::extractSlice(int axis, int index, vtkImageData* slice)
+{
+	if (!slice || axis < 0 || axis > 2 || !isComplete()) return false;
+	if (index < m_extent[2 * axis] || index > m_extent[2 * axis + 1]) return false;
+
+	int outExt[6];
+	std::copy(m_extent, m_extent + 6, outExt);
+	outExt[2 * axis] = outExt[2 * axis + 1] = index;
+
+	slice->SetExtent(outExt);
+	slice->SetSpacing(m_spacing);
+	slice->SetOrigin(m_origin);
+	slice->AllocateScalars(m_scalarType, 1);
+	unsigned char* out = static_cast<unsigned char*>(slice->GetScalarPointer());
+
+	const std::size_t nx = static_cast<std::size_t>(outExt[1] - outExt[0] + 1);
+	const std::size_t ny = static_cast<std::size_t>(outExt[3] - outExt[2] + 1);
+
+	// Bricks crossed by the plane: one layer along `axis`
+	const int u = (axis + 1) % 3;
+	const int v = (axis + 2) % 3;
+	const int layer = (index - m_extent[2 * axis]) / BrickSize;
+	const vtkIdType count = static_cast<vtkIdType>(m_bricks[u]) * m_bricks[v];
+
+	vtkSMPTools::For(0, count, [&](vtkIdType begin, vtkIdType end) {
+		for (vtkIdType n = begin; n < end; ++n) {
+			int b[3];
+			b[axis] = layer;
+			b[u] = static_cast<int>(n % m_bricks[u]);
+			b[v] = static_cast<int>(n / m_bricks[u]);
+			const int index3 = brickIndex(b[0], b[1], b[2]);
+			int be[6];
+			brickExtent(b[0], b[1], b[2], be);
+
+			const Decoded decoded = decodedBrick(index3);
+			const unsigned char* src = decoded->data();
+			const std::size_t bw = static_cast<std::size_t>(be[1] - be[0] + 1);
+			const std::size_t bh = static_cast<std::size_t>(be[3] - be[2] + 1);
+
+			const int z0 = std::max(be[4], outExt[4]), z1 = std::min(be[5], outExt[5]);
+			const int y0 = std::max(be[2], outExt[2]), y1 = std::min(be[3], outExt[3]);
+			const int x0 = std::max(be[0], outExt[0]), x1 = std::min(be[1], outExt[1]);
+			const std::size_t rowBytes = static_cast<std::size_t>(x1 - x0 + 1) * m_scalarSize;
+			for (int z = z0; z <= z1; ++z) {
+				for (int y = y0; y <= y1; ++y) {
+					const std::size_t s = (x0 - be[0]) + bw * ((y - be[2]) + bh * static_cast<std::size_t>(z - be[4]));
+					const std::size_t d = (x0 - outExt[0]) + nx * ((y - outExt[2]) + ny * static_cast<std::size_t>(z - outExt[4]));
+					std::memcpy(out + d * m_scalarSize, src + s * m_scalarSize, rowBytes);
+				}
+			}
+		}
+	});
+
+	slice->Modified();
+	return true;
+}
+
+double CompressedVolume::voxelValue(int i, int j, int k)
+{
+	if (!isComplete()) return 0.0;
+	const int p[3] = { i, j, k };
+	for (int a = 0; a < 3; ++a) {
+		if (p[a] < m_extent[2 * a] || p[a] > m_extent[2 * a + 1]) return 0.0;
+	}
+	return Reader(*this).value(i, j, k);
+}
+
+double CompressedVolume::Reader::value(int i, int j, int k)
+{
+	const CompressedVolume& v = m_volume;
+	if (i < m_brickExtent[0] || i > m_brickExtent[1] || j < m_brickExtent[2] || j > m_brickExtent[3] ||
+		k < m_brickExtent[4] || k > m_brickExtent[5]) {
+		const int bx = (i - v.m_extent[0]) / BrickSize;
+		const int by = (j - v.m_extent[2]) / BrickSize;
+		const int bz = (k - v.m_extent[4]) / BrickSize;
+		v.brickExtent(bx, by, bz, m_brickExtent);
+		m_brick = m_volume.decodedBrick(v.brickIndex(bx, by, bz));
+	}
+
+	const std::size_t bw = static_cast<std::size_t>(m_brickExtent[1] - m_brickExtent[0] + 1);
+	const std::size_t bh = static_cast<std::size_t>(m_brickExtent[3] - m_brickExtent[2] + 1);
+	const std::size_t offset = (i - m_brickExtent[0]) + bw * ((j - m_brickExtent[2]) + bh * static_cast<std::size_t>(k - m_brickExtent[4]));
+
+	double value = 0.0;
+	dispatchStorable(v.m_scalarType, [&](auto* tag) {
+		using T = std::remove_pointer_t<decltype(tag)>;
+		value = static_cast<double>(reinterpret_cast<const T*>(m_brick->data())[offset]);
+	});
+	return value;
+}
+
+void CompressedVolume::decodeBrick(vtkIdType index, void* out, int extent[6]) const
+{
+	const int i = static_cast<int>(index);
+	brickExtent(i % m_bricks[0], (i / m_bricks[0]) % m_bricks[1], i / (m_bricks[0] * m_bricks[1]), extent);
+	decodeInto(i, static_cast<unsigned char*>(out));
+}
+
+int CompressedVolume::downsampleFactorFor(vtkIdType maxVoxels) const
+{
+	const vtkIdType n[3] = {
+		static_cast<vtkIdType>(m_extent[1]) - m_extent[0] + 1,
+		static_cast<vtkIdType>(m_extent[3]) - m_extent[2] + 1,
+		static_cast<vtkIdType>(m_extent[5]) - m_extent[4] + 1 };
+	int f = 1;
+	while (((n[0] - 1) / f + 1) * ((n[1] - 1) / f + 1) * ((n[2] - 1) / f + 1) > maxVoxels) ++f;
+	return f;
+}
+
+vtkSmartPointer<vtkImageData> CompressedVolume::decodeDownsampled(int factor) const
+{
+	const int f = std::max(factor, 1);
+	int outExt[6];
+	double spacing[3];
+	double origin[3];
+	for (int a = 0; a < 3; ++a) {
+		outExt[2 * a] = 0;
+		outExt[2 * a + 1] = (m_extent[2 * a + 1] - m_extent[2 * a]) / f;
+		spacing[a] = m_spacing[a] * f;
+		origin[a] = m_origin[a] + m_spacing[a] * m_extent[2 * a];
+	}
+
+	auto image = vtkSmartPointer<vtkImageData>::New();
+	image->SetExtent(outExt);
+	image->SetSpacing(spacing);
+	image->SetOrigin(origin);
+	// Filled brick by brick in parallel below
+	VolumeAllocator::allocateScalars(image, m_scalarType, 1, false);
+	if (!isComplete()) return image;
+
+	unsigned char* out = static_cast<unsigned char*>(image->GetScalarPointer());
+	const std::size_t nx = static_cast<std::size_t>(outExt[1] + 1);
+	const std::size_t ny = static_cast<std::size_t>(outExt[3] + 1);
+
+	// First voxel >= lo on the sampling grid of axis a
+	auto firstSample = [this, f](int a, int lo) {
+		const int rel = lo - m_extent[2 * a];
+		return m_extent[2 * a] + ((rel + f - 1) / f) * f;
+	};
+
+	const vtkIdType brickCount = static_cast<vtkIdType>(m_brickData.size());
+	vtkSMPTools::For(0, brickCount, [&](vtkIdType begin, vtkIdType end) {
+		std::vector<unsigned char> buffer(brickBytes());
+		for (vtkIdType n = begin; n < end; ++n) {
+			const int index = static_cast<int>(n);
+			const int bx = index % m_bricks[0];
+			const int by = (index / m_bricks[0]) % m_bricks[1];
+			const int bz = index / (m_bricks[0] * m_bricks[1]);
+			int be[6];
+			brickExtent(bx, by, bz, be);
+			const int x0 = firstSample(0, be[0]);
+			const int y0 = firstSample(1, be[2]);
+			const int z0 = firstSample(2, be[4]);
+			if (x0 > be[1] || y0 > be[3] || z0 > be[5]) continue;
+
+			decodeInto(index, buffer.data());
+			const std::size_t bw = static_cast<std::size_t>(be[1] - be[0] + 1);
+			const std::size_t bh = static_cast<std::size_t>(be[3] - be[2] + 1);
+			for (int z = z0; z <= be[5]; z += f) {
+				for (int y = y0; y <= be[3]; y += f) {
+					for (int x = x0; x <= be[1]; x += f) {
+						const std::size_t s = (x - be[0]) + bw * ((y - be[2]) + bh * static_cast<std::size_t>(z - be[4]));
+						const std::size_t d = static_cast<std::size_t>((x - m_extent[0]) / f) +
+							nx * (static_cast<std::size_t>((y - m_extent[2]) / f) + ny * static_cast<std::size_t>((z - m_extent[4]) / f));
+						std::memcpy(out + d * m_scalarSize, buffer.data() + s * m_scalarSize, m_scalarSize);
+					}
+				}
+			}
+		}
+	});
+	return image;
+}
+
+vtkIdType CompressedVolume::numberOfVoxels() const
+{
+	return VolumeIndex::voxelCount(m_extent);
+}
+
+unsigned long long CompressedVolume::uncompressedBytes() const
+{
+	return static_cast<unsigned long long>(numberOfVoxels()) * static_cast<unsigned long long>(m_scalarSize);
+}
+
+unsigned long long CompressedVolume::compressedBytes() const
+{
+	unsigned long long bytes = 0;
+	for (const Brick& brick : m_brickData) {
+		bytes += sizeof(Brick) + brick.words.capacity() * sizeof(std::uint64_t);
+	}
+	return bytes;
+}
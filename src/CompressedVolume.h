@@ -0,0 +1,128 @@
+#pragma once
+
+#include "SliceProvider.h"
+
+#include <vtkSmartPointer.h>
+#include <vtkType.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class vtkImageData;
+
+// In-memory compressed volume for scans larger than RAM.
+//
+// The volume is split into BrickSize^3 bricks. Each brick stores its minimum and the
+// offsets from it bit-packed at the smallest width that holds the brick's range, so
+// uniform air bricks cost a few bytes and 12-14 bit data in int16 costs 12-14 bits per
+// voxel. Bricks are decoded on demand into an LRU cache bounded by a byte budget.
+//
+// Only single-component integer scalars of up to 16 bits are supported, which covers
+// micro-CT (int16/uint16) and 8-bit data.
+class CompressedVolume : public SliceProvider
+{
+public:
+	static constexpr int BrickSize = 32;
+
+	static bool supportsScalarType(int scalarType);
+
+	// Compress a complete image; nullptr if the scalar type is not supported
+	static std::shared_ptr<CompressedVolume> fromImage(vtkImageData* image);
+
+	// Streaming construction: declare the geometry, then feed z-slabs in order with
+	// appendSlab(). Each slab must cover the full x/y extent and the next BrickSize
+	// slices (fewer for the last slab); it may cover more than that.
+	CompressedVolume(const int extent[6], const double spacing[3], const double origin[3], int scalarType);
+	bool appendSlab(vtkImageData* slab);
+	bool isComplete() const { return m_nextBrickZ >= m_bricks[2]; }
+
+	// SliceProvider
+	void getExtent(int extent[6]) const override;
+	void getSpacing(double spacing[3]) const override;
+	void getOrigin(double origin[3]) const override;
+	int scalarType() const override { return m_scalarType; }
+	bool extractSlice(int axis, int index, vtkImageData* slice) override;
+	double voxelValue(int i, int j, int k) override;
+
+	// Decoded-brick cache budget; 0 restores the default, defaultCacheBudgetBytes()
+	void setCacheBudgetBytes(std::size_t bytes);
+	std::size_t cacheBudgetBytes() const { return m_cacheBudget; }
+	// One brick layer per orientation plus one more of the largest (at least 256 MB): the
+	// linked views decode a layer each, and a view scrolling into the next layer keeps the
+	// current one, so no view re-decodes its bricks for each of the BrickSize slices in a layer
+	std::size_t defaultCacheBudgetBytes() const;
+
+	// Whole volume sampled at every `factor`-th voxel, decoded without touching the cache.
+	// Index 0 of the result is voxel extent[0|2|4] of the volume.
+	vtkSmartPointer<vtkImageData> decodeDownsampled(int factor) const;
+	// Smallest factor for which decodeDownsampled() stays within `maxVoxels`
+	int downsampleFactorFor(vtkIdType maxVoxels) const;
+
+	vtkIdType numberOfVoxels() const;
+	unsigned long long uncompressedBytes() const;
+	unsigned long long compressedBytes() const;
+
+	// Whole-volume passes (statistics, analysis tools) decode every brick once without
+	// going through the cache, so they neither pay its lock nor evict the views' bricks.
+	// Brick `index` is written to `out` (brickBytes() bytes, x fastest, native type) and
+	// `extent` receives the voxels it covers; edge bricks fill only the front of `out`.
+	vtkIdType numberOfBricks() const { return static_cast<vtkIdType>(m_brickData.size()); }
+	void decodeBrick(vtkIdType index, void* out, int extent[6]) const;
+	std::size_t brickBytes() const { return static_cast<std::size_t>(BrickSize) * BrickSize * BrickSize * m_scalarSize; }
+
+	// Voxel reads for one thread through the cache. The last brick stays pinned, so runs
+	// of nearby reads (a sampled line, an interpolation neighbourhood) take the cache lock
+	// once per brick instead of once per voxel.
+	class Reader
+	{
+	public:
+		explicit Reader(CompressedVolume& volume) : m_volume(volume) {}
+		// Voxel (i, j, k), which must lie inside the extent
+		double value(int i, int j, int k);
+
+	private:
+		CompressedVolume& m_volume;
+		int m_brickExtent[6] = { 0, -1, 0, -1, 0, -1 };
+		std::shared_ptr<const std::vector<unsigned char>> m_brick;
+	};
+
+private:
+	struct Brick
+	{
+		std::int32_t base = 0;     // minimum value in the brick
+		std::uint8_t bits = 0;     // bits per packed offset (0 = uniform brick)
+		std::vector<std::uint64_t> words;
+	};
+
+	using Decoded = std::shared_ptr<const std::vector<unsigned char>>;
+
+	int brickIndex(int bx, int by, int bz) const { return bx + m_bricks[0] * (by + m_bricks[1] * bz); }
+	// Voxel extent covered by a brick (inclusive)
+	void brickExtent(int bx, int by, int bz, int ext[6]) const;
+
+	// Decoded brick (voxels in x-fastest order, native scalar type), via the LRU cache
+	Decoded decodedBrick(int index);
+	void decodeInto(int index, unsigned char* out) const;
+
+	int m_extent[6];
+	double m_spacing[3];
+	double m_origin[3];
+	int m_scalarType;
+	int m_scalarSize;
+	int m_bricks[3];
+	int m_nextBrickZ = 0;
+
+	std::vector<Brick> m_brickData;
+
+	// LRU cache of decoded bricks
+	mutable std::mutex m_cacheMutex;
+	std::size_t m_cacheBudget = 0;
+	std::size_t m_cacheBytes = 0;
+	std::list<int> m_lru;  // most recently used first
+	std::unordered_map<int, std::pair<std::list<int>::iterator, Decoded>> m_cache;
+};
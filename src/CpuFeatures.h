@@ -0,0 +1,49 @@
+#pragma once
+
+// Runtime CPU feature checks for kernels built for instruction sets above the build
+// baseline.
+//
+// The application is compiled for plain x86-64. SIMD kernels mark their AVX2 functions
+// with CTANALYZERX_TARGET_AVX2, so only those functions may use AVX2 instructions, and
+// call them only when CpuFeatures::hasAvx2() is true. Everything else, including inlined
+// Qt and VTK code, stays baseline, so the binary runs on CPUs without AVX2.
+#if defined(__x86_64__) || defined(_M_X64)
+#define CTANALYZERX_X86_64 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC accepts AVX2 intrinsics in any function
+#define CTANALYZERX_TARGET_AVX2
+#else
+#define CTANALYZERX_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace CpuFeatures
+{
+	// True when both the CPU and the OS (saved YMM state) support AVX2; checked once
+	inline bool hasAvx2()
+	{
+#if defined(CTANALYZERX_X86_64) && defined(_MSC_VER) && !defined(__clang__)
+		static const bool supported = [] {
+			int info[4];
+			__cpuid(info, 1);
+			const bool osxsave = (info[2] & (1 << 27)) != 0;
+			const bool avx = (info[2] & (1 << 28)) != 0;
+			if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+		}();
+		return supported;
+#elif defined(CTANALYZERX_X86_64)
+		// libgcc / compiler-rt also check that the OS saves the YMM registers
+		static const bool supported = [] {
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2") != 0;
+		}();
+		return supported;
+#else
+		return false;
+#endif
+	}
+}
@@ -0,0 +1,25 @@
+#include "CursorModel.h"
+
+CursorModel::CursorModel(QObject* parent)
+	: QObject(parent)
+{
+}
+
+void CursorModel::setPosition(int x, int y, int z)
+{
+	const int p[3] = { x, y, z };
+	int changed = 0;
+	for (int a = 0; a < 3; ++a) {
+		if (m_position[a] == p[a]) continue;
+		m_position[a] = p[a];
+		changed |= 1 << a;
+	}
+	if (changed) emit positionChanged(m_position[0], m_position[1], m_position[2], changed);
+}
+
+void CursorModel::setAxis(int axis, int index)
+{
+	if (axis < 0 || axis > 2 || m_position[axis] == index) return;
+	m_position[axis] = index;
+	emit positionChanged(m_position[0], m_position[1], m_position[2], 1 << axis);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QObject>
+
+// Shared 3D cursor of a lightbox: one voxel position in slice-view (full-resolution)
+// indices.
+//
+// Views write the axes they control and react only to the axes that changed:
+// positionChanged() carries a bit mask (bit a = axis a), and setting an axis to its
+// current value emits nothing, so echoes from the views end the update cycle.
+class CursorModel : public QObject
+{
+	Q_OBJECT
+public:
+	explicit CursorModel(QObject* parent = nullptr);
+
+	void setPosition(int x, int y, int z);
+	void setAxis(int axis, int index);
+
+	int index(int axis) const { return m_position[axis]; }
+	const int* position() const { return m_position; }
+
+signals:
+	void positionChanged(int x, int y, int z, int changedAxes);
+
+private:
+	int m_position[3] = { 0, 0, 0 };
+};
@@ -0,0 +1,330 @@
+#include "CurvedReformat.h"
+#include "CompressedVolume.h"
+#include "VolumeKernels.h"
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace {
+	// Chords per segment in the arc-length table
+	constexpr int kArcSamples = 32;
+
+	using Point = CurvedReformat::Point;
+
+	// Catmull-Rom position and derivative at t in [0, 1] of the segment from b to c
+	void evaluate(const Point& a, const Point& b, const Point& c, const Point& d, double t, double position[3],
+		double derivative[3])
+	{
+		const double t2 = t * t;
+		for (int i = 0; i < 3; ++i) {
+			const double c1 = c[i] - a[i];
+			const double c2 = 2.0 * a[i] - 5.0 * b[i] + 4.0 * c[i] - d[i];
+			const double c3 = -a[i] + 3.0 * b[i] - 3.0 * c[i] + d[i];
+			position[i] = b[i] + 0.5 * (c1 * t + c2 * t2 + c3 * t2 * t);
+			derivative[i] = 0.5 * (c1 + 2.0 * c2 * t + 3.0 * c3 * t2);
+		}
+	}
+
+	// One image column: the curve point and the unit direction its rows run along
+	struct Column
+	{
+		int segment;
+		int column;
+		double position[3];
+		double across[3];
+	};
+
+	// Trilinear sample at a continuous index relative to the extent's first voxel;
+	// at(x, y, z) reads the voxel at a relative index
+	template <typename At>
+	float trilinear(At&& at, const int size[3], const double index[3], float background)
+	{
+		int i0[3];
+		int i1[3];
+		double f[3];
+		for (int a = 0; a < 3; ++a) {
+			// Half a voxel of tolerance so samples on the boundary faces are kept
+			if (!(index[a] >= -0.5 && index[a] <= size[a] - 0.5)) return background;
+			const double x = std::clamp(index[a], 0.0, static_cast<double>(size[a] - 1));
+			i0[a] = std::min(static_cast<int>(x), std::max(size[a] - 2, 0));
+			i1[a] = std::min(i0[a] + 1, size[a] - 1);
+			f[a] = x - i0[a];
+		}
+		const double c00 = at(i0[0], i0[1], i0[2]) + f[0] * (at(i1[0], i0[1], i0[2]) - at(i0[0], i0[1], i0[2]));
+		const double c10 = at(i0[0], i1[1], i0[2]) + f[0] * (at(i1[0], i1[1], i0[2]) - at(i0[0], i1[1], i0[2]));
+		const double c01 = at(i0[0], i0[1], i1[2]) + f[0] * (at(i1[0], i0[1], i1[2]) - at(i0[0], i0[1], i1[2]));
+		const double c11 = at(i0[0], i1[1], i1[2]) + f[0] * (at(i1[0], i1[1], i1[2]) - at(i0[0], i1[1], i1[2]));
+		const double c0 = c00 + f[1] * (c10 - c00);
+		const double c1 = c01 + f[1] * (c11 - c01);
+		return static_cast<float>(c0 + f[2] * (c1 - c0));
+	}
+}
+
+CurvedReformat::CurvedReformat(vtkImageData* volume)
+	: m_volume(volume)
+{
+	if (!m_volume) return;
+	m_volume->GetOrigin(m_origin);
+	m_volume->GetSpacing(m_spacing);
+	m_volume->GetExtent(m_extent);
+	m_step = std::min({ std::fabs(m_spacing[0]), std::fabs(m_spacing[1]), std::fabs(m_spacing[2]) });
+	if (!(m_step > 0.0)) m_step = 1.0;
+}
+
+CurvedReformat::CurvedReformat(std::shared_ptr<CompressedVolume> volume)
+	: m_compressed(std::move(volume))
+{
+	if (!m_compressed) return;
+	m_compressed->getOrigin(m_origin);
+	m_compressed->getSpacing(m_spacing);
+	m_compressed->getExtent(m_extent);
+	m_step = std::min({ std::fabs(m_spacing[0]), std::fabs(m_spacing[1]), std::fabs(m_spacing[2]) });
+	if (!(m_step > 0.0)) m_step = 1.0;
+}
+
+CurvedReformat::~CurvedReformat() = default;
+
+void CurvedReformat::setReferenceAxis(int axis)
+{
+	if (axis < 0 || axis > 2 || axis == m_axis) return;
+	m_axis = axis;
+	for (Segment& segment : m_segments) segment.dirty = true;
+}
+
+void CurvedReformat::setHalfWidth(double halfWidth)
+{
+	halfWidth = std::max(halfWidth, 0.0);
+	if (halfWidth == m_halfWidth) return;
+	m_halfWidth = halfWidth;
+	for (Segment& segment : m_segments) segment.dirty = true;
+}
+
+double CurvedReformat::halfWidth() const
+{
+	if (m_halfWidth > 0.0) return m_halfWidth;
+	const double size = std::fabs(m_spacing[m_axis]) * (m_extent[2 * m_axis + 1] - m_extent[2 * m_axis]);
+	return std::max(0.5 * size, m_step);
+}
+
+void CurvedReformat::setBackground(double value)
+{
+	if (value == m_background) return;
+	m_background = value;
+	for (Segment& segment : m_segments) segment.dirty = true;
+}
+
+int CurvedReformat::rows() const
+{
+	return 2 * static_cast<int>(std::lround(halfWidth() / m_step)) + 1;
+}
+
+void CurvedReformat::markAround(int point)
+{
+	// Segment k runs from point k to k + 1 and is shaped by points k - 1 to k + 2
+	const int last = static_cast<int>(m_segments.size()) - 1;
+	for (int k = std::max(point - 2, 0); k <= std::min(point + 1, last); ++k) m_segments[k].dirty = true;
+}
+
+void CurvedReformat::setPoints(const std::vector<Point>& points)
+{
+	const std::size_t segments = points.size() >= 2 ? points.size() - 1 : 0;
+	if (points.size() == m_points.size()) {
+		for (std::size_t i = 0; i < points.size(); ++i) {
+			if (points[i] != m_points[i]) markAround(static_cast<int>(i));
+		}
+	}
+	else {
+		// Points added or removed: everything after the common prefix may change
+		std::size_t first = 0;
+		while (first < std::min(points.size(), m_points.size()) && points[first] == m_points[first]) ++first;
+		m_segments.resize(segments);
+		for (std::size_t k = first >= 2 ? first - 2 : 0; k < segments; ++k) m_segments[k].dirty = true;
+	}
+	m_points = points;
+}
+
+std::vector<CurvedReformat::Point> CurvedReformat::sampleCurve(const std::vector<Point>& points, int perSegment)
+{
+	if (points.size() < 2) return points;
+	perSegment = std::max(perSegment, 1);
+	const int count = static_cast<int>(points.size());
+	std::vector<Point> curve;
+	curve.reserve(static_cast<std::size_t>(count - 1) * perSegment + 1);
+	for (int k = 0; k + 1 < count; ++k) {
+		const Point& a = points[std::max(k - 1, 0)];
+		const Point& d = points[std::min(k + 2, count - 1)];
+		for (int i = 0; i < perSegment; ++i) {
+			Point p;
+			double derivative[3];
+			evaluate(a, points[k], points[k + 1], d, static_cast<double>(i) / perSegment, p.data(), derivative);
+			curve.push_back(p);
+		}
+	}
+	curve.push_back(points.back());
+	return curve;
+}
+
+void CurvedReformat::resampleDirty()
+{
+	if (!m_volume && !m_compressed) return;
+	const int rowCount = rows();
+	const float background = static_cast<float>(m_background);
+	const int last = static_cast<int>(m_segments.size()) - 1;
+	const int count = static_cast<int>(m_points.size());
+
+	auto world = [this](const Point& index) {
+		Point p;
+		for (int a = 0; a < 3; ++a) p[a] = m_origin[a] + m_spacing[a] * index[a];
+		return p;
+	};
+
+	// Lay out the columns of every dirty segment first; resampling their rows is the expensive part
+	std::vector<Column> columns;
+	for (int k = 0; k <= last; ++k) {
+		Segment& segment = m_segments[k];
+		if (!segment.dirty) continue;
+		segment.dirty = false;
+
+		const Point a = world(m_points[std::max(k - 1, 0)]);
+		const Point b = world(m_points[k]);
+		const Point c = world(m_points[k + 1]);
+		const Point d = world(m_points[std::min(k + 2, count - 1)]);
+
+		double arc[kArcSamples + 1];
+		double previous[3];
+		double derivative[3];
+		evaluate(a, b, c, d, 0.0, previous, derivative);
+		arc[0] = 0.0;
+		for (int i = 1; i <= kArcSamples; ++i) {
+			double p[3];
+			evaluate(a, b, c, d, static_cast<double>(i) / kArcSamples, p, derivative);
+			arc[i] = arc[i - 1] + std::sqrt(vtkMath::Distance2BetweenPoints(previous, p));
+			std::copy(p, p + 3, previous);
+		}
+		const double length = arc[kArcSamples];
+
+		// Columns at whole steps from the segment start; the last segment also ends the path
+		int columnCount = length > 0.0 ? static_cast<int>(std::ceil(length / m_step - 1e-9)) : 0;
+		if (k == last && length > 0.0) ++columnCount;
+		segment.columns = columnCount;
+		segment.pixels.assign(static_cast<std::size_t>(rowCount) * columnCount, background);
+
+		int interval = 0;
+		for (int j = 0; j < columnCount; ++j) {
+			const double s = std::min(j * m_step, length);
+			while (interval < kArcSamples - 1 && arc[interval + 1] < s) ++interval;
+			const double chord = arc[interval + 1] - arc[interval];
+			const double t = (interval + (chord > 0.0 ? (s - arc[interval]) / chord : 0.0)) / kArcSamples;
+
+			Column column;
+			column.segment = k;
+			column.column = j;
+			double tangent[3];
+			evaluate(a, b, c, d, t, column.position, tangent);
+			if (vtkMath::Normalize(tangent) == 0.0) {
+				for (int i = 0; i < 3; ++i) tangent[i] = c[i] - b[i];
+				vtkMath::Normalize(tangent);
+			}
+
+			// The reference axis without its component along the tangent; a tangent along
+			// the axis itself falls back to the next axis
+			for (int attempt = 0; attempt < 2; ++attempt) {
+				double reference[3] = { 0.0, 0.0, 0.0 };
+				reference[(m_axis + attempt) % 3] = 1.0;
+				const double along = vtkMath::Dot(reference, tangent);
+				for (int i = 0; i < 3; ++i) column.across[i] = reference[i] - along * tangent[i];
+				if (vtkMath::Normalize(column.across) > 1e-6) break;
+			}
+			columns.push_back(column);
+		}
+	}
+	if (columns.empty()) return;
+
+	const int size[3] = { m_extent[1] - m_extent[0] + 1, m_extent[3] - m_extent[2] + 1, m_extent[5] - m_extent[4] + 1 };
+	const double center = 0.5 * (rowCount - 1);
+
+	// Fill the columns [begin, end) with samples read through at(x, y, z)
+	auto resampleColumns = [&](auto&& at, vtkIdType begin, vtkIdType end) {
+		for (vtkIdType c = begin; c < end; ++c) {
+			const Column& column = columns[c];
+			Segment& segment = m_segments[column.segment];
+			float* out = segment.pixels.data() + column.column;
+			for (int r = 0; r < rowCount; ++r) {
+				const double offset = (r - center) * m_step;
+				double index[3];
+				for (int a = 0; a < 3; ++a) {
+					index[a] = (column.position[a] + offset * column.across[a] - m_origin[a]) / m_spacing[a] - m_extent[2 * a];
+				}
+				out[static_cast<std::size_t>(r) * segment.columns] = trilinear(at, size, index, background);
+			}
+		}
+	};
+
+	if (m_compressed) {
+		// Consecutive samples of a row mostly fall in the brick the reader holds
+		vtkSMPTools::For(0, static_cast<vtkIdType>(columns.size()), [&](vtkIdType begin, vtkIdType end) {
+			CompressedVolume::Reader reader(*m_compressed);
+			resampleColumns([&](int x, int y, int z) {
+				return reader.value(x + m_extent[0], y + m_extent[2], z + m_extent[4]);
+			}, begin, end);
+		});
+		return;
+	}
+
+	vtkDataArray* scalars = m_volume->GetPointData()->GetScalars();
+	if (!scalars) return;
+	vtkIdType inc[3];
+	m_volume->GetIncrements(inc);
+
+	// Unknown scalar types keep the background
+	VolumeKernels::dispatch(scalars->GetDataType(), [&](auto tag) {
+		using T = VolumeKernels::ValueType<decltype(tag)>;
+		const T* data = static_cast<const T*>(scalars->GetVoidPointer(0));
+		vtkSMPTools::For(0, static_cast<vtkIdType>(columns.size()), [&](vtkIdType begin, vtkIdType end) {
+			resampleColumns([data, &inc](int x, int y, int z) {
+				return static_cast<double>(data[x * inc[0] + y * inc[1] + z * inc[2]]);
+			}, begin, end);
+		});
+	});
+}
+
+vtkImageData* CurvedReformat::update()
+{
+	resampleDirty();
+
+	int width = 0;
+	for (const Segment& segment : m_segments) width += segment.columns;
+	if ((!m_volume && !m_compressed) || width == 0) return nullptr;
+
+	const int rowCount = rows();
+	if (!m_image) m_image = vtkSmartPointer<vtkImageData>::New();
+	const int extent[6] = { 0, width - 1, 0, rowCount - 1, 0, 0 };
+	if (!std::equal(extent, extent + 6, m_image->GetExtent()) || !m_image->GetPointData()->GetScalars()) {
+		m_image->SetExtent(const_cast<int*>(extent));
+		m_image->AllocateScalars(VTK_FLOAT, 1);
+	}
+	m_image->SetSpacing(m_step, m_step, 1.0);
+	m_image->SetOrigin(0.0, 0.0, 0.0);
+
+	// Blocks side by side: one row of each segment at a time
+	float* out = static_cast<float*>(m_image->GetScalarPointer());
+	int x = 0;
+	for (const Segment& segment : m_segments) {
+		if (segment.columns == 0) continue;
+		for (int r = 0; r < rowCount; ++r) {
+			std::memcpy(out + static_cast<std::size_t>(r) * width + x,
+				segment.pixels.data() + static_cast<std::size_t>(r) * segment.columns, segment.columns * sizeof(float));
+		}
+		x += segment.columns;
+	}
+	m_image->Modified();
+	return m_image;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vtkSmartPointer.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+class CompressedVolume;
+class vtkImageData;
+
+// Curved planar reformation: the volume straightened along a path.
+//
+// The path is a Catmull-Rom spline through control points given in continuous voxel
+// indices. Each image column is one step of arc length along the curve (the step
+// restarts at every control point); its rows sample the line through the curve point
+// that is perpendicular to the tangent and lies in the plane of the tangent and the
+// reference axis. A path drawn in axial slices with z as reference gives the usual
+// panoramic image, with z running up the rows.
+//
+// Columns are cached per spline segment. A segment depends on four control points, so
+// moving one point resamples at most four segments and the image is reassembled from
+// the cached blocks. Rows are resampled trilinearly from native scalars on vtkSMPTools,
+// either from an image or through the brick cache of a compressed volume.
+class CurvedReformat
+{
+public:
+	using Point = std::array<double, 3>;
+
+	// `volume` is sampled in place and must outlive the reformat
+	explicit CurvedReformat(vtkImageData* volume);
+	explicit CurvedReformat(std::shared_ptr<CompressedVolume> volume);
+	~CurvedReformat();
+
+	CurvedReformat(const CurvedReformat&) = delete;
+	CurvedReformat& operator=(const CurvedReformat&) = delete;
+
+	// Axis (0 = x, 1 = y, 2 = z) the rows lean towards
+	void setReferenceAxis(int axis);
+	int referenceAxis() const { return m_axis; }
+	// Rows reach this far (world units) to either side of the curve; 0 = half the
+	// volume's size along the reference axis
+	void setHalfWidth(double halfWidth);
+	double halfWidth() const;
+	// Value of samples outside the volume
+	void setBackground(double value);
+
+	// Only segments near points that differ from the current path are resampled
+	void setPoints(const std::vector<Point>& points);
+	const std::vector<Point>& points() const { return m_points; }
+
+	// Float image with x along the path and y across it, spacing = step; nullptr with
+	// fewer than two distinct points. Owned by the reformat and refilled by every call.
+	vtkImageData* update();
+	// Distance between columns and rows (the smallest voxel spacing)
+	double step() const { return m_step; }
+
+	// The spline through `points` as a polyline with `perSegment` chords per segment
+	// (for drawing the path; the spline is the same in index and world coordinates)
+	static std::vector<Point> sampleCurve(const std::vector<Point>& points, int perSegment);
+
+private:
+	struct Segment
+	{
+		std::vector<float> pixels; // rows x columns, row-major
+		int columns = 0;
+		bool dirty = true;
+	};
+
+	int rows() const;
+	void markAround(int point);
+	void resampleDirty();
+
+	// One of the two is set
+	vtkSmartPointer<vtkImageData> m_volume;
+	std::shared_ptr<CompressedVolume> m_compressed;
+	vtkSmartPointer<vtkImageData> m_image;
+	double m_origin[3] = { 0.0, 0.0, 0.0 };
+	double m_spacing[3] = { 1.0, 1.0, 1.0 };
+	int m_extent[6] = { 0, -1, 0, -1, 0, -1 };
+	double m_step = 1.0;
+
+	int m_axis = 2;
+	double m_halfWidth = 0.0;
+	double m_background = 0.0;
+
+	std::vector<Point> m_points;
+	std::vector<Segment> m_segments;
+};
@@ -0,0 +1,297 @@
+#include "CurvedReformatView.h"
+#include "MenuButton.h"
+
+#include <QCloseEvent>
+#include <QInputDialog>
+#include <QVTKOpenGLNativeWidget.h>
+
+#include <vtkCamera.h>
+#include <vtkCommand.h>
+#include <vtkEventQtSlotConnect.h>
+#include <vtkGenericOpenGLRenderWindow.h>
+#include <vtkImageData.h>
+#include <vtkImageProperty.h>
+#include <vtkImageSlice.h>
+#include <vtkImageSliceMapper.h>
+#include <vtkInteractorStyleImage.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkRenderer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+	// The reformatted image is float; any positive window is usable
+	constexpr double kMinimumWindow = 1e-6;
+}
+
+CurvedReformatView::CurvedReformatView(QWidget* parent)
+	: ImageFrameWidget(parent)
+{
+	m_renderArea = new QVTKOpenGLNativeWidget(this);
+	setSceneContent(m_renderArea);
+	m_renderArea->setRenderWindow(m_renderWindow);
+	m_renderArea->setFocusPolicy(Qt::StrongFocus);
+	setFocusProxy(m_renderArea);
+
+	createMenuAndActions();
+
+	if (auto* cam = m_renderer->GetActiveCamera()) {
+		cam->ParallelProjectionOn();
+	}
+	// Image axes are path and offset, not x, y, z
+	setOrientationMarkerVisible(false);
+
+	m_property = vtkSmartPointer<vtkImageProperty>::New();
+	m_property->SetInterpolationTypeToLinear();
+
+	m_mapper = vtkSmartPointer<vtkImageSliceMapper>::New();
+	m_mapper->SetOrientationToZ();
+	m_mapper->SliceFacesCameraOff();
+	m_mapper->SliceAtFocalPointOff();
+	m_slice = vtkSmartPointer<vtkImageSlice>::New();
+	m_slice->SetMapper(m_mapper);
+	m_slice->SetProperty(m_property);
+	m_slice->VisibilityOff();
+	m_renderer->AddViewProp(m_slice);
+
+	m_connections = vtkSmartPointer<vtkEventQtSlotConnect>::New();
+	if (auto* iren = m_renderWindow->GetInteractor()) {
+		m_style = vtkSmartPointer<vtkInteractorStyleImage>::New();
+		m_style->SetInteractionModeToImage2D();
+		m_style->SetDefaultRenderer(m_renderer);
+		m_style->AutoAdjustCameraClippingRangeOn();
+		m_style->SetHandleObservers(true);
+		iren->SetInteractorStyle(m_style);
+
+		m_connections->Connect(m_style, vtkCommand::StartWindowLevelEvent,
+			this, SLOT(onInteractorStartWindowLevel(vtkObject*)), nullptr, -1.0f);
+		m_connections->Connect(m_style, vtkCommand::WindowLevelEvent,
+			this, SLOT(onInteractorWindowLevel(vtkObject*)), nullptr, -1.0f);
+		m_connections->Connect(m_style, vtkCommand::EndWindowLevelEvent,
+			this, SLOT(onInteractorEndWindowLevel(vtkObject*)), nullptr, -1.0f);
+		m_connections->Connect(m_style, vtkCommand::ResetWindowLevelEvent,
+			this, SLOT(onResetWindowLevel(vtkObject*)));
+	}
+
+	setTitle(tr("Curved MPR"));
+}
+
+CurvedReformatView::~CurvedReformatView() = default;
+
+void CurvedReformatView::createMenuAndActions()
+{
+	setSelectionList({
+		QStringLiteral("Across X"),
+		QStringLiteral("Across Y"),
+		QStringLiteral("Across Z"),
+		QStringLiteral("--"),
+		QStringLiteral("Half Width..."),
+		QStringLiteral("Reset Camera")
+	});
+
+	if (auto* mb = menuButton()) {
+		connect(mb, &MenuButton::itemSelected, this, [this](const QString& item) {
+			if (item == QLatin1String("Across X")) {
+				setReferenceAxis(0);
+			}
+			else if (item == QLatin1String("Across Y")) {
+				setReferenceAxis(1);
+			}
+			else if (item == QLatin1String("Across Z")) {
+				setReferenceAxis(2);
+			}
+			else if (item == QLatin1String("Half Width...")) {
+				bool ok = false;
+				const double halfWidth = QInputDialog::getDouble(this, tr("Curved MPR"),
+					tr("Half width (world units, 0 = automatic):"), m_halfWidth, 0.0, 1e6, 2, &ok);
+				if (ok) setHalfWidth(halfWidth);
+			}
+			else if (item == QLatin1String("Reset Camera")) {
+				resetCamera();
+			}
+			setTitle(tr("Curved MPR"));
+		});
+	}
+}
+
+void CurvedReformatView::setVolume(vtkImageData* volume, double background)
+{
+	setReformat(volume ? std::make_unique<CurvedReformat>(volume) : nullptr, background);
+}
+
+void CurvedReformatView::setVolume(std::shared_ptr<CompressedVolume> volume, double background)
+{
+	setReformat(volume ? std::make_unique<CurvedReformat>(std::move(volume)) : nullptr, background);
+}
+
+void CurvedReformatView::setReformat(std::unique_ptr<CurvedReformat> reformat, double background)
+{
+	m_background = background;
+	m_reformat = std::move(reformat);
+	if (m_reformat) {
+		m_reformat->setReferenceAxis(m_referenceAxis);
+		m_reformat->setHalfWidth(m_halfWidth);
+		m_reformat->setBackground(m_background);
+	}
+	m_shown = false;
+	m_slice->VisibilityOff();
+	render();
+}
+
+void CurvedReformatView::setPath(const std::vector<CurvedReformat::Point>& points)
+{
+	if (!m_reformat) return;
+	m_reformat->setPoints(points);
+	refresh();
+}
+
+void CurvedReformatView::setReferenceAxis(int axis)
+{
+	if (axis < 0 || axis > 2 || axis == m_referenceAxis) return;
+	m_referenceAxis = axis;
+	if (!m_reformat) return;
+	m_reformat->setReferenceAxis(axis);
+	// Another image altogether
+	m_shown = false;
+	refresh();
+}
+
+void CurvedReformatView::setHalfWidth(double halfWidth)
+{
+	halfWidth = std::max(halfWidth, 0.0);
+	if (halfWidth == m_halfWidth) return;
+	m_halfWidth = halfWidth;
+	if (!m_reformat) return;
+	m_reformat->setHalfWidth(halfWidth);
+	m_shown = false;
+	refresh();
+}
+
+void CurvedReformatView::refresh()
+{
+	vtkImageData* image = m_reformat ? m_reformat->update() : nullptr;
+	if (!image) {
+		m_shown = false;
+		m_slice->VisibilityOff();
+		render();
+		return;
+	}
+
+	// The reformat refills the same image object; the mapper only sees it modified
+	if (m_mapper->GetInput() != image) m_mapper->SetInputData(image);
+	m_mapper->SetSliceNumber(0);
+	m_slice->VisibilityOn();
+	if (!m_shown) fitCamera();
+	m_shown = true;
+	m_renderer->ResetCameraClippingRange();
+	render();
+}
+
+void CurvedReformatView::setInterpolation(Interpolation newInterpolation)
+{
+	if (newInterpolation == m_interpolation) return;
+	m_interpolation = newInterpolation;
+	switch (m_interpolation) {
+		case Nearest: m_property->SetInterpolationTypeToNearest(); break;
+		case Linear:  m_property->SetInterpolationTypeToLinear(); break;
+		case Cubic:   m_property->SetInterpolationTypeToCubic(); break;
+	}
+	render();
+	emit interpolationChanged(m_interpolation);
+}
+
+void CurvedReformatView::resetCamera()
+{
+	fitCamera();
+	render();
+}
+
+void CurvedReformatView::closeEvent(QCloseEvent* event)
+{
+	ImageFrameWidget::closeEvent(event);
+	emit closed();
+}
+
+void CurvedReformatView::fitCamera()
+{
+	// Path along screen x, rows up
+	auto* camera = m_renderer->GetActiveCamera();
+	camera->ParallelProjectionOn();
+	camera->SetFocalPoint(0.0, 0.0, 0.0);
+	camera->SetPosition(0.0, 0.0, 1.0);
+	camera->SetViewUp(0.0, 1.0, 0.0);
+	m_renderer->ResetCamera();
+	m_renderer->ResetCameraClippingRange();
+}
+
+void CurvedReformatView::setWindowLevelNative(double window, double level)
+{
+	m_property->SetColorWindow(std::max(std::fabs(window), kMinimumWindow));
+	m_property->SetColorLevel(level);
+	render();
+}
+
+void CurvedReformatView::resetWindowLevel()
+{
+	if (!std::isfinite(m_baselineWindowNative) || !std::isfinite(m_baselineLevelNative)) return;
+	setWindowLevelNative(m_baselineWindowNative, m_baselineLevelNative);
+	emit windowLevelChanged(m_baselineWindowNative, m_baselineLevelNative);
+}
+
+std::pair<double, double> CurvedReformatView::nativeWindowLevel() const
+{
+	return { std::max(std::fabs(m_property->GetColorWindow()), kMinimumWindow), m_property->GetColorLevel() };
+}
+
+void CurvedReformatView::onInteractorStartWindowLevel(vtkObject* /*caller*/)
+{
+	m_windowLevelInitial[0] = m_property->GetColorWindow();
+	m_windowLevelInitial[1] = m_property->GetColorLevel();
+}
+
+void CurvedReformatView::onInteractorWindowLevel(vtkObject* caller)
+{
+	auto* style = vtkInteractorStyleImage::SafeDownCast(caller);
+	if (!style || !m_shown) return;
+
+	int size[2] = { 1, 1 };
+	if (const int* s = m_renderWindow->GetSize()) {
+		size[0] = std::max(s[0], 1);
+		size[1] = std::max(s[1], 1);
+	}
+
+	// vtkInteractorStyleImage's mapping, as in MosaicView
+	const int* start = style->GetWindowLevelStartPosition();
+	const int* current = style->GetWindowLevelCurrentPosition();
+	const double window = m_windowLevelInitial[0];
+	const double level = m_windowLevelInitial[1];
+	const double eps = 0.01;
+
+	double dx = (current[0] - start[0]) * 4.0 / size[0];
+	double dy = (start[1] - current[1]) * 4.0 / size[1];
+	dx *= std::fabs(window) > eps ? window : (window < 0 ? -eps : eps);
+	dy *= std::fabs(level) > eps ? level : (level < 0 ? -eps : eps);
+	if (window < 0.0) dx = -dx;
+	if (level < 0.0) dy = -dy;
+
+	m_property->SetColorWindow(std::max(window + dx, kMinimumWindow));
+	m_property->SetColorLevel(level - dy);
+	render();
+
+	const auto [nativeWindow, nativeLevel] = nativeWindowLevel();
+	emit windowLevelChanged(nativeWindow, nativeLevel);
+}
+
+void CurvedReformatView::onInteractorEndWindowLevel(vtkObject* /*caller*/)
+{
+	if (!m_shown) return;
+	const auto [nativeWindow, nativeLevel] = nativeWindowLevel();
+	emit windowLevelChanged(nativeWindow, nativeLevel);
+}
+
+void CurvedReformatView::onResetWindowLevel(vtkObject* /*caller*/)
+{
+	resetWindowLevel();
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "ImageFrameWidget.h"
+#include "CurvedReformat.h"
+
+#include <vtkSmartPointer.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+class QCloseEvent;
+class QVTKOpenGLNativeWidget;
+class vtkEventQtSlotConnect;
+class vtkImageProperty;
+class vtkImageSlice;
+class vtkImageSliceMapper;
+class vtkInteractorStyleImage;
+class vtkObject;
+
+// Straightened (curved planar) reformation of a volume along a path, see CurvedReformat.
+//
+// The reformatted image holds native scalars, so window/level is set in the native domain
+// whatever the display mode of the other views. Path edits go through setPath(); only the
+// spline segments around changed points are resampled, and the camera stays put unless
+// the image was empty before.
+class CurvedReformatView : public ImageFrameWidget
+{
+	Q_OBJECT
+
+public:
+	explicit CurvedReformatView(QWidget* parent = nullptr);
+	~CurvedReformatView() override;
+
+	// Full-resolution native volume and the value shown outside it; clears the path
+	void setVolume(vtkImageData* volume, double background);
+	// Same for a compressed volume, sampled through its brick cache
+	void setVolume(std::shared_ptr<CompressedVolume> volume, double background);
+	// Control points in continuous voxel indices of the volume
+	void setPath(const std::vector<CurvedReformat::Point>& points);
+
+	// Axis the rows lean towards (usually the normal of the slices the path is drawn in)
+	void setReferenceAxis(int axis);
+	int referenceAxis() const { return m_referenceAxis; }
+	// Rows to either side of the path, in world units (0 = half the volume along the reference axis)
+	void setHalfWidth(double halfWidth);
+
+	void setInterpolation(Interpolation newInterpolation) override;
+	void setWindowLevelNative(double window, double level);
+	void setColorWindowLevel(double window, double level) override { setWindowLevelNative(window, level); }
+	void resetWindowLevel() override;
+
+signals:
+	// The window was closed (when shown as a top-level window)
+	void closed();
+
+protected:
+	void resetCamera() override;
+	void closeEvent(QCloseEvent* event) override;
+
+private slots:
+	void onInteractorStartWindowLevel(vtkObject* caller);
+	void onInteractorWindowLevel(vtkObject* caller);
+	void onInteractorEndWindowLevel(vtkObject* caller);
+	void onResetWindowLevel(vtkObject* caller);
+
+private:
+	void createMenuAndActions();
+	// Show `reformat` (null: nothing) with the view's axis, width and background
+	void setReformat(std::unique_ptr<CurvedReformat> reformat, double background);
+	// Resample what changed and show it
+	void refresh();
+	void fitCamera();
+	std::pair<double, double> nativeWindowLevel() const;
+
+	QVTKOpenGLNativeWidget* m_renderArea = nullptr;
+	vtkSmartPointer<vtkInteractorStyleImage> m_style;
+	vtkSmartPointer<vtkImageSliceMapper> m_mapper;
+	vtkSmartPointer<vtkImageSlice> m_slice;
+	vtkSmartPointer<vtkImageProperty> m_property;
+	vtkSmartPointer<vtkEventQtSlotConnect> m_connections;
+	double m_windowLevelInitial[2] = { 1.0, 0.5 }; // window/level at drag start
+
+	std::unique_ptr<CurvedReformat> m_reformat;
+	double m_background = 0.0;
+	int m_referenceAxis = 2;
+	double m_halfWidth = 0.0;
+	bool m_shown = false; // an image is on screen
+};
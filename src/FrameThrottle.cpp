@@ -0,0 +1,60 @@
+#include "FrameThrottle.h"
+
+#include <QGuiApplication>
+#include <QScreen>
+#include <QWidget>
+#include <QWindow>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+FrameThrottle::FrameThrottle(QWidget* widget, std::function<void()> apply)
+	: QObject(widget)
+	, m_widget(widget)
+	, m_apply(std::move(apply))
+{
+	m_timer.setSingleShot(true);
+	m_timer.setTimerType(Qt::PreciseTimer);
+	connect(&m_timer, &QTimer::timeout, this, &FrameThrottle::onFrame);
+}
+
+void FrameThrottle::request()
+{
+	if (m_timer.isActive()) {
+		m_pending = true;
+		return;
+	}
+	m_pending = false;
+	m_timer.start(frameInterval());
+	m_apply();
+}
+
+void FrameThrottle::flush()
+{
+	if (!m_pending) return;
+	m_timer.stop();
+	m_pending = false;
+	m_apply();
+}
+
+void FrameThrottle::onFrame()
+{
+	if (!m_pending) return;
+	// Keep the window open while requests keep coming so the pace stays one per frame
+	m_pending = false;
+	m_timer.start(frameInterval());
+	m_apply();
+}
+
+int FrameThrottle::frameInterval() const
+{
+	QScreen* screen = nullptr;
+	if (m_widget && m_widget->window() && m_widget->window()->windowHandle()) {
+		screen = m_widget->window()->windowHandle()->screen();
+	}
+	if (!screen) screen = QGuiApplication::primaryScreen();
+
+	const double hz = screen ? screen->refreshRate() : 60.0;
+	return std::max(1, static_cast<int>(std::lround(1000.0 / (hz > 1.0 ? hz : 60.0))));
+}
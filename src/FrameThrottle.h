@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+
+#include <functional>
+
+class QWidget;
+
+// Runs a callback at most once per displayed frame.
+//
+// request() applies immediately when idle and then opens a frame-long window; requests
+// that arrive inside the window are merged into one call when it closes. Callers keep the
+// latest value themselves, so the callback always sees the newest state and a burst of
+// N requests costs two calls instead of N.
+class FrameThrottle : public QObject
+{
+	Q_OBJECT
+public:
+	// `widget` selects the screen whose refresh rate sets the frame interval
+	FrameThrottle(QWidget* widget, std::function<void()> apply);
+
+	void request();
+	// Run a merged request now, if one is waiting
+	void flush();
+
+private:
+	void onFrame();
+	int frameInterval() const;
+
+	QWidget* m_widget = nullptr;
+	std::function<void()> m_apply;
+	QTimer m_timer;
+	bool m_pending = false;
+};
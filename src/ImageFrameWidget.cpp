@@ -1,7 +1,12 @@
 #include "ImageFrameWidget.h"
+#include "ImageShiftScaleFilter.h"
+#include "VolumeKernels.h"
+#include "VolumeStatistics.h"
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
+#include <type_traits>
 
 #include <vtkCamera.h>
 #include <vtkGenericOpenGLRenderWindow.h>
@@ -9,6 +14,7 @@
 #include <vtkRenderer.h>
 #include <vtkImageData.h>
 #include <vtkImageShiftScale.h>
+#include <vtkTrivialProducer.h>
 #include <vtkMath.h>
 #include <vtkOrientationMarkerWidget.h>
 #include <vtkCubeSource.h>
@@ -45,10 +51,12 @@ ImageFrameWidget::ImageFrameWidget(QWidget* parent)
 	// Reasonable defaults; derived classes may further customize
 	initializeRendererDefaults();
 
-	m_shiftScaleFilter = vtkSmartPointer<vtkImageShiftScale>::New();
+	m_shiftScaleFilter = vtkSmartPointer<ImageShiftScaleFilter>::New();
 	m_shiftScaleFilter->SetOutputScalarTypeToUnsignedShort();
 	m_shiftScaleFilter->ClampOverflowOn();
 
+	m_nativeProducer = vtkSmartPointer<vtkTrivialProducer>::New();
+
 	// Orientation marker will be initialized lazily when an interactor is present.
 	m_orientationWidget = nullptr;
 	m_orientationAssembly = nullptr;
@@ -268,7 +276,12 @@ void ImageFrameWidget::computeShiftScaleFromInput()
 
 	m_nativeScalarType = m_imageData->GetScalarType();
 	double scalarRange[2] = { 0, 1 };
-	m_imageData->GetScalarRange(scalarRange);
+	// Shared, cached per image: the four views trigger one scan between them
+	m_statistics = VolumeStatistics::forImage(m_imageData);
+	if (m_statistics && m_statistics->count() > 0) {
+		scalarRange[0] = m_statistics->minimum();
+		scalarRange[1] = m_statistics->maximum();
+	}
 	// Guard against NaN/Inf and inverted ranges
 	const double r0 = std::isfinite(scalarRange[0]) ? scalarRange[0] : 0.0;
 	const double r1 = std::isfinite(scalarRange[1]) ? scalarRange[1] : 1.0;
@@ -280,34 +293,30 @@ void ImageFrameWidget::computeShiftScaleFromInput()
 	m_scalarShift = 0.0;
 	m_scalarScale = 1.0;
 
-	switch (m_nativeScalarType) {
-		case VTK_UNSIGNED_CHAR:
-		case VTK_UNSIGNED_SHORT:
-		m_scalarShift = 0.0;
-		m_scalarScale = 1.0;
-		break;
-		case VTK_CHAR:
-		case VTK_SIGNED_CHAR:
-		m_scalarShift = 128.0; // map [-128,127] -> [0,255]
-		m_scalarScale = 1.0;
-		break;
-		case VTK_SHORT:
-		m_scalarShift = 32768.0; // map [-32768,32767] -> [0,65535]
-		m_scalarScale = 1.0;
-		break;
-		default: {
-			// For larger ranges or floating point: shift negatives, scale up to at most 16-bit range
+	if (rendersNative()) {
+		// Identity mapping: the mappers see the input scalars, so the native <-> mapped
+		// conversions in the views collapse to no-ops. Drop the previous copy, if any.
+		m_shiftScaleFilter->RemoveAllInputs();
+		m_shiftScaleFilter->GetOutput()->ReleaseData();
+		m_nativeProducer->SetOutput(m_imageData);
+		return;
+	}
+
+	// Integer types up to 16 bit map their full type range onto [0, 65535] without scaling
+	// ([-128,127] -> [0,255], [-32768,32767] -> [0,65535]); anything wider or floating point
+	// shifts negatives and scales its data range down to 16 bit.
+	VolumeKernels::dispatch(m_nativeScalarType, [&](auto tag) {
+		using T = VolumeKernels::ValueType<decltype(tag)>;
+		if constexpr (std::is_integral_v<T> && sizeof(T) <= 2) {
+			m_scalarShift = -static_cast<double>(std::numeric_limits<T>::min());
+			m_scalarScale = 1.0;
+		}
+		else {
 			m_scalarShift = (m_scalarRangeMin < 0.0) ? -m_scalarRangeMin : 0.0;
-			if (diff > 0.0) {
-				// Preserve existing behavior: do not amplify if the range is already within 16-bit
-				m_scalarScale = std::min(65535.0 / diff, 1.0);
-			}
-			else {
-				m_scalarScale = 1.0;
-			}
-			break;
+			// Preserve existing behavior: do not amplify if the range is already within 16-bit
+			m_scalarScale = diff > 0.0 ? std::min(65535.0 / diff, 1.0) : 1.0;
 		}
-	}
+	});
 
 	// Program the shared filter
 	m_shiftScaleFilter->SetOutputScalarTypeToUnsignedShort();
@@ -317,6 +326,87 @@ void ImageFrameWidget::computeShiftScaleFromInput()
 	m_shiftScaleFilter->Update();
 }
 
+bool ImageFrameWidget::rendersNative() const
+{
+	return m_displayMode == DisplayNative || hasFloatingPointScalars() || m_sliceInput;
+}
+
+double ImageFrameWidget::minimumWindowNative() const
+{
+	if (!hasFloatingPointScalars()) return 1.0;
+	const double diff = m_scalarRangeMax - m_scalarRangeMin;
+	return diff > 0.0 ? diff * 1e-6 : 1e-6;
+}
+
+double ImageFrameWidget::minimumWindowMapped() const
+{
+	// The unsigned short copy is integral regardless of the input type
+	return rendersNative() ? minimumWindowNative() : 1.0;
+}
+
+void ImageFrameWidget::setAutoWindowPercentiles(double lowPercent, double highPercent)
+{
+	const double lo = std::clamp(std::min(lowPercent, highPercent), 0.0, 100.0);
+	const double hi = std::clamp(std::max(lowPercent, highPercent), 0.0, 100.0);
+	m_autoLowPercent = lo;
+	m_autoHighPercent = hi;
+}
+
+std::pair<double, double> ImageFrameWidget::autoWindowBounds() const
+{
+	const double diff = m_scalarRangeMax - m_scalarRangeMin;
+	double lb = diff > 0.0 ? (m_scalarRangeMin + 0.01 * diff) : m_scalarRangeMin;
+	double ub = diff > 0.0 ? (m_scalarRangeMax - 0.01 * diff) : m_scalarRangeMax;
+
+	if (m_statistics && m_statistics->count() > 0) {
+		const double p0 = m_statistics->percentile(m_autoLowPercent);
+		const double p1 = m_statistics->percentile(m_autoHighPercent);
+		// A degenerate window (e.g. mostly padding) is worse than the trimmed range
+		if (p1 > p0) {
+			lb = p0;
+			ub = p1;
+		}
+	}
+	return { lb, ub };
+}
+
+vtkAlgorithmOutput* ImageFrameWidget::displayOutputPort() const
+{
+	if (rendersNative()) {
+		return m_nativeProducer->GetOutputPort();
+	}
+	return m_shiftScaleFilter->GetOutputPort();
+}
+
+vtkImageData* ImageFrameWidget::displayImage() const
+{
+	if (rendersNative()) return m_imageData;
+	return m_shiftScaleFilter->GetOutput();
+}
+
+void ImageFrameWidget::updateDisplayInput()
+{
+	if (rendersNative()) {
+		// Mappers read m_imageData directly; nothing to recompute
+		return;
+	}
+	m_shiftScaleFilter->Update();
+}
+
+void ImageFrameWidget::setDisplayMode(DisplayMode mode)
+{
+	if (m_displayMode == mode) return;
+	m_displayMode = mode;
+
+	// Rebuild mappers, TFs and the WL baseline in the new domain
+	if (m_imageData) {
+		vtkSmartPointer<vtkImageData> image = m_imageData;
+		setImageData(image);
+	}
+
+	emit displayModeChanged(m_displayMode);
+}
+
 void ImageFrameWidget::onSelectionChanged(bool selected)
 {
 	// Optional feature: when enabled (default), only the selected frame is interactive
@@ -413,4 +503,4 @@ void ImageFrameWidget::cacheImageGeometry()
 	m_imageData->GetExtent(m_extent);
 	m_imageData->GetSpacing(m_spacing);
 	m_imageData->GetOrigin(m_origin);
-}
\ No newline at end of file
+}
@@ -4,12 +4,16 @@
 
 #include <QWidget>
 #include <limits>
+#include <memory>
 
 class vtkImageData;
 class vtkRenderer;
 class vtkGenericOpenGLRenderWindow;
 class vtkRenderWindow;
 class vtkImageShiftScale;
+class vtkTrivialProducer;
+class vtkAlgorithmOutput;
+class VolumeStatistics;
 
 // forward-declare VTK classes used by the orientation marker
 class vtkOrientationMarkerWidget;
@@ -25,6 +29,7 @@ class ImageFrameWidget : public SelectionFrameWidget
 		Q_PROPERTY(ViewOrientation viewOrientation READ viewOrientation WRITE setViewOrientation NOTIFY viewOrientationChanged)
 		Q_PROPERTY(Interpolation interpolation READ interpolation WRITE setInterpolation NOTIFY interpolationChanged)
 		Q_PROPERTY(LinkPropagationMode linkPropagationMode READ linkPropagationMode WRITE setLinkPropagationMode NOTIFY linkPropagationModeChanged)
+		Q_PROPERTY(DisplayMode displayMode READ displayMode WRITE setDisplayMode NOTIFY displayModeChanged)
 
 public:
 	enum Interpolation { Nearest, Linear, Cubic };
@@ -37,6 +42,13 @@ public:
 		enum LinkPropagationMode { Disabled, EndOnly, Live };
 	Q_ENUM(LinkPropagationMode)
 
+		// How scalars reach the mappers.
+		// DisplayMapped: through the unsigned short shift/scale copy; WL and TFs are converted to that domain.
+		// DisplayNative: the input is rendered directly; WL and TFs are applied to native scalars and
+		//                no per-view copy of the volume is made.
+		enum DisplayMode { DisplayMapped, DisplayNative };
+	Q_ENUM(DisplayMode)
+
 		explicit ImageFrameWidget(QWidget* parent = nullptr);
 	~ImageFrameWidget() override;
 
@@ -86,6 +98,30 @@ public:
 	}
 	LinkPropagationMode linkPropagationMode() const { return m_linkPropagationMode; }
 
+	// Display mode. Switching re-runs setImageData() on the current image, so the
+	// window/level returns to the baseline of the new domain.
+	void setDisplayMode(DisplayMode mode);
+	DisplayMode displayMode() const { return m_displayMode; }
+	// True when the mappers consume native scalars: DisplayNative, any floating-point
+	// input (float volumes are never quantized to 16 bit), or slices from a SliceProvider
+	bool rendersNative() const;
+	bool hasFloatingPointScalars() const { return m_nativeScalarType == VTK_FLOAT || m_nativeScalarType == VTK_DOUBLE; }
+
+	// Native scalar range of the current image
+	double scalarRangeMin() const { return m_scalarRangeMin; }
+	double scalarRangeMax() const { return m_scalarRangeMax; }
+	// Shared statistics of the current image (nullptr before an image is set)
+	std::shared_ptr<const VolumeStatistics> statistics() const { return m_statistics; }
+
+	// Percentiles used for the automatic (and initial) window/level, in percent
+	void setAutoWindowPercentiles(double lowPercent, double highPercent);
+	double autoWindowLowPercent() const { return m_autoLowPercent; }
+	double autoWindowHighPercent() const { return m_autoHighPercent; }
+	// Native-domain [lower, upper] of the automatic window: histogram percentiles of the
+	// cached statistics, so hot pixels and padding values do not stretch the display.
+	// Falls back to the scalar range trimmed by 1% when no histogram is available.
+	std::pair<double, double> autoWindowBounds() const;
+
 	// helpers to convert baseline WL to mapped domain
 	void setBaselineWindowLevel(double windowNative, double levelNative);
 	std::pair<double, double> mapWindowLevelToMapped(double windowNative, double levelNative) const;
@@ -103,6 +139,7 @@ signals:
 	void interpolationChanged(Interpolation);
 	void windowLevelChanged(double window, double level);
 	void linkPropagationModeChanged(LinkPropagationMode mode);
+	void displayModeChanged(DisplayMode mode);
 
 protected:
 	// SceneFrameWidget override: used by render() and tooling.
@@ -135,11 +172,13 @@ protected:
 	ViewOrientation  m_viewOrientation = VIEW_ORIENTATION_XY;
 	Interpolation    m_interpolation = Linear;
 	LinkPropagationMode m_linkPropagationMode = Disabled;
+	DisplayMode      m_displayMode = DisplayMapped;
 
 	vtkSmartPointer<vtkImageData>                   m_imageData;
 	vtkSmartPointer<vtkRenderer>                    m_renderer;
 	vtkSmartPointer<vtkGenericOpenGLRenderWindow>   m_renderWindow;
 	vtkSmartPointer<vtkImageShiftScale>             m_shiftScaleFilter;
+	vtkSmartPointer<vtkTrivialProducer>             m_nativeProducer; // serves m_imageData in DisplayNative
 
 	// Mapping info derived from input
 	int    m_nativeScalarType = -1;
@@ -147,10 +186,30 @@ protected:
 	double m_scalarRangeMax = 1.0;
 	double m_scalarShift = 0.0;  // shift applied by shiftScaleFilter
 	double m_scalarScale = 1.0;  // scale applied by shiftScaleFilter
+	std::shared_ptr<const VolumeStatistics> m_statistics;
+	double m_autoLowPercent = 0.5;
+	double m_autoHighPercent = 99.5;
 	void computeShiftScaleFromInput();
 
+	// Port the mappers should consume: the shift/scale output (DisplayMapped) or the input itself (DisplayNative)
+	vtkAlgorithmOutput* displayOutputPort() const;
+	// Image behind displayOutputPort() (for code that reads display scalars directly)
+	vtkImageData* displayImage() const;
+	// Bring the display input up to date after the image data was modified in place
+	void updateDisplayInput();
+
+	// Smallest window allowed when clamping WL. Integer data cannot resolve less than one
+	// step (1.0), but float data in physical units (e.g. attenuation in 1/mm) needs far
+	// narrower windows, so the floor there is relative to the scalar range.
+	double minimumWindowNative() const;
+	double minimumWindowMapped() const;
+
 	bool m_imageInitialized = false;
 
+	// Set by views whose mappers read slices extracted from a SliceProvider; those are
+	// always in the native domain
+	bool m_sliceInput = false;
+
 	// Retained baseline WL in native image domain
 	double m_baselineWindowNative = std::numeric_limits<double>::quiet_NaN();
 	double m_baselineLevelNative = std::numeric_limits<double>::quiet_NaN();
@@ -170,5 +229,8 @@ protected:
 	int m_extent[6];
 	double m_spacing[3];
 	double m_origin[3];
+
+	// Midpoint of [lo, hi] without overflowing int for extents near INT_MAX
+	static int midIndex(int lo, int hi) { return lo + (hi - lo) / 2; }
 };
 
@@ -1,6 +1,15 @@
 #include "ImageLoader.h"
+#include "CompressedVolume.h"
+#include "VolumeAllocator.h"
+#include "VolumeIndex.h"
+#include <QElapsedTimer>
 #include <QFileInfo>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
 #include <vtkCommand.h>
 #include <vtkDICOMDirectory.h>
 #include <vtkDICOMReader.h>
@@ -14,6 +23,11 @@
 #include <vtkDICOMReader.h>
 #include <vtkInformation.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
+#include <vtkPointData.h>
+#include <vtkDataArray.h>
+#include <vtkImageReslice.h>
+#include <vtkImageInterpolator.h>
+#include <vtkImageSincInterpolator.h>
 
 // VTK object factory macro
 vtkStandardNewMacro(ImageLoader);
@@ -51,6 +65,21 @@ void ImageLoader::SetImageType(ImageType type) {
 	this->cachedReader = nullptr;
 }
 
+void ImageLoader::SetReader(vtkImageAlgorithm* reader) {
+	this->cachedReader = reader;
+	if (reader)
+		forwardReaderEvents(reader);
+	this->Modified();
+}
+
+void ImageLoader::SetResampleKernel(ResampleKernel kernel) {
+	if (this->resampleKernel == kernel)
+		return;
+	this->resampleKernel = kernel;
+	// Only the post-read stage changes; the cached reader stays valid
+	this->Modified();
+}
+
 vtkSmartPointer<vtkImageData> ImageLoader::Load() {
 	switch (type) {
 		case ImageType::ScancoISQ:
@@ -131,6 +160,75 @@ vtkSmartPointer<vtkImageData> ImageLoader::LoadDICOM() {
 	return reader->GetOutput();
 }
 
+std::shared_ptr<CompressedVolume> ImageLoader::LoadCompressed()
+{
+	this->EnsureReaderInitialized();
+	if (!this->cachedReader)
+		return nullptr;
+
+	this->cachedReader->UpdateInformation();
+	vtkInformation* rOut = this->cachedReader->GetOutputInformation(0);
+	if (!rOut || !rOut->Has(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()))
+		return nullptr;
+
+	int wholeExt[6];
+	rOut->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExt);
+	double spacing[3] = { 1.0, 1.0, 1.0 };
+	double origin[3] = { 0.0, 0.0, 0.0 };
+	if (rOut->Has(vtkDataObject::SPACING()))
+		rOut->Get(vtkDataObject::SPACING(), spacing);
+	if (rOut->Has(vtkDataObject::ORIGIN()))
+		rOut->Get(vtkDataObject::ORIGIN(), origin);
+
+	const int scalarType = vtkImageData::GetScalarType(rOut);
+	if (vtkImageData::GetNumberOfScalarComponents(rOut) != 1 || !CompressedVolume::supportsScalarType(scalarType))
+		return nullptr;
+
+	std::string reason;
+	if (!ValidateVolumeExtent(wholeExt, 1, vtkDataArray::GetDataTypeSize(scalarType), &reason))
+	{
+		vtkErrorMacro(<< reason);
+		return nullptr;
+	}
+
+	auto volume = std::make_shared<CompressedVolume>(wholeExt, spacing, origin, scalarType);
+
+	// The reader restarts its progress for every slab; report overall progress instead
+	this->cachedReader->RemoveAllObservers();
+	this->lastProgress = 0.0;
+	this->InvokeEvent(vtkCommand::StartEvent);
+
+	bool ok = true;
+	const int slices = wholeExt[5] - wholeExt[4] + 1;
+	for (int z0 = wholeExt[4]; z0 <= wholeExt[5] && ok; z0 += CompressedVolume::BrickSize)
+	{
+		int slabExt[6] = { wholeExt[0], wholeExt[1], wholeExt[2], wholeExt[3],
+			z0, std::min(z0 + CompressedVolume::BrickSize - 1, wholeExt[5]) };
+		this->cachedReader->UpdateExtent(slabExt);
+
+		vtkImageData* slab = vtkImageData::SafeDownCast(this->cachedReader->GetOutputDataObject(0));
+		ok = slab && volume->appendSlab(slab);
+
+		this->lastProgress = static_cast<double>(slabExt[5] - wholeExt[4] + 1) / slices;
+		this->InvokeEvent(vtkCommand::ProgressEvent, &this->lastProgress);
+	}
+
+	// Drop the last slab and restore normal event forwarding
+	if (vtkDataObject* out = this->cachedReader->GetOutputDataObject(0))
+		out->ReleaseData();
+	forwardReaderEvents(this->cachedReader);
+	this->InvokeEvent(vtkCommand::EndEvent);
+
+	if (!ok || !volume->isComplete())
+	{
+		vtkErrorMacro(<< "Streaming the volume into compressed storage failed");
+		return nullptr;
+	}
+
+	this->lastResampled = false;
+	return volume;
+}
+
 // Ensure a single reader instance is created and configured for current type/path.
 void ImageLoader::EnsureReaderInitialized()
 {
@@ -206,6 +304,17 @@ int ImageLoader::RequestInformation(vtkInformation* vtkNotUsed(request),
 	{
 		int wholeExt[6];
 		rOut->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExt);
+
+		// Reject volumes this build cannot address before the reader allocates anything
+		const int scalarType = vtkImageData::GetScalarType(rOut);
+		const int numComp = vtkImageData::GetNumberOfScalarComponents(rOut);
+		std::string reason;
+		if (!ValidateVolumeExtent(wholeExt, numComp, vtkDataArray::GetDataTypeSize(scalarType), &reason))
+		{
+			vtkErrorMacro(<< reason);
+			return 0;
+		}
+
 		outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExt, 6);
 	}
 
@@ -215,6 +324,29 @@ int ImageLoader::RequestInformation(vtkInformation* vtkNotUsed(request),
 		double spacing[3];
 		rOut->Get(vtkDataObject::SPACING(), spacing);
 		outInfo->Set(vtkDataObject::SPACING(), spacing, 3);
+
+		// Announce the resampled geometry so downstream sees the isotropic extent
+		int inExt[6];
+		int outExt[6];
+		double outSpacing[3];
+		if (rOut->Has(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()))
+		{
+			rOut->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), inExt);
+			if (ComputeResampleGeometry(inExt, spacing, outExt, outSpacing))
+			{
+				// The resampled volume is the one RequestData allocates; fail here rather
+				// than announce an extent that can never be produced
+				std::string reason;
+				if (!ValidateVolumeExtent(outExt, vtkImageData::GetNumberOfScalarComponents(rOut),
+					vtkDataArray::GetDataTypeSize(vtkImageData::GetScalarType(rOut)), &reason))
+				{
+					vtkErrorMacro(<< "Isotropic resampling: " << reason);
+					return 0;
+				}
+				outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), outExt, 6);
+				outInfo->Set(vtkDataObject::SPACING(), outSpacing, 3);
+			}
+		}
 	}
 
 	// ORIGIN
@@ -272,10 +404,192 @@ int ImageLoader::RequestData(
 	if (!img)
 		return 0;
 
-	outInfo->Set(vtkDataObject::DATA_OBJECT(), img);
+	// Verify the produced scalars cover the full extent; a short array means some
+	// stage truncated a 64-bit voxel count.
+	int ext[6];
+	img->GetExtent(ext);
+	std::string reason;
+	if (!ValidateVolumeExtent(ext, img->GetNumberOfScalarComponents(), img->GetScalarSize(), &reason))
+	{
+		vtkErrorMacro(<< reason);
+		return 0;
+	}
+	vtkDataArray* scalars = img->GetPointData() ? img->GetPointData()->GetScalars() : nullptr;
+	const vtkIdType expected = VolumeIndex::voxelCount(ext);
+	if (!scalars || scalars->GetNumberOfTuples() != expected)
+	{
+		vtkErrorMacro(<< "Reader produced " << (scalars ? scalars->GetNumberOfTuples() : 0)
+			<< " voxels, expected " << expected);
+		return 0;
+	}
+
+	const unsigned long long nativeBytes = static_cast<unsigned long long>(expected) *
+		static_cast<unsigned long long>(img->GetNumberOfScalarComponents()) *
+		static_cast<unsigned long long>(img->GetScalarSize());
+
+	// Optional isotropic resampling stage
+	this->lastResampled = false;
+	this->lastResampleSeconds = 0.0;
+	this->lastResampleMemoryBytes = 0;
+	this->lastResampleReleasedBytes = 0;
+	vtkSmartPointer<vtkImageData> output;
+	int resampledExt[6];
+	double resampledSpacing[3];
+	if (ComputeResampleGeometry(ext, img->GetSpacing(), resampledExt, resampledSpacing))
+	{
+		// RequestInformation announced the resampled extent, so falling back to the
+		// native volume here would hand downstream a different one
+		output = ResampleToIsotropic(img);
+		if (!output)
+			return 0;
+		// Resampling only grows the volume; the native copy is not needed any more
+		this->lastResampleReleasedBytes = nativeBytes;
+	}
+	else
+	{
+		// The reader filled the volume from one thread; spread it across NUMA nodes on huge pages
+		if (VolumeAllocator::rehome(img))
+		{
+			vtkDebugMacro(<< "Moved " << nativeBytes << " bytes of scalars to the volume allocator");
+		}
+		output = vtkSmartPointer<vtkImageData>::New();
+		output->ShallowCopy(img);
+	}
+
+	// The output is a separate object, so the reader can drop its reference to the
+	// native scalars instead of keeping a second copy of the volume resident
+	this->cachedReader->GetOutputDataObject(0)->ReleaseData();
+
+	outInfo->Set(vtkDataObject::DATA_OBJECT(), output);
 	return 1;
 }
 
+bool ImageLoader::ComputeResampleGeometry(const int inExtent[6], const double inSpacing[3],
+	int outExtent[6], double outSpacing[3]) const
+{
+	if (this->resampleKernel == ResampleKernel::None)
+		return false;
+
+	double minSpacing = std::numeric_limits<double>::max();
+	double maxSpacing = 0.0;
+	for (int i = 0; i < 3; ++i)
+	{
+		// Single-voxel axes carry no spacing information
+		if (inExtent[2 * i + 1] <= inExtent[2 * i])
+			continue;
+		const double s = std::fabs(inSpacing[i]);
+		if (!(s > 0.0) || !std::isfinite(s))
+			return false;
+		minSpacing = std::min(minSpacing, s);
+		maxSpacing = std::max(maxSpacing, s);
+	}
+	if (maxSpacing <= 0.0 || maxSpacing <= 1.01 * minSpacing)
+		return false;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		const double s = std::fabs(inSpacing[i]);
+		const double length = (static_cast<double>(inExtent[2 * i + 1]) - inExtent[2 * i]) * s;
+		// Keep the first voxel in place; scale the index range to the new spacing
+		const double n = std::floor(length / minSpacing + 1e-6);
+		if (n > static_cast<double>(std::numeric_limits<int>::max() - inExtent[2 * i]))
+			return false;
+		outExtent[2 * i] = inExtent[2 * i];
+		outExtent[2 * i + 1] = inExtent[2 * i] + static_cast<int>(n);
+		outSpacing[i] = std::copysign(minSpacing, inSpacing[i]);
+	}
+	return true;
+}
+
+vtkSmartPointer<vtkImageData> ImageLoader::ResampleToIsotropic(vtkImageData* image)
+{
+	if (!image)
+		return nullptr;
+
+	int inExt[6];
+	double inSpacing[3];
+	double inOrigin[3];
+	image->GetExtent(inExt);
+	image->GetSpacing(inSpacing);
+	image->GetOrigin(inOrigin);
+
+	int outExt[6];
+	double outSpacing[3];
+	if (!ComputeResampleGeometry(inExt, inSpacing, outExt, outSpacing))
+		return nullptr;
+
+	std::string reason;
+	if (!ValidateVolumeExtent(outExt, image->GetNumberOfScalarComponents(), image->GetScalarSize(), &reason))
+	{
+		vtkErrorMacro(<< "Isotropic resampling: " << reason);
+		return nullptr;
+	}
+
+	vtkNew<vtkImageReslice> reslice;
+	reslice->SetInputData(image);
+	reslice->SetOutputSpacing(outSpacing);
+	reslice->SetOutputOrigin(inOrigin);
+	reslice->SetOutputExtent(outExt);
+	// Keep the native type; reslice clamps cubic/sinc overshoot to the type range
+	reslice->SetOutputScalarType(image->GetScalarType());
+
+	switch (this->resampleKernel)
+	{
+		case ResampleKernel::WindowedSinc:
+		{
+			vtkNew<vtkImageSincInterpolator> sinc;
+			sinc->SetWindowFunctionToLanczos();
+			sinc->SetWindowHalfWidth(3);
+			// Upsampling only; no antialiasing blur is needed
+			sinc->AntialiasingOff();
+			reslice->SetInterpolator(sinc);
+			break;
+		}
+		case ResampleKernel::Cubic:
+		{
+			vtkNew<vtkImageInterpolator> cubic;
+			cubic->SetInterpolationModeToCubic();
+			reslice->SetInterpolator(cubic);
+			break;
+		}
+		case ResampleKernel::Linear:
+		default:
+		{
+			vtkNew<vtkImageInterpolator> linear;
+			linear->SetInterpolationModeToLinear();
+			reslice->SetInterpolator(linear);
+			break;
+		}
+	}
+
+	// Split the output into z-slabs and run them on the SMP backend (all cores)
+	reslice->SetEnableSMP(true);
+	reslice->SetSplitModeToSlab();
+	forwardReaderEvents(reslice);
+
+	QElapsedTimer timer;
+	timer.start();
+	reslice->Update();
+	const double seconds = static_cast<double>(timer.nsecsElapsed()) * 1e-9;
+
+	vtkSmartPointer<vtkImageData> out = reslice->GetOutput();
+	if (!out || !out->GetPointData() || !out->GetPointData()->GetScalars())
+	{
+		vtkErrorMacro(<< "Isotropic resampling produced no scalars");
+		return nullptr;
+	}
+
+	this->lastResampled = true;
+	this->lastResampleSeconds = seconds;
+	this->lastResampleMemoryBytes = static_cast<unsigned long long>(out->GetNumberOfPoints()) *
+		static_cast<unsigned long long>(out->GetNumberOfScalarComponents()) *
+		static_cast<unsigned long long>(out->GetScalarSize());
+
+	vtkDebugMacro(<< "Resampled " << inExt[1] - inExt[0] + 1 << "x" << inExt[3] - inExt[2] + 1 << "x"
+		<< inExt[5] - inExt[4] + 1 << " to isotropic spacing " << outSpacing[0] << " in " << seconds << " s");
+	return out;
+}
+
 bool ImageLoader::CanReadFile(const QString& filePath)
 {
 	QFileInfo info(filePath);
@@ -300,3 +614,47 @@ bool ImageLoader::CanReadFile(const QString& filePath)
 
 	return false;
 }
+
+bool ImageLoader::ValidateVolumeExtent(const int extent[6], int numberOfComponents, int scalarSize, std::string* reason)
+{
+	auto fail = [reason](const std::string& msg) {
+		if (reason) *reason = msg;
+		return false;
+		};
+
+	vtkIdType dims[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		dims[i] = VolumeIndex::dimension(extent, i);
+		if (dims[i] <= 0)
+			return fail("Empty or inverted image extent");
+	}
+
+	// Multiply with overflow checks against vtkIdType (32-bit on VTK builds without VTK_USE_64BIT_IDS)
+	const vtkIdType maxId = std::numeric_limits<vtkIdType>::max();
+	vtkIdType voxels = 1;
+	for (int i = 0; i < 3; ++i)
+	{
+		if (voxels > maxId / dims[i])
+		{
+			std::ostringstream os;
+			os << "Volume of " << dims[0] << " x " << dims[1] << " x " << dims[2]
+				<< " voxels exceeds the " << (8 * sizeof(vtkIdType)) << "-bit vtkIdType of this VTK build";
+			return fail(os.str());
+		}
+		voxels *= dims[i];
+	}
+
+	// The scalar array holds voxels * components values, indexed by vtkIdType
+	const vtkIdType comps = std::max(numberOfComponents, 1);
+	if (voxels > maxId / comps)
+		return fail("Volume scalar array has more values than vtkIdType can index");
+
+	// Byte size without wrapping: values * scalarSize <= SIZE_MAX
+	const unsigned long long values = static_cast<unsigned long long>(voxels * comps);
+	const unsigned long long size = static_cast<unsigned long long>(std::max(scalarSize, 1));
+	if (values > static_cast<unsigned long long>(std::numeric_limits<size_t>::max()) / size)
+		return fail("Volume scalar array is too large to allocate on this platform");
+
+	return true;
+}
@@ -2,10 +2,14 @@
 #define IMAGELOADER_H
 
 #include <QString>
+#include <memory>
+#include <string>
 #include <vtkSmartPointer.h>
 #include <vtkImageAlgorithm.h>
 #include <vtkImageData.h>
 
+class CompressedVolume;
+
 class ImageLoader : public vtkImageAlgorithm {
 public:
 	enum class ImageType {
@@ -13,21 +17,57 @@ public:
 		DICOM
 	};
 
+	// Optional load-time resampling of anisotropic volumes to isotropic voxels
+	enum class ResampleKernel {
+		None,
+		Linear,
+		Cubic,
+		WindowedSinc
+	};
+
 	static ImageLoader* New();
 	vtkTypeMacro(ImageLoader, vtkImageAlgorithm);
 
 	void SetInputPath(const QString& path);
 	void SetImageType(ImageType type);
 
+	// Read through an already configured reader instead of one created from the input
+	// path (other formats, synthetic sources). Setting a path or type replaces it again.
+	void SetReader(vtkImageAlgorithm* reader);
+
+	// Resample to the smallest input spacing after reading (None disables).
+	// Volumes whose spacings differ by less than 1% are passed through untouched.
+	void SetResampleKernel(ResampleKernel kernel);
+	ResampleKernel GetResampleKernel() const { return resampleKernel; }
+
+	// Report for the last load: whether resampling ran, how long it took, how much
+	// scalar memory the resampled volume occupies and how much the released native
+	// volume did.
+	bool GetLastLoadResampled() const { return lastResampled; }
+	double GetLastResampleSeconds() const { return lastResampleSeconds; }
+	unsigned long long GetLastResampleMemoryBytes() const { return lastResampleMemoryBytes; }
+	unsigned long long GetLastResampleReleasedBytes() const { return lastResampleReleasedBytes; }
+
 	// For convenience, keep this method for non-pipeline usage
 	vtkSmartPointer<vtkImageData> Load();
 
+	// Stream the volume from the reader in z-slabs straight into a CompressedVolume, so
+	// the uncompressed volume is never resident. Returns nullptr when the scalar type is
+	// not supported by CompressedVolume (callers fall back to Load()/Update()).
+	// Isotropic resampling is not applied on this path.
+	std::shared_ptr<CompressedVolume> LoadCompressed();
+
 	// Add this method to get the last progress value
 	double GetProgress() const;
 
 	// Add this method for file type detection
 	static bool CanReadFile(const QString& filePath);
 
+	// Check that a volume with the given extent can be addressed by this build.
+	// Voxel counts and byte sizes are computed in 64 bits; volumes above 2^31 voxels
+	// require VTK to be built with 64-bit vtkIdType. On failure, reason is filled in.
+	static bool ValidateVolumeExtent(const int extent[6], int numberOfComponents, int scalarSize, std::string* reason = nullptr);
+
 protected:
 	ImageLoader();
 	~ImageLoader() override = default;
@@ -52,9 +92,24 @@ private:
 	// Store the last progress value from forwarded events
 	double lastProgress = 0.0;
 
+	// Resampling state and report
+	ResampleKernel resampleKernel = ResampleKernel::None;
+	bool lastResampled = false;
+	double lastResampleSeconds = 0.0;
+	unsigned long long lastResampleMemoryBytes = 0;
+	unsigned long long lastResampleReleasedBytes = 0;
+
 	vtkSmartPointer<vtkImageData> LoadScancoISQ();
 	vtkSmartPointer<vtkImageData> LoadDICOM();
 
+	// Compute the isotropic output geometry for the given input; returns false when
+	// resampling is disabled or the input is already (nearly) isotropic.
+	bool ComputeResampleGeometry(const int inExtent[6], const double inSpacing[3],
+		int outExtent[6], double outSpacing[3]) const;
+
+	// Run the multithreaded resampling stage on a loaded volume
+	vtkSmartPointer<vtkImageData> ResampleToIsotropic(vtkImageData* image);
+
 	// Cached reader instance used for both RequestInformation and RequestData
 	vtkSmartPointer<vtkImageAlgorithm> cachedReader;
 
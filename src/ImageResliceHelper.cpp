@@ -0,0 +1,63 @@
+#include "ImageResliceHelper.h"
+
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+
+#include <algorithm>
+#include <cmath>
+
+vtkStandardNewMacro(ImageResliceHelper);
+
+ImageResliceHelper::ImageResliceHelper()
+{
+	this->SetEnableSMP(true);
+	this->SetOutputDimensionality(2);
+	this->SetInterpolationModeToLinear();
+	this->AutoCropOutputOff();
+	this->TransformInputSamplingOff();
+	this->SetBackgroundLevel(0.0);
+
+	vtkNew<vtkMatrix4x4> axes;
+	this->SetResliceAxes(axes);
+	this->SetRegion(0.0, 0.0, 0.0, 0.0, 1.0);
+}
+
+void ImageResliceHelper::SetPlane(const double center[3], const double u[3], const double v[3])
+{
+	const double n[3] = {
+		u[1] * v[2] - u[2] * v[1],
+		u[2] * v[0] - u[0] * v[2],
+		u[0] * v[1] - u[1] * v[0]
+	};
+	// Columns are the output axes in input (world) coordinates
+	const double elements[16] = {
+		u[0], v[0], n[0], center[0],
+		u[1], v[1], n[1], center[1],
+		u[2], v[2], n[2], center[2],
+		0.0,  0.0,  0.0,  1.0
+	};
+
+	vtkMatrix4x4* axes = this->GetResliceAxes();
+	bool changed = false;
+	for (int i = 0; i < 16 && !changed; ++i) changed = axes->GetData()[i] != elements[i];
+	if (!changed) return;
+	axes->DeepCopy(elements);
+	this->Modified();
+}
+
+void ImageResliceHelper::SetRegion(double x0, double y0, double x1, double y1, double pixel)
+{
+	if (!(pixel > 0.0)) pixel = 1.0;
+	// Enough pixels to cover the region, snapped to the pixel grid so panning by whole
+	// pixels reuses the same sample positions
+	const double gx = std::floor(x0 / pixel) * pixel;
+	const double gy = std::floor(y0 / pixel) * pixel;
+	const int nx = std::clamp(static_cast<int>(std::ceil((x1 - gx) / pixel)) + 1, 1, MaxSamples);
+	const int ny = std::clamp(static_cast<int>(std::ceil((y1 - gy) / pixel)) + 1, 1, MaxSamples);
+
+	// The vtkSetVector macros only call Modified() on a change
+	this->SetOutputOrigin(gx, gy, 0.0);
+	this->SetOutputSpacing(pixel, pixel, pixel);
+	this->SetOutputExtent(0, nx - 1, 0, ny - 1, 0, 0);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vtkImageReslice.h>
+
+// Oblique plane extraction for SliceView.
+//
+// A vtkImageReslice configured for interactive viewing: the plane is given as a center
+// and two orthonormal in-plane axes, and only a rectangle of the plane (the on-screen
+// region, in plane coordinates) is sampled, at the requested pixel size. The cost of a
+// frame is therefore bounded by the viewport's pixel count, not by the volume size, and
+// rows are spread across all cores through the vtkSMPTools backend.
+//
+// Output is a single-slice image at z = 0 whose x/y axes are the plane's u/v axes.
+class ImageResliceHelper : public vtkImageReslice
+{
+public:
+	static ImageResliceHelper* New();
+	vtkTypeMacro(ImageResliceHelper, vtkImageReslice);
+
+	// Plane through `center` spanned by unit vectors u and v (normal = u x v)
+	void SetPlane(const double center[3], const double u[3], const double v[3]);
+
+	// Sample [x0, x1] x [y0, y1] of the plane with square pixels of size `pixel`. The
+	// sample count is capped at MaxSamples per axis.
+	void SetRegion(double x0, double y0, double x1, double y1, double pixel);
+
+	static constexpr int MaxSamples = 8192;
+
+protected:
+	ImageResliceHelper();
+	~ImageResliceHelper() override = default;
+
+private:
+	ImageResliceHelper(const ImageResliceHelper&) = delete;
+	void operator=(const ImageResliceHelper&) = delete;
+};
@@ -0,0 +1,94 @@
+#include "ImageShiftScaleFilter.h"
+#include "ShiftScaleKernel.h"
+#include "VolumeAllocator.h"
+#include "VolumeKernels.h"
+
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+vtkStandardNewMacro(ImageShiftScaleFilter);
+
+namespace {
+	template <typename T>
+	void convertExtent(vtkImageData* input, vtkImageData* output, const int ext[6], double shift, double scale)
+	{
+		const int numComp = input->GetNumberOfScalarComponents();
+		const std::size_t rowLength =
+			static_cast<std::size_t>(ext[1] - ext[0] + 1) * static_cast<std::size_t>(numComp);
+
+		// Increments are in scalar units (components included) and already vtkIdType
+		vtkIdType inInc[3];
+		vtkIdType outInc[3];
+		input->GetIncrements(inInc);
+		output->GetIncrements(outInc);
+
+		const T* inBase = static_cast<const T*>(input->GetScalarPointerForExtent(const_cast<int*>(ext)));
+		unsigned short* outBase = static_cast<unsigned short*>(output->GetScalarPointerForExtent(const_cast<int*>(ext)));
+
+		for (int z = ext[4]; z <= ext[5]; ++z) {
+			const vtkIdType dz = static_cast<vtkIdType>(z - ext[4]);
+			for (int y = ext[2]; y <= ext[3]; ++y) {
+				const vtkIdType dy = static_cast<vtkIdType>(y - ext[2]);
+				const T* in = inBase + dy * inInc[1] + dz * inInc[2];
+				unsigned short* out = outBase + dy * outInc[1] + dz * outInc[2];
+				ShiftScaleKernel::convert(in, out, rowLength, shift, scale);
+			}
+		}
+	}
+}
+
+ImageShiftScaleFilter::ImageShiftScaleFilter()
+{
+	// The stock fallback also runs on the SMP backend, split along z so each piece
+	// covers whole contiguous rows.
+	this->SetEnableSMP(true);
+	this->SetSplitModeToSlab();
+}
+
+void ImageShiftScaleFilter::AllocateOutputData(vtkImageData* output, vtkInformation* outInfo, int* uExtent)
+{
+	output->SetExtent(uExtent);
+	VolumeAllocator::allocateScalars(output, vtkImageData::GetScalarType(outInfo),
+		vtkImageData::GetNumberOfScalarComponents(outInfo), false);
+}
+
+int ImageShiftScaleFilter::RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+	vtkInformationVector* outputVector)
+{
+	vtkInformation* outInfo = outputVector->GetInformationObject(0);
+	vtkImageData* input = vtkImageData::GetData(inputVector[0]);
+	vtkImageData* output = vtkImageData::GetData(outputVector);
+
+	int outExt[6];
+	outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outExt);
+
+	const bool fastPath = input && output &&
+		this->GetClampOverflow() &&
+		vtkImageData::GetScalarType(outInfo) == VTK_UNSIGNED_SHORT &&
+		vtkImageData::GetNumberOfScalarComponents(outInfo) == input->GetNumberOfScalarComponents();
+
+	if (!fastPath || outExt[0] > outExt[1] || outExt[2] > outExt[3] || outExt[4] > outExt[5]) {
+		return this->Superclass::RequestData(request, inputVector, outputVector);
+	}
+
+	const double shift = this->GetShift();
+	const double scale = this->GetScale();
+
+	const bool known = VolumeKernels::dispatch(input->GetScalarType(), [&](auto tag) {
+		using T = VolumeKernels::ValueType<decltype(tag)>;
+		this->AllocateOutputData(output, outInfo, outExt);
+		this->CopyAttributeData(input, output, inputVector);
+		// Slabs of whole rows: each task converts contiguous memory and first-touches its pages
+		VolumeKernels::forEachSlab(outExt, [&](int z0, int z1) {
+			const int slab[6] = { outExt[0], outExt[1], outExt[2], outExt[3], z0, z1 };
+			convertExtent<T>(input, output, slab, shift, scale);
+		}, VolumeKernels::slabDepth(outExt));
+	});
+	if (!known) {
+		return this->Superclass::RequestData(request, inputVector, outputVector);
+	}
+	return 1;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vtkImageShiftScale.h>
+
+// Drop-in replacement for vtkImageShiftScale used by ImageFrameWidget.
+//
+// When the output is unsigned short with ClampOverflow on (the display conversion path),
+// the volume is converted with the SIMD kernels in ShiftScaleKernel.h in z-slabs spread
+// across all cores (VolumeKernels::forEachSlab). Any other configuration falls back
+// to the stock vtkImageShiftScale implementation. Output is identical in both cases for
+// non-NaN input (tests/TestImageShiftScaleFilter.cpp); NaN converts to 0.
+// Large outputs are allocated through VolumeAllocator; the parallel conversion is their
+// first touch.
+class ImageShiftScaleFilter : public vtkImageShiftScale
+{
+public:
+	static ImageShiftScaleFilter* New();
+	vtkTypeMacro(ImageShiftScaleFilter, vtkImageShiftScale);
+
+protected:
+	ImageShiftScaleFilter();
+	~ImageShiftScaleFilter() override = default;
+
+	using Superclass::AllocateOutputData;
+	void AllocateOutputData(vtkImageData* output, vtkInformation* outInfo, int* uExtent) override;
+
+	int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+		vtkInformationVector* outputVector) override;
+
+private:
+	ImageShiftScaleFilter(const ImageShiftScaleFilter&) = delete;
+	void operator=(const ImageShiftScaleFilter&) = delete;
+};
@@ -0,0 +1,47 @@
+#include "ImageSliceProvider.h"
+#include "VolumeIndex.h"
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+
+#include <algorithm>
+
+ImageSliceProvider::ImageSliceProvider(vtkImageData* image)
+	: m_image(image)
+{
+	if (m_image) m_image->GetExtent(m_extent);
+}
+
+void ImageSliceProvider::getExtent(int extent[6]) const { std::copy(m_extent, m_extent + 6, extent); }
+void ImageSliceProvider::getSpacing(double spacing[3]) const { m_image->GetSpacing(spacing); }
+void ImageSliceProvider::getOrigin(double origin[3]) const { m_image->GetOrigin(origin); }
+int ImageSliceProvider::scalarType() const { return m_image ? m_image->GetScalarType() : VTK_VOID; }
+
+bool ImageSliceProvider::extractSlice(int axis, int index, vtkImageData* slice)
+{
+	if (!slice || !m_image || axis < 0 || axis > 2) return false;
+	if (index < m_extent[2 * axis] || index > m_extent[2 * axis + 1]) return false;
+
+	int outExt[6];
+	std::copy(m_extent, m_extent + 6, outExt);
+	outExt[2 * axis] = outExt[2 * axis + 1] = index;
+
+	slice->SetExtent(outExt);
+	slice->SetSpacing(m_image->GetSpacing());
+	slice->SetOrigin(m_image->GetOrigin());
+	slice->AllocateScalars(m_image->GetScalarType(), m_image->GetNumberOfScalarComponents());
+	slice->CopyAndCastFrom(m_image, outExt);
+	return true;
+}
+
+double ImageSliceProvider::voxelValue(int i, int j, int k)
+{
+	vtkDataArray* scalars = m_image ? m_image->GetPointData()->GetScalars() : nullptr;
+	if (!scalars) return 0.0;
+	if (i < m_extent[0] || i > m_extent[1] || j < m_extent[2] || j > m_extent[3] || k < m_extent[4] || k > m_extent[5]) {
+		return 0.0;
+	}
+	// Offsets pass 2^31 on large scans
+	return scalars->GetComponent(VolumeIndex::voxelOffset(m_extent, i, j, k), 0);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "SliceProvider.h"
+
+#include <vtkSmartPointer.h>
+
+class vtkImageData;
+
+// SliceProvider over an in-memory vtkImageData, so plain volumes can be sliced through
+// SliceCache. Slices are copied out of the image (strided for YZ/XZ); the image is only
+// read, so extraction may run on worker threads while the views render it.
+class ImageSliceProvider : public SliceProvider
+{
+public:
+	explicit ImageSliceProvider(vtkImageData* image);
+
+	void getExtent(int extent[6]) const override;
+	void getSpacing(double spacing[3]) const override;
+	void getOrigin(double origin[3]) const override;
+	int scalarType() const override;
+	bool extractSlice(int axis, int index, vtkImageData* slice) override;
+	double voxelValue(int i, int j, int k) override;
+
+private:
+	vtkSmartPointer<vtkImageData> m_image;
+	int m_extent[6] = { 0, -1, 0, -1, 0, -1 };
+};
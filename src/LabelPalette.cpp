@@ -0,0 +1,75 @@
+#include "LabelPalette.h"
+
+#include <algorithm>
+
+namespace {
+	// Default label colours, repeated for higher labels
+	constexpr double kDefaultColors[][3] = {
+		{ 1.00, 0.20, 0.20 }, { 0.20, 0.85, 0.20 }, { 0.25, 0.45, 1.00 }, { 1.00, 0.85, 0.10 },
+		{ 0.95, 0.30, 0.95 }, { 0.10, 0.90, 0.90 }, { 1.00, 0.55, 0.10 }, { 0.60, 0.35, 1.00 },
+		{ 0.55, 0.90, 0.35 }, { 1.00, 0.45, 0.65 }, { 0.35, 0.75, 1.00 }, { 0.80, 0.65, 0.40 },
+	};
+	constexpr int kDefaultColorCount = static_cast<int>(sizeof(kDefaultColors) / sizeof(kDefaultColors[0]));
+}
+
+LabelPalette::LabelPalette()
+{
+	m_table = vtkSmartPointer<vtkLookupTable>::New();
+	m_table->SetNumberOfTableValues(LabelCount);
+	// Label v maps to entry v exactly
+	m_table->SetTableRange(-0.5, LabelCount - 0.5);
+
+	m_table->SetTableValue(0, 0.0, 0.0, 0.0, 0.0);
+	for (int label = 1; label < LabelCount; ++label) {
+		const double* c = kDefaultColors[(label - 1) % kDefaultColorCount];
+		std::copy(c, c + 3, m_entries[label].rgb);
+		updateEntry(label);
+	}
+}
+
+void LabelPalette::setColor(int label, double r, double g, double b)
+{
+	if (!valid(label)) return;
+	Entry& e = m_entries[label];
+	e.rgb[0] = r;
+	e.rgb[1] = g;
+	e.rgb[2] = b;
+	updateEntry(label);
+}
+
+void LabelPalette::setOpacity(int label, double opacity)
+{
+	if (!valid(label)) return;
+	m_entries[label].opacity = std::clamp(opacity, 0.0, 1.0);
+	updateEntry(label);
+}
+
+void LabelPalette::setVisible(int label, bool visible)
+{
+	if (!valid(label)) return;
+	m_entries[label].visible = visible;
+	updateEntry(label);
+}
+
+void LabelPalette::color(int label, double rgb[3]) const
+{
+	const Entry& e = m_entries[std::clamp(label, 0, LabelCount - 1)];
+	std::copy(e.rgb, e.rgb + 3, rgb);
+}
+
+double LabelPalette::opacity(int label) const
+{
+	return valid(label) ? m_entries[label].opacity : 0.0;
+}
+
+bool LabelPalette::isVisible(int label) const
+{
+	return valid(label) && m_entries[label].visible;
+}
+
+void LabelPalette::updateEntry(int label)
+{
+	const Entry& e = m_entries[label];
+	m_table->SetTableValue(label, e.rgb[0], e.rgb[1], e.rgb[2], e.visible ? e.opacity : 0.0);
+	m_table->Modified();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vtkLookupTable.h>
+#include <vtkSmartPointer.h>
+
+#include <array>
+
+// Colour, opacity and visibility of each label of a uint8 label map, kept as the lookup
+// table the slice views' overlay layers are drawn with. Label 0 is background and stays
+// transparent.
+//
+// Edits only rewrite table entries: the mappers re-map just the visible slice through the
+// table on the next render, and the label map itself is never touched.
+class LabelPalette
+{
+public:
+	static constexpr int LabelCount = 256;
+
+	LabelPalette();
+
+	void setColor(int label, double r, double g, double b);
+	void setOpacity(int label, double opacity);
+	void setVisible(int label, bool visible);
+	void color(int label, double rgb[3]) const;
+	double opacity(int label) const;
+	bool isVisible(int label) const;
+
+	// Indexed by label value (table range -0.5 .. 255.5, one entry per label)
+	vtkLookupTable* lookupTable() const { return m_table; }
+
+private:
+	struct Entry
+	{
+		double rgb[3] = { 1.0, 0.0, 0.0 };
+		double opacity = 0.5;
+		bool visible = true;
+	};
+
+	static bool valid(int label) { return label > 0 && label < LabelCount; }
+	void updateEntry(int label);
+
+	std::array<Entry, LabelCount> m_entries;
+	vtkSmartPointer<vtkLookupTable> m_table;
+};
@@ -1,14 +1,28 @@
 #include "LightboxWidget.h"
 #include "SliceView.h"
 #include "VolumeView.h"
+#include "MosaicView.h"
+#include "CurvedReformatView.h"
 #include "SelectionFrameWidget.h"
+#include "CompressedVolume.h"
+#include "BrickedVolume.h"
+#include "ImageSliceProvider.h"
+#include "FrameThrottle.h"
+#include "CursorModel.h"
 
 #include "WindowLevelController.h"
 #include "WindowLevelBridge.h"
+#include "VolumeAllocator.h"
+#include "VolumeIndex.h"
+#include "VolumeKernels.h"
+#include "VolumeStatistics.h"
 
 #include <vtkImageSinusoidSource.h>
 #include <vtkSmartPointer.h>
 #include <vtkImageProperty.h>
+#include <vtkDataArray.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
 
 #include <QShowEvent>
 #include <QTimer>
@@ -16,8 +30,55 @@
 #include <QPropertyAnimation>
 #include <QEasingCurve>
 #include <QParallelAnimationGroup>
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <vector>
+
+namespace {
+	// Threshold mask (1 inside, 0 outside) of a compressed volume at full resolution,
+	// decoded brick by brick outside the cache; nullptr if the mask cannot be allocated
+	vtkSmartPointer<vtkImageData> thresholdMask(const CompressedVolume& volume, double lower, double upper)
+	{
+		int extent[6];
+		double spacing[3];
+		double origin[3];
+		volume.getExtent(extent);
+		volume.getSpacing(spacing);
+		volume.getOrigin(origin);
+
+		auto labels = vtkSmartPointer<vtkImageData>::New();
+		labels->SetExtent(extent);
+		labels->SetSpacing(spacing);
+		labels->SetOrigin(origin);
+		// The brick pass below writes every byte
+		VolumeAllocator::allocateScalars(labels, VTK_UNSIGNED_CHAR, 1, false);
+		auto* mask = static_cast<unsigned char*>(labels->GetScalarPointer());
+		if (!mask) return nullptr;
+
+		VolumeKernels::dispatch(volume.scalarType(), [&](auto tag) {
+			using T = VolumeKernels::ValueType<decltype(tag)>;
+			vtkSMPTools::For(0, volume.numberOfBricks(), 16, [&](vtkIdType begin, vtkIdType end) {
+				std::vector<T> buffer(volume.brickBytes() / sizeof(T));
+				for (vtkIdType b = begin; b < end; ++b) {
+					int be[6];
+					volume.decodeBrick(b, buffer.data(), be);
+					const T* p = buffer.data();
+					for (int z = be[4]; z <= be[5]; ++z) {
+						for (int y = be[2]; y <= be[3]; ++y) {
+							unsigned char* row = mask + VolumeIndex::voxelOffset(extent, be[0], y, z);
+							for (int x = 0; x <= be[1] - be[0]; ++x, ++p) {
+								const double v = static_cast<double>(*p);
+								row[x] = (v >= lower && v <= upper) ? 1 : 0;
+							}
+						}
+					}
+				}
+			});
+		});
+		return labels;
+	}
+}
 
 LightboxWidget::LightboxWidget(QWidget* parent)
 	: QWidget(parent)
@@ -64,6 +125,7 @@ LightboxWidget::LightboxWidget(QWidget* parent)
 		if (auto* yz = getYZView()) yz->setWindowLevelNative(w, l);
 		if (auto* xz = getXZView()) xz->setWindowLevelNative(w, l);
 		if (auto* xy = getXYView()) xy->setWindowLevelNative(w, l);
+		if (m_mosaicView) m_mosaicView->setWindowLevelNative(w, l);
 
 		m_propagatingWindowLevel = false;
 	}, Qt::UniqueConnection);
@@ -78,6 +140,7 @@ LightboxWidget::LightboxWidget(QWidget* parent)
 		if (auto* yz = getYZView()) yz->setWindowLevelNative(w, l);
 		if (auto* xz = getXZView()) xz->setWindowLevelNative(w, l);
 		if (auto* xy = getXYView()) xy->setWindowLevelNative(w, l);
+		if (m_mosaicView) m_mosaicView->setWindowLevelNative(w, l);
 
 		m_propagatingWindowLevel = false;
 	}, Qt::UniqueConnection);
@@ -108,6 +171,7 @@ LightboxWidget::LightboxWidget(QWidget* parent)
 			// Update other slices (slaves)
 			if (auto* xz = getXZView()) { if (xz != yz) xz->setWindowLevelNative(w, l); }
 			if (auto* xy = getXYView()) { if (xy != yz) xy->setWindowLevelNative(w, l); }
+			if (m_mosaicView) m_mosaicView->setWindowLevelNative(w, l);
 
 			m_propagatingWindowLevel = false;
 		}, Qt::UniqueConnection);
@@ -121,6 +185,7 @@ LightboxWidget::LightboxWidget(QWidget* parent)
 
 			if (auto* yz = getYZView()) { if (yz != xz) yz->setWindowLevelNative(w, l); }
 			if (auto* xy = getXYView()) { if (xy != xz) xy->setWindowLevelNative(w, l); }
+			if (m_mosaicView) m_mosaicView->setWindowLevelNative(w, l);
 
 			m_propagatingWindowLevel = false;
 		}, Qt::UniqueConnection);
@@ -134,6 +199,7 @@ LightboxWidget::LightboxWidget(QWidget* parent)
 
 			if (auto* yz = getYZView()) { if (yz != xy) yz->setWindowLevelNative(w, l); }
 			if (auto* xz = getXZView()) { if (xz != xy) xz->setWindowLevelNative(w, l); }
+			if (m_mosaicView) m_mosaicView->setWindowLevelNative(w, l);
 
 			m_propagatingWindowLevel = false;
 		}, Qt::UniqueConnection);
@@ -142,6 +208,8 @@ LightboxWidget::LightboxWidget(QWidget* parent)
 	// Wire controller reset request to propagate to our child views
 	connect(m_wlController, &WindowLevelController::requestResetWindowLevel,
 			this, &LightboxWidget::resetWindowLevel, Qt::UniqueConnection);
+	connect(m_wlController, &WindowLevelController::requestAutoWindowLevel,
+			this, &LightboxWidget::autoWindowLevel, Qt::UniqueConnection);
 }
 
 void LightboxWidget::showEvent(QShowEvent* e)
@@ -168,11 +236,95 @@ void LightboxWidget::setDefaultImage()
 
 void LightboxWidget::setImageData(vtkImageData* image)
 {
+	// Slice the image itself, a bricked copy of it, or (for prefetch) the image through a provider
+	m_compressedVolume.reset();
+	m_volumeIndexDivisor = 1;
+	std::shared_ptr<SliceProvider> provider = sliceProviderFor(image);
+	if (ui.YZView) ui.YZView->setSliceProvider(provider);
+	if (ui.XZView) ui.XZView->setSliceProvider(provider);
+	if (ui.XYView) ui.XYView->setSliceProvider(provider);
+
+	applyImageData(image);
+}
+
+std::shared_ptr<SliceProvider> LightboxWidget::sliceProviderFor(vtkImageData* image) const
+{
+	if (!image) return nullptr;
+	std::shared_ptr<SliceProvider> provider;
+	if (m_brickedSlicing) provider = BrickedVolume::fromImage(image);
+	if (!provider && m_slicePrefetch > 0) provider = std::make_shared<ImageSliceProvider>(image);
+	return provider;
+}
+
+void LightboxWidget::replaceSliceProviders()
+{
+	// Compressed volumes are sliced from their bricks whatever the options
+	if (m_compressedVolume || !ui.volumeView || !ui.volumeView->imageData()) return;
+	std::shared_ptr<SliceProvider> provider = sliceProviderFor(ui.volumeView->imageData());
+
+	// The views may share one image property: read every WL before any view swaps
+	SliceView* views[3] = { ui.YZView, ui.XZView, ui.XYView };
+	double window[3] = { 0.0, 0.0, 0.0 }, level[3] = { 0.0, 0.0, 0.0 };
+	for (int i = 0; i < 3; ++i) {
+		if (views[i]) views[i]->windowLevelNative(window[i], level[i]);
+	}
+	for (int i = 0; i < 3; ++i) {
+		if (views[i]) views[i]->replaceSliceProvider(provider, window[i], level[i]);
+	}
+}
+
+void LightboxWidget::setCompressedVolume(std::shared_ptr<CompressedVolume> volume)
+{
+	if (!volume) return;
+
+	// Keep the GPU preview (and its statistics scan) within 512^3 voxels
+	constexpr vtkIdType kPreviewVoxels = vtkIdType(512) * 512 * 512;
+	m_volumeIndexDivisor = volume->downsampleFactorFor(kPreviewVoxels);
+	vtkSmartPointer<vtkImageData> preview = volume->decodeDownsampled(m_volumeIndexDivisor);
+	// Range, histogram and automatic window/level of every view come from the full
+	// volume (one pass over the bricks), not from the preview they render
+	VolumeStatistics::setForImage(preview, VolumeStatistics::compute(*volume));
+
+	int extent[6];
+	volume->getExtent(extent);
+	for (int a = 0; a < 3; ++a) m_sliceIndexOrigin[a] = extent[2 * a];
+
+	m_compressedVolume = volume;
+	if (ui.YZView) ui.YZView->setSliceProvider(volume);
+	if (ui.XZView) ui.XZView->setSliceProvider(volume);
+	if (ui.XYView) ui.XYView->setSliceProvider(volume);
+
+	applyImageData(preview);
+	syncVolumeSlicePlanes();
+}
+
+void LightboxWidget::applyImageData(vtkImageData* image)
+{
+	// A new image starts without a picked cursor or labels
+	for (SliceView* view : { ui.YZView, ui.XZView, ui.XYView }) {
+		if (view) view->setCrosshairVisible(false);
+	}
+	setLabelMap(nullptr);
+
 	// Forward to child views if they exist
 	if (ui.YZView) ui.YZView->setImageData(image);
 	if (ui.XZView) ui.XZView->setImageData(image);
 	if (ui.XYView) ui.XYView->setImageData(image);
 	if (ui.volumeView) ui.volumeView->setImageData(image);
+	// A hidden mosaic catches up when it is shown again
+	if (m_mosaicView && m_mosaicMode) m_mosaicView->setImageData(image);
+	// The slice views dropped their paths with the old image
+	m_path.clear();
+	if (m_curvedReformatMode && !applyReformatVolume()) setCurvedReformatMode(false);
+
+	// Let the controller edit WL at the precision of the data (float volumes are in physical units)
+	if (m_wlController && ui.volumeView) {
+		m_wlController->setDataRange(ui.volumeView->scalarRangeMin(), ui.volumeView->scalarRangeMax(),
+			ui.volumeView->hasFloatingPointScalars());
+		// The baseline was pushed to the spin boxes before their precision changed; push it again
+		m_wlController->setWindow(ui.volumeView->baselineWindowNative());
+		m_wlController->setLevel(ui.volumeView->baselineLevelNative());
+	}
 }
 
 void LightboxWidget::setYZSlice(int index)
@@ -204,17 +356,63 @@ void LightboxWidget::connectSliceSynchronization()
 {
 	if (!ui.YZView || !ui.XZView || !ui.XYView || !ui.volumeView) return;
 
-	connect(ui.YZView, &SliceView::sliceChanged, this, [this](int index) {
-		if (ui.volumeView) ui.volumeView->updateSlicePlanes(index, ui.XZView->getSliceIndex(), ui.XYView->getSliceIndex());
-	});
-	connect(ui.XZView, &SliceView::sliceChanged, this, [this](int index) {
-		if (ui.volumeView) ui.volumeView->updateSlicePlanes(ui.YZView->getSliceIndex(), index, ui.XYView->getSliceIndex());
-	});
-	connect(ui.XYView, &SliceView::sliceChanged, this, [this](int index) {
-		if (ui.volumeView) ui.volumeView->updateSlicePlanes(ui.YZView->getSliceIndex(), ui.XZView->getSliceIndex(), index);
+	// The volume view re-reads the whole cursor, so one update per frame covers any
+	// number of slice changes in it
+	m_volumePlanesThrottle = new FrameThrottle(this, [this]() { syncVolumeSlicePlanes(); });
+
+	// Every view writes its own axis to the cursor; the cursor moves only the views whose
+	// axis changed, and their echo back is a no-op
+	m_cursor = new CursorModel(this);
+	const std::array<SliceView*, 3> views{ { ui.YZView, ui.XZView, ui.XYView } };
+	for (SliceView* view : views) {
+		connect(view, &SliceView::sliceChanged, this, [this, view](int index) {
+			m_cursor->setAxis(view->viewOrientation(), index);
+		});
+		connect(view, &SliceView::cursorPicked, this, [this](int x, int y, int z) {
+			for (SliceView* v : { ui.YZView, ui.XZView, ui.XYView }) v->setCrosshairVisible(true);
+			m_cursor->setPosition(x, y, z);
+		});
+		connect(view, &SliceView::voxelProbed, this, &LightboxWidget::voxelProbed);
+		connect(view, &SliceView::pathEdited, this, [this, view](const std::vector<CurvedReformat::Point>& points) {
+			// A new path leans across the axis of the view it is started in
+			if (m_path.size() <= 1 && m_reformatView) m_reformatView->setReferenceAxis(view->viewOrientation());
+			m_path = points;
+			for (SliceView* v : { ui.YZView, ui.XZView, ui.XYView }) {
+				if (v != view) v->setPath(points);
+			}
+			if (m_reformatView && m_curvedReformatMode) m_reformatView->setPath(points);
+		});
+		connect(view, &SliceView::probeLeft, this, &LightboxWidget::probeLeft);
+	}
+	connect(m_cursor, &CursorModel::positionChanged, this, [this](int x, int y, int z, int changedAxes) {
+		const int p[3] = { x, y, z };
+		for (SliceView* view : { ui.YZView, ui.XZView, ui.XYView }) {
+			const int axis = view->viewOrientation();
+			if ((changedAxes & (1 << axis)) && view->getSliceIndex() != p[axis]) view->setSliceIndex(p[axis]);
+			view->setCursorPosition(x, y, z);
+		}
+		m_volumePlanesThrottle->request();
 	});
 }
 
+void LightboxWidget::syncVolumeSlicePlanes()
+{
+	if (!ui.volumeView || !m_cursor) return;
+
+	const int* index = m_cursor->position();
+	if (!m_compressedVolume) {
+		ui.volumeView->updateSlicePlanes(index[0], index[1], index[2]);
+		return;
+	}
+
+	// Slice views index the full-resolution volume; the volume view shows the preview
+	int preview[3];
+	for (int a = 0; a < 3; ++a) {
+		preview[a] = (index[a] - m_sliceIndexOrigin[a]) / m_volumeIndexDivisor;
+	}
+	ui.volumeView->updateSlicePlanes(preview[0], preview[1], preview[2]);
+}
+
 void LightboxWidget::connectSelectionCoordination()
 {
 	using SF = SelectionFrameWidget;
@@ -489,7 +687,246 @@ void LightboxWidget::resetWindowLevel()
 	if (auto* xz = getXZView()) xz->resetWindowLevel();
 	if (auto* xy = getXYView()) xy->resetWindowLevel();
 	if (auto* vol = getVolumeView()) vol->resetWindowLevel();
+	if (m_mosaicView) m_mosaicView->resetWindowLevel();
 
 	m_propagatingWindowLevel = false;
 }
 
+void LightboxWidget::setNativeDisplay(bool native)
+{
+	const auto mode = native ? ImageFrameWidget::DisplayNative : ImageFrameWidget::DisplayMapped;
+
+	// Each frame re-runs its image setup; the volume view emits the new baseline WL,
+	// which keeps the controller in sync.
+	if (auto* yz = getYZView()) yz->setDisplayMode(mode);
+	if (auto* xz = getXZView()) xz->setDisplayMode(mode);
+	if (auto* xy = getXYView()) xy->setDisplayMode(mode);
+	if (auto* vol = getVolumeView()) vol->setDisplayMode(mode);
+	if (m_mosaicView) m_mosaicView->setDisplayMode(mode);
+}
+
+void LightboxWidget::setBrickedSlicing(bool bricked)
+{
+	if (m_brickedSlicing == bricked) return;
+	m_brickedSlicing = bricked;
+
+	// Only the slice source changes; the image, labels, WL, path and cursor stay
+	replaceSliceProviders();
+}
+
+void LightboxWidget::setSlicePrefetch(int depth)
+{
+	depth = std::max(depth, 0);
+	if (m_slicePrefetch == depth) return;
+	const bool providerChange = (m_slicePrefetch > 0) != (depth > 0);
+	m_slicePrefetch = depth;
+
+	if (ui.YZView) ui.YZView->setSlicePrefetch(depth);
+	if (ui.XZView) ui.XZView->setSlicePrefetch(depth);
+	if (ui.XYView) ui.XYView->setSlicePrefetch(depth);
+
+	// Plain images switch between direct slicing and an ImageSliceProvider; nothing is reloaded
+	if (providerChange && !m_brickedSlicing) replaceSliceProviders();
+}
+
+void LightboxWidget::setInteractionLod(bool enabled)
+{
+	if (auto* yz = getYZView()) yz->setInteractionLod(enabled);
+	if (auto* xz = getXZView()) xz->setInteractionLod(enabled);
+	if (auto* xy = getXYView()) xy->setInteractionLod(enabled);
+}
+
+void LightboxWidget::setCpuCompositing(bool enabled)
+{
+	if (auto* yz = getYZView()) yz->setCpuCompositing(enabled);
+	if (auto* xz = getXZView()) xz->setCpuCompositing(enabled);
+	if (auto* xy = getXYView()) xy->setCpuCompositing(enabled);
+}
+
+void LightboxWidget::setLabelMap(vtkImageData* labels)
+{
+	m_labelMap = labels;
+	for (SliceView* view : { ui.YZView, ui.XZView, ui.XYView }) {
+		if (view) view->setLabelOverlay(labels, m_labelPalette.lookupTable());
+	}
+}
+
+bool LightboxWidget::setThresholdOverlay(double lower, double upper)
+{
+	// Compressed volumes keep only a downsampled image; threshold their bricks instead
+	if (m_compressedVolume) {
+		vtkSmartPointer<vtkImageData> labels = thresholdMask(*m_compressedVolume, lower, upper);
+		if (!labels) return false;
+		setLabelMap(labels);
+		return true;
+	}
+
+	vtkImageData* image = ui.volumeView ? ui.volumeView->imageData() : nullptr;
+	vtkDataArray* scalars = image ? image->GetPointData()->GetScalars() : nullptr;
+	if (!scalars) return false;
+
+	auto labels = vtkSmartPointer<vtkImageData>::New();
+	labels->SetExtent(image->GetExtent());
+	labels->SetSpacing(image->GetSpacing());
+	labels->SetOrigin(image->GetOrigin());
+	labels->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+
+	// The threshold mask (1 inside, 0 outside) is label 1 as is
+	auto* mask = static_cast<unsigned char*>(labels->GetScalarPointer());
+	const int stride = scalars->GetNumberOfComponents();
+	const bool known = VolumeKernels::dispatch(scalars->GetDataType(), [&](auto tag) {
+		using T = VolumeKernels::ValueType<decltype(tag)>;
+		VolumeKernels::threshold(static_cast<const T*>(scalars->GetVoidPointer(0)), scalars->GetNumberOfTuples(),
+			stride, lower, upper, mask);
+	});
+	if (!known) return false;
+
+	setLabelMap(labels);
+	return true;
+}
+
+void LightboxWidget::refreshLabelOverlay()
+{
+	if (!m_labelMap) return;
+	for (SliceView* view : { ui.YZView, ui.XZView, ui.XYView }) {
+		if (view) view->render();
+	}
+}
+
+void LightboxWidget::setMosaicMode(bool on)
+{
+	if (m_mosaicMode == on) return;
+	m_mosaicMode = on;
+
+	if (on && !m_mosaicView) {
+		m_mosaicView = new MosaicView(this);
+		if (auto* vol = getVolumeView()) {
+			m_mosaicView->setDisplayMode(vol->displayMode());
+			m_mosaicView->setAutoWindowPercentiles(vol->autoWindowLowPercent(), vol->autoWindowHighPercent());
+		}
+		ui.gridLayout->addWidget(m_mosaicView, 0, 0, 2, 2);
+
+		// Mosaic-driven WL updates the slices and the volume like a slice view does
+		connect(m_mosaicView, &MosaicView::windowLevelChanged, this, [this](double w, double l) {
+			if (m_propagatingWindowLevel) return;
+			m_propagatingWindowLevel = true;
+
+			if (m_wlBridge) m_wlBridge->onWindowLevelFromSlice(w, l);
+			if (auto* yz = getYZView()) yz->setWindowLevelNative(w, l);
+			if (auto* xz = getXZView()) xz->setWindowLevelNative(w, l);
+			if (auto* xy = getXYView()) xy->setWindowLevelNative(w, l);
+
+			m_propagatingWindowLevel = false;
+		}, Qt::UniqueConnection);
+	}
+	if (on && ui.volumeView && ui.volumeView->imageData() && m_mosaicView->imageData() != ui.volumeView->imageData()) {
+		vtkSmartPointer<vtkImageData> image = ui.volumeView->imageData();
+		m_mosaicView->setImageData(image);
+	}
+
+	// The frames keep their own state (including a maximized frame) while hidden
+	const std::array<SelectionFrameWidget*, 4> frames{ { ui.YZView, ui.XZView, ui.XYView, ui.volumeView } };
+	for (auto* f : frames) {
+		if (!f) continue;
+		f->setVisible(!on && (!m_isMaximized || f == m_maximized));
+	}
+	if (m_mosaicView) {
+		m_mosaicView->setVisible(on);
+		if (on) m_mosaicView->setSelected(true);
+	}
+}
+
+bool LightboxWidget::setCurvedReformatMode(bool on)
+{
+	if (m_curvedReformatMode == on) return true;
+
+	if (on && !m_reformatView) {
+		// A window of its own, so all four frames stay available for drawing the path
+		m_reformatView = new CurvedReformatView(this);
+		m_reformatView->setWindowFlag(Qt::Window);
+		m_reformatView->resize(800, 400);
+		connect(m_reformatView, &CurvedReformatView::closed, this, [this]() { setCurvedReformatMode(false); });
+
+		// Reformat-driven WL updates the slices and the volume like the mosaic does
+		connect(m_reformatView, &CurvedReformatView::windowLevelChanged, this, [this](double w, double l) {
+			if (m_propagatingWindowLevel) return;
+			m_propagatingWindowLevel = true;
+
+			if (m_wlBridge) m_wlBridge->onWindowLevelFromSlice(w, l);
+			if (auto* yz = getYZView()) yz->setWindowLevelNative(w, l);
+			if (auto* xz = getXZView()) xz->setWindowLevelNative(w, l);
+			if (auto* xy = getXYView()) xy->setWindowLevelNative(w, l);
+
+			m_propagatingWindowLevel = false;
+		});
+	}
+	if (on && !applyReformatVolume()) return false;
+
+	m_curvedReformatMode = on;
+	for (SliceView* view : { ui.YZView, ui.XZView, ui.XYView }) {
+		if (view) view->setPathTool(on);
+	}
+	m_reformatView->setVisible(on);
+	emit curvedReformatModeChanged(on);
+	return true;
+}
+
+bool LightboxWidget::applyReformatVolume()
+{
+	VolumeView* vol = getVolumeView();
+	vtkImageData* image = vol ? vol->imageData() : nullptr;
+	if (!image || !m_reformatView) return false;
+
+	// Outside the volume reads as the darkest value; WL starts from the shared baseline.
+	// Compressed volumes are sampled from their bricks, not from the downsampled preview.
+	if (m_compressedVolume) m_reformatView->setVolume(m_compressedVolume, vol->scalarRangeMin());
+	else m_reformatView->setVolume(image, vol->scalarRangeMin());
+	m_reformatView->setBaselineWindowLevel(vol->baselineWindowNative(), vol->baselineLevelNative());
+	m_reformatView->setWindowLevelNative(vol->baselineWindowNative(), vol->baselineLevelNative());
+	m_reformatView->setPath(m_path);
+	return true;
+}
+
+bool LightboxWidget::nativeDisplay() const
+{
+	if (auto* vol = getVolumeView()) return vol->displayMode() == ImageFrameWidget::DisplayNative;
+	return false;
+}
+
+void LightboxWidget::autoWindowLevel()
+{
+	auto* vol = getVolumeView();
+	if (!vol || !vol->imageData() || m_propagatingWindowLevel) return;
+
+	// Percentiles come from the cached histogram, so this is instant regardless of volume size
+	const auto [lower, upper] = vol->autoWindowBounds();
+	if (!(upper > lower)) return;
+	const double w = upper - lower;
+	const double l = 0.5 * (upper + lower);
+
+	m_propagatingWindowLevel = true;
+
+	if (m_wlController) {
+		m_wlController->setWindow(w);
+		m_wlController->setLevel(l);
+	}
+	if (m_wlBridge) m_wlBridge->onWindowLevelChanged(w, l);
+	vol->setSliceWindowLevelNative(w, l);
+
+	if (auto* yz = getYZView()) yz->setWindowLevelNative(w, l);
+	if (auto* xz = getXZView()) xz->setWindowLevelNative(w, l);
+	if (auto* xy = getXYView()) xy->setWindowLevelNative(w, l);
+	if (m_mosaicView) m_mosaicView->setWindowLevelNative(w, l);
+	if (m_reformatView) m_reformatView->setWindowLevelNative(w, l);
+
+	m_propagatingWindowLevel = false;
+}
+
+void LightboxWidget::setAutoWindowPercentiles(double lowPercent, double highPercent)
+{
+	if (auto* yz = getYZView()) yz->setAutoWindowPercentiles(lowPercent, highPercent);
+	if (auto* xz = getXZView()) xz->setAutoWindowPercentiles(lowPercent, highPercent);
+	if (auto* xy = getXYView()) xy->setAutoWindowPercentiles(lowPercent, highPercent);
+	if (auto* vol = getVolumeView()) vol->setAutoWindowPercentiles(lowPercent, highPercent);
+	if (m_mosaicView) m_mosaicView->setAutoWindowPercentiles(lowPercent, highPercent);
+}
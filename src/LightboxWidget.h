@@ -2,12 +2,23 @@
 
 #include <QWidget>
 #include "ui_LightboxWidget.h"
+#include "LabelPalette.h"
+#include "CurvedReformat.h"
 #include <QHash>
 #include <QList>
 #include <QParallelAnimationGroup>
 
+#include <memory>
+#include <vector>
+
+class CompressedVolume;
+class CursorModel;
+class CurvedReformatView;
+class MosaicView;
+class SliceProvider;
 class SliceView;
 class VolumeView;
+class FrameThrottle;
 class SelectionFrameWidget;
 class WindowLevelController;
 class WindowLevelBridge;
@@ -24,6 +35,12 @@ public:
 	explicit LightboxWidget(QWidget* parent = nullptr);
 
 	void setImageData(vtkImageData* image);
+	// Show a compressed volume: the slice views decode full-resolution slices on demand,
+	// the volume view renders a downsampled preview
+	void setCompressedVolume(std::shared_ptr<CompressedVolume> volume);
+	std::shared_ptr<CompressedVolume> compressedVolume() const { return m_compressedVolume; }
+	// Sampling step of the volume view's (and the mosaic's) preview of a compressed volume; 1 otherwise
+	int previewDownsampleFactor() const { return m_volumeIndexDivisor; }
 	void setDefaultImage();
 
 	void setYZSlice(int index);
@@ -45,12 +62,55 @@ protected:
 public slots:
 	void setLinkedWindowLevel(bool linked);
 	bool linkedWindowLevel() const { return m_linkWindowLevel; }
+	bool nativeDisplay() const;
 	// Propagate a reset request to all child image frames (slices + volume)
 	void resetWindowLevel();
+	// Render native scalars directly in all frames (true) or via the 16-bit mapped copy (false)
+	void setNativeDisplay(bool native);
+	// Slice from a bricked copy of the image so all three orientations read contiguous
+	// memory (costs one extra copy of the volume); re-applies the current image
+	void setBrickedSlicing(bool bricked);
+	bool brickedSlicing() const { return m_brickedSlicing; }
+	// Prefetch `depth` slices ahead of each slice view on a worker thread (0 disables);
+	// plain images are then sliced through a provider too. Re-applies the current image.
+	void setSlicePrefetch(int depth);
+	int slicePrefetch() const { return m_slicePrefetch; }
+	// Fast filtering in the slice views while interacting, full quality when idle
+	void setInteractionLod(bool enabled);
+	// Window/level the slice views on the CPU and upload ready RGBA (for software OpenGL)
+	void setCpuCompositing(bool enabled);
+	// Label overlay in the slice views: `labels` is uint8 with the slice views' geometry
+	// (nullptr removes it), coloured through labelPalette()
+	void setLabelMap(vtkImageData* labels);
+	vtkImageData* labelMap() const { return m_labelMap; }
+	// Overlay label 1 where the current image lies in [lower, upper] (native values);
+	// compressed volumes are thresholded brick by brick at full resolution. False when
+	// there is no image or the mask cannot be allocated.
+	bool setThresholdOverlay(double lower, double upper);
+	LabelPalette& labelPalette() { return m_labelPalette; }
+	// Redraw the overlays after editing the palette
+	void refreshLabelOverlay();
+	// Replace the four frames by one mosaic of evenly spaced slices (single render window)
+	void setMosaicMode(bool on);
+	bool mosaicMode() const { return m_mosaicMode; }
+	// Curved MPR: the slice views edit one shared path with their Curved Path tool and a
+	// separate window shows the volume straightened along it, across the axis of the view
+	// the path was started in; compressed volumes are sampled through their brick cache.
+	// False when no image is loaded.
+	bool setCurvedReformatMode(bool on);
+	bool curvedReformatMode() const { return m_curvedReformatMode; }
+	// Apply the percentile window/level of the current image to all frames and the controller
+	void autoWindowLevel();
+	// Percentiles for the automatic and initial window/level of all frames (applies to the next image)
+	void setAutoWindowPercentiles(double lowPercent, double highPercent);
 
 signals:
 	// Notify when linked window/level mode toggles
 	void linkedWindowLevelChanged(bool linked);
+	// Voxel probe of whichever slice view the mouse is over (full-resolution indices, native value)
+	void voxelProbed(int x, int y, int z, double value);
+	void probeLeft();
+	void curvedReformatModeChanged(bool on);
 
 private slots:
 	// Handle maximize/restore requests from child frames
@@ -59,6 +119,16 @@ private slots:
 
 private:
 	void connectSliceSynchronization();
+	// Forward image data to all frames and the controller
+	void applyImageData(vtkImageData* image);
+	// Provider the slice views read `image` through for the current options (null: slice it directly)
+	std::shared_ptr<SliceProvider> sliceProviderFor(vtkImageData* image) const;
+	// Swap the slice views' provider after an option change, without reloading the image
+	void replaceSliceProviders();
+	// Push the cursor to the volume view's planes (in preview indices)
+	void syncVolumeSlicePlanes();
+	// Point the reformat at the full-resolution image or compressed volume; false if there is none
+	bool applyReformatVolume();
 	void connectSelectionCoordination();
 	void connectMaximizeSignals();
 
@@ -90,6 +160,33 @@ private:
 	WindowLevelController* m_wlController = nullptr;
 	WindowLevelBridge* m_wlBridge = nullptr;
 
+	// Compressed volume shown in the slice views and the preview's index mapping:
+	// preview index = (slice index - m_sliceIndexOrigin[axis]) / m_volumeIndexDivisor
+	std::shared_ptr<CompressedVolume> m_compressedVolume;
+	int m_volumeIndexDivisor = 1;
+	int m_sliceIndexOrigin[3] = { 0, 0, 0 };
+
+	bool m_brickedSlicing = false;
+	bool m_mosaicMode = false;
+	// Created on first use; shows the image the volume view shows
+	MosaicView* m_mosaicView = nullptr;
+	int m_slicePrefetch = 0;
+
+	// Curved MPR window (created on first use) and the path shared by the slice views
+	bool m_curvedReformatMode = false;
+	CurvedReformatView* m_reformatView = nullptr;
+	std::vector<CurvedReformat::Point> m_path;
+
+	// Shared crosshair position; drives the slice views' indices and the volume planes
+	CursorModel* m_cursor = nullptr;
+
+	// Label overlay shown in the three slice views
+	vtkSmartPointer<vtkImageData> m_labelMap;
+	LabelPalette m_labelPalette;
+
+	// Paces syncVolumeSlicePlanes() to the display refresh
+	FrameThrottle* m_volumePlanesThrottle = nullptr;
+
 	// Guard to prevent feedback loops while propagating WL changes
 	bool m_propagatingWindowLevel = false;
 };
@@ -0,0 +1,224 @@
+#include "LineProfile.h"
+#include "SliceProvider.h"
+#include "VolumeKernels.h"
+
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	// Catmull-Rom weights for the four taps around a sample at fraction f
+	inline void cubicWeights(float f, float w[4])
+	{
+		const float f2 = f * f;
+		const float f3 = f2 * f;
+		w[0] = 0.5f * (-f3 + 2.0f * f2 - f);
+		w[1] = 0.5f * (3.0f * f3 - 5.0f * f2 + 2.0f);
+		w[2] = 0.5f * (-3.0f * f3 + 4.0f * f2 + f);
+		w[3] = 0.5f * (f3 - f2);
+	}
+
+	// The loops below index with int so the compiler can gather; a slice has well under
+	// 2^31 pixels. Positions are clamped to the slice, so samples past an edge repeat it.
+	void sampleNearest(const float* pixels, int width, int height, const float* u, const float* v, float* out,
+		vtkIdType begin, vtkIdType end)
+	{
+		const float maxU = static_cast<float>(width - 1);
+		const float maxV = static_cast<float>(height - 1);
+		for (vtkIdType i = begin; i < end; ++i) {
+			const int x = static_cast<int>(std::clamp(u[i], 0.0f, maxU) + 0.5f);
+			const int y = static_cast<int>(std::clamp(v[i], 0.0f, maxV) + 0.5f);
+			out[i] = pixels[y * width + x];
+		}
+	}
+
+	void sampleLinear(const float* pixels, int width, int height, const float* u, const float* v, float* out,
+		vtkIdType begin, vtkIdType end)
+	{
+		const float maxU = static_cast<float>(width - 1);
+		const float maxV = static_cast<float>(height - 1);
+		const int lastX = std::max(width - 2, 0);
+		const int lastY = std::max(height - 2, 0);
+		const int stepX = width > 1 ? 1 : 0;
+		const int stepY = height > 1 ? width : 0;
+		for (vtkIdType i = begin; i < end; ++i) {
+			const float x = std::clamp(u[i], 0.0f, maxU);
+			const float y = std::clamp(v[i], 0.0f, maxV);
+			const int x0 = std::min(static_cast<int>(x), lastX);
+			const int y0 = std::min(static_cast<int>(y), lastY);
+			const float fx = x - static_cast<float>(x0);
+			const float fy = y - static_cast<float>(y0);
+			const int at = y0 * width + x0;
+			const float top = pixels[at] + fx * (pixels[at + stepX] - pixels[at]);
+			const float bottom = pixels[at + stepY] + fx * (pixels[at + stepY + stepX] - pixels[at + stepY]);
+			out[i] = top + fy * (bottom - top);
+		}
+	}
+
+	void sampleCubic(const float* pixels, int width, int height, const float* u, const float* v, float* out,
+		vtkIdType begin, vtkIdType end)
+	{
+		const float maxU = static_cast<float>(width - 1);
+		const float maxV = static_cast<float>(height - 1);
+		for (vtkIdType i = begin; i < end; ++i) {
+			const float x = std::clamp(u[i], 0.0f, maxU);
+			const float y = std::clamp(v[i], 0.0f, maxV);
+			const int x0 = static_cast<int>(x);
+			const int y0 = static_cast<int>(y);
+			float wx[4];
+			float wy[4];
+			cubicWeights(x - static_cast<float>(x0), wx);
+			cubicWeights(y - static_cast<float>(y0), wy);
+			float sum = 0.0f;
+			for (int r = 0; r < 4; ++r) {
+				const int row = std::clamp(y0 + r - 1, 0, height - 1) * width;
+				float acc = 0.0f;
+				for (int c = 0; c < 4; ++c) acc += wx[c] * pixels[row + std::clamp(x0 + c - 1, 0, width - 1)];
+				sum += wy[r] * acc;
+			}
+			out[i] = sum;
+		}
+	}
+}
+
+LineProfile::LineProfile(std::shared_ptr<SliceProvider> provider)
+	: m_provider(std::move(provider))
+{
+}
+
+LineProfile::~LineProfile() = default;
+
+void LineProfile::setBandWidth(int lines)
+{
+	m_band = std::max(1, lines | 1);
+}
+
+void LineProfile::setStep(double voxels)
+{
+	if (voxels > 0.0) m_step = voxels;
+}
+
+bool LineProfile::fetchSlice(int axis, int index)
+{
+	if (axis == m_axis && index == m_index) return true;
+	m_axis = -1;
+	m_pixels.clear();
+	if (!m_provider) return false;
+
+	vtkNew<vtkImageData> slice;
+	if (!m_provider->extractSlice(axis, index, slice)) return false;
+
+	int ext[6];
+	slice->GetExtent(ext);
+	double spacing[3];
+	slice->GetSpacing(spacing);
+	const int u = axis == 0 ? 1 : 0;
+	const int v = axis == 2 ? 1 : 2;
+	const int width = ext[2 * u + 1] - ext[2 * u] + 1;
+	const int height = ext[2 * v + 1] - ext[2 * v] + 1;
+	if (width <= 0 || height <= 0) return false;
+
+	// First component only; the slice is one voxel thick, so it is contiguous with u fastest
+	const vtkIdType n = static_cast<vtkIdType>(width) * height;
+	const int stride = slice->GetNumberOfScalarComponents();
+	m_pixels.resize(static_cast<std::size_t>(n));
+	float* pixels = m_pixels.data();
+	const bool known = VolumeKernels::dispatch(slice->GetScalarType(), [&](auto tag) {
+		using T = VolumeKernels::ValueType<decltype(tag)>;
+		const T* in = static_cast<const T*>(slice->GetScalarPointer());
+		vtkSMPTools::For(0, n, VolumeKernels::Grain, [&](vtkIdType begin, vtkIdType end) {
+			for (vtkIdType i = begin; i < end; ++i) pixels[i] = static_cast<float>(in[i * stride]);
+		});
+	});
+	if (!known) {
+		m_pixels.clear();
+		return false;
+	}
+
+	m_axis = axis;
+	m_index = index;
+	m_width = width;
+	m_height = height;
+	m_spacing[0] = spacing[u];
+	m_spacing[1] = spacing[v];
+	m_extentOffset[0] = ext[2 * u];
+	m_extentOffset[1] = ext[2 * v];
+	return true;
+}
+
+LineProfile::Result LineProfile::sample(int axis, const double p0[3], const double p1[3])
+{
+	Result result;
+	if (axis < 0 || axis > 2) return result;
+	if (!fetchSlice(axis, static_cast<int>(std::lround(p0[axis])))) return result;
+
+	const int u = axis == 0 ? 1 : 0;
+	const int v = axis == 2 ? 1 : 2;
+	const double startU = p0[u] - m_extentOffset[0];
+	const double startV = p0[v] - m_extentOffset[1];
+	const double du = p1[u] - p0[u];
+	const double dv = p1[v] - p0[v];
+
+	// Steps and band offsets are in world units, so anisotropic pixels sample evenly
+	const double worldU = du * m_spacing[0];
+	const double worldV = dv * m_spacing[1];
+	const double length = std::sqrt(worldU * worldU + worldV * worldV);
+	const double unit = std::min(m_spacing[0], m_spacing[1]);
+	const int count = length > 0.0 ? static_cast<int>(std::ceil(length / (m_step * unit))) + 1 : 1;
+	result.length = length;
+	result.step = count > 1 ? length / (count - 1) : 0.0;
+
+	// Unit normal in world units, as an index offset per voxel of band
+	double normalU = 0.0;
+	double normalV = 0.0;
+	if (length > 0.0) {
+		normalU = -worldV / length * unit / m_spacing[0];
+		normalV = worldU / length * unit / m_spacing[1];
+	}
+
+	const std::size_t total = static_cast<std::size_t>(count) * m_band;
+	m_u.resize(total);
+	m_v.resize(total);
+	m_samples.resize(total);
+	const double t = count > 1 ? 1.0 / (count - 1) : 0.0;
+	for (int b = 0; b < m_band; ++b) {
+		const double offset = b - (m_band - 1) / 2;
+		const double originU = startU + offset * normalU;
+		const double originV = startV + offset * normalV;
+		float* lineU = m_u.data() + static_cast<std::size_t>(b) * count;
+		float* lineV = m_v.data() + static_cast<std::size_t>(b) * count;
+		for (int i = 0; i < count; ++i) {
+			lineU[i] = static_cast<float>(originU + i * t * du);
+			lineV[i] = static_cast<float>(originV + i * t * dv);
+		}
+	}
+
+	const float* pixels = m_pixels.data();
+	const float* posU = m_u.data();
+	const float* posV = m_v.data();
+	float* samples = m_samples.data();
+	const int width = m_width;
+	const int height = m_height;
+	const Interpolation interpolation = m_interpolation;
+	vtkSMPTools::For(0, static_cast<vtkIdType>(total), 4096, [&](vtkIdType begin, vtkIdType end) {
+		switch (interpolation) {
+		case Nearest: sampleNearest(pixels, width, height, posU, posV, samples, begin, end); break;
+		case Linear: sampleLinear(pixels, width, height, posU, posV, samples, begin, end); break;
+		case Cubic: sampleCubic(pixels, width, height, posU, posV, samples, begin, end); break;
+		}
+	});
+
+	result.values.assign(samples, samples + count);
+	for (int b = 1; b < m_band; ++b) {
+		const float* line = samples + static_cast<std::size_t>(b) * count;
+		for (int i = 0; i < count; ++i) result.values[i] += line[i];
+	}
+	if (m_band > 1) {
+		const float norm = 1.0f / static_cast<float>(m_band);
+		for (float& value : result.values) value *= norm;
+	}
+	return result;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+class SliceProvider;
+
+// Intensity profile along a segment of one slice, sampled from native scalars.
+//
+// The slice is extracted once from the provider and kept as floats; moving the segment
+// on the same slice only resamples. Sample positions are laid out first (all band lines,
+// struct-of-arrays) and then interpolated in one branch-free loop, which the compiler
+// vectorizes, so resampling keeps up with a dragged endpoint on large slices.
+class LineProfile
+{
+public:
+	enum Interpolation { Nearest, Linear, Cubic };
+
+	struct Result
+	{
+		std::vector<float> values; // one per sample, averaged across the band
+		double step = 0.0;         // world distance between samples
+		double length = 0.0;       // world length of the segment
+	};
+
+	explicit LineProfile(std::shared_ptr<SliceProvider> provider);
+	~LineProfile();
+
+	LineProfile(const LineProfile&) = delete;
+	LineProfile& operator=(const LineProfile&) = delete;
+
+	void setInterpolation(Interpolation interpolation) { m_interpolation = interpolation; }
+	Interpolation interpolation() const { return m_interpolation; }
+	// Parallel lines averaged across the segment, one voxel apart (odd, >= 1)
+	void setBandWidth(int lines);
+	int bandWidth() const { return m_band; }
+	// Sample spacing as a fraction of the smaller in-plane voxel size
+	void setStep(double voxels);
+
+	// Profile from p0 to p1 (continuous voxel indices; p0[axis] is the slice) on the slice
+	// `p0[axis]` of `axis`. Empty if the provider cannot supply the slice.
+	Result sample(int axis, const double p0[3], const double p1[3]);
+
+private:
+	bool fetchSlice(int axis, int index);
+
+	std::shared_ptr<SliceProvider> m_provider;
+	Interpolation m_interpolation = Linear;
+	int m_band = 1;
+	double m_step = 0.25;
+
+	// Current slice as floats, u fastest
+	int m_axis = -1;
+	int m_index = 0;
+	int m_width = 0;
+	int m_height = 0;
+	int m_extentOffset[2] = { 0, 0 };
+	double m_spacing[2] = { 1.0, 1.0 };
+	std::vector<float> m_pixels;
+
+	// Sample positions, reused between calls
+	std::vector<float> m_u;
+	std::vector<float> m_v;
+	std::vector<float> m_samples;
+};
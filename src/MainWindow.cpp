@@ -2,11 +2,21 @@
 #include "ui_MainWindow.h"
 
 #include "LightboxWidget.h"
+#include "VolumeView.h"
 #include "ImageLoader.h"
+#include "CompressedVolume.h"
+#include "VolumeAllocator.h"
 #include "WindowLevelController.h"
 #include "WindowLevelBridge.h"
 
 #include <QFileDialog>
+#include <QActionGroup>
+#include <QColorDialog>
+#include <QInputDialog>
+#include <QMenu>
+#include <QMenuBar>
+#include <QStatusBar>
+#include <QSignalBlocker>
 #include <QMessageBox>
 #include <QSettings>
 #include <QKeyEvent>
@@ -25,6 +35,8 @@
 #include <QSurfaceFormat>
 #include <QOpenGLFunctions>
 
+#include <algorithm>
+
 #include <vtkVersion.h>   // VTK version macros
 #include <vtkEventQtSlotConnect.h>
 
@@ -39,6 +51,9 @@
 using ImageType = itk::Image<short, 3>;
 
 namespace {
+	// Slices kept ready ahead of each slice view when prefetch is on
+	constexpr int kSlicePrefetchDepth = 8;
+
 	QString queryOpenGLSummary()
 	{
 		QSurfaceFormat fmt;
@@ -80,6 +95,15 @@ MainWindow::MainWindow(QWidget* parent)
 
 	statusBar()->addPermanentWidget(progressBar);
 
+	// Voxel probe readout; updating a label does not re-render the views
+	probeLabel = new QLabel(this);
+	probeLabel->setMinimumWidth(fontMetrics().horizontalAdvance(QStringLiteral("(00000, 00000, 00000) = -0.000000e+00")));
+	statusBar()->addPermanentWidget(probeLabel);
+	connect(ui->lightboxWidget, &LightboxWidget::voxelProbed, this, [this](int x, int y, int z, double value) {
+		probeLabel->setText(QStringLiteral("(%1, %2, %3) = %4").arg(x).arg(y).arg(z).arg(value, 0, 'g', 7));
+	});
+	connect(ui->lightboxWidget, &LightboxWidget::probeLeft, probeLabel, &QLabel::clear);
+
 	// Connect menu actions to slots
 	connect(ui->actionOpen, &QAction::triggered, this, &MainWindow::onActionOpen);
 	connect(ui->actionSave, &QAction::triggered, this, &MainWindow::onActionSave);
@@ -105,9 +129,255 @@ MainWindow::MainWindow(QWidget* parent)
 
 	setupPanelConnections();
 
+	createOptionsMenu();
+
 	loadRecentFiles();
 }
 
+void MainWindow::createOptionsMenu()
+{
+	QMenu* menuOptions = new QMenu(tr("Options"), this);
+	menuBar()->insertMenu(ui->menuHelp->menuAction(), menuOptions);
+
+	createLoadingOptions(menuOptions);
+	menuOptions->addSeparator();
+	createDisplayOptions(menuOptions);
+	menuOptions->addSeparator();
+	createAnalysisOptions(menuOptions);
+}
+
+void MainWindow::createLoadingOptions(QMenu* menuOptions)
+{
+	// Options > Resample to Isotropic: exclusive choice of kernel, persisted across sessions
+	QMenu* menuResample = menuOptions->addMenu(tr("Resample to Isotropic"));
+	auto* group = new QActionGroup(this);
+	group->setExclusive(true);
+
+	struct KernelItem { QString label; ImageLoader::ResampleKernel kernel; };
+	const KernelItem items[] = {
+		{ tr("Off"), ImageLoader::ResampleKernel::None },
+		{ tr("Linear"), ImageLoader::ResampleKernel::Linear },
+		{ tr("Cubic"), ImageLoader::ResampleKernel::Cubic },
+		{ tr("Windowed Sinc"), ImageLoader::ResampleKernel::WindowedSinc }
+	};
+
+	QSettings settings("CTAnalyzerX", "Loading");
+	const int saved = settings.value("resampleKernel", static_cast<int>(ImageLoader::ResampleKernel::None)).toInt();
+
+	for (const KernelItem& item : items) {
+		QAction* action = menuResample->addAction(item.label);
+		action->setCheckable(true);
+		group->addAction(action);
+		const ImageLoader::ResampleKernel kernel = item.kernel;
+		if (static_cast<int>(kernel) == saved) {
+			action->setChecked(true);
+			imageLoader->SetResampleKernel(kernel);
+		}
+		connect(action, &QAction::triggered, this, [this, kernel]() {
+			imageLoader->SetResampleKernel(kernel);
+			QSettings settings("CTAnalyzerX", "Loading");
+			settings.setValue("resampleKernel", static_cast<int>(kernel));
+		});
+	}
+
+	// Options > Compressed Storage: keep large volumes bit-packed in memory, decode slices on demand
+	QAction* actionCompressed = menuOptions->addAction(tr("Compressed Storage (large volumes)"));
+	actionCompressed->setCheckable(true);
+	actionCompressed->setChecked(settings.value("compressedStorage", false).toBool());
+	connect(actionCompressed, &QAction::toggled, this, [](bool on) {
+		QSettings settings("CTAnalyzerX", "Loading");
+		settings.setValue("compressedStorage", on);
+	});
+
+	// Options > Compressed Cache Size: decoded-brick cache of compressed volumes (0 = sized
+	// from the volume's brick layers)
+	QAction* actionCompressedCache = menuOptions->addAction(tr("Compressed Cache Size..."));
+	connect(actionCompressedCache, &QAction::triggered, this, [this]() {
+		QSettings settings("CTAnalyzerX", "Loading");
+		bool ok = false;
+		const int megabytes = QInputDialog::getInt(this, tr("Compressed Cache Size"),
+			tr("Decoded brick cache (MB, 0 = automatic):"), settings.value("compressedCacheMB", 0).toInt(),
+			0, 1 << 20, 256, &ok);
+		if (!ok) return;
+		settings.setValue("compressedCacheMB", megabytes);
+		if (auto volume = ui->lightboxWidget->compressedVolume()) {
+			volume->setCacheBudgetBytes(static_cast<std::size_t>(megabytes) << 20);
+		}
+	});
+
+	// Options > Huge-Page Volume Memory: aligned, THP-backed, NUMA-spread buffers for large volumes
+	QAction* actionAllocator = menuOptions->addAction(tr("Huge-Page Volume Memory"));
+	actionAllocator->setCheckable(true);
+	const bool allocator = settings.value("volumeAllocator", false).toBool();
+	actionAllocator->setChecked(allocator);
+	VolumeAllocator::setEnabled(allocator);
+	connect(actionAllocator, &QAction::toggled, this, [](bool on) {
+		VolumeAllocator::setEnabled(on);
+		QSettings settings("CTAnalyzerX", "Loading");
+		settings.setValue("volumeAllocator", on);
+	});
+}
+
+void MainWindow::createDisplayOptions(QMenu* menuOptions)
+{
+	// Options > Auto Window/Level: percentile presets for the initial and "Auto" window/level
+	QMenu* menuAutoWL = menuOptions->addMenu(tr("Auto Window/Level"));
+	auto* autoGroup = new QActionGroup(this);
+	autoGroup->setExclusive(true);
+
+	struct PercentileItem { double low; double high; };
+	const PercentileItem presets[] = { { 0.1, 99.9 }, { 0.5, 99.5 }, { 1.0, 99.0 }, { 2.0, 98.0 } };
+
+	QSettings settings("CTAnalyzerX", "Display");
+	const double savedLow = settings.value("autoWindowLow", 0.5).toDouble();
+	const double savedHigh = settings.value("autoWindowHigh", 99.5).toDouble();
+	ui->lightboxWidget->setAutoWindowPercentiles(savedLow, savedHigh);
+
+	for (const PercentileItem& item : presets) {
+		QAction* action = menuAutoWL->addAction(tr("%1% - %2%").arg(item.low).arg(item.high));
+		action->setCheckable(true);
+		autoGroup->addAction(action);
+		if (item.low == savedLow && item.high == savedHigh) action->setChecked(true);
+		const double low = item.low;
+		const double high = item.high;
+		connect(action, &QAction::triggered, this, [this, low, high]() {
+			ui->lightboxWidget->setAutoWindowPercentiles(low, high);
+			ui->lightboxWidget->autoWindowLevel();
+			QSettings settings("CTAnalyzerX", "Display");
+			settings.setValue("autoWindowLow", low);
+			settings.setValue("autoWindowHigh", high);
+		});
+	}
+
+	// Options > Bricked Slicing: cache-friendly layout for YZ/XZ scrubbing
+	QAction* actionBricked = menuOptions->addAction(tr("Bricked Slicing Layout"));
+	actionBricked->setCheckable(true);
+	const bool bricked = settings.value("brickedSlicing", false).toBool();
+	actionBricked->setChecked(bricked);
+	ui->lightboxWidget->setBrickedSlicing(bricked);
+	connect(actionBricked, &QAction::toggled, this, [this](bool on) {
+		ui->lightboxWidget->setBrickedSlicing(on);
+		QSettings settings("CTAnalyzerX", "Display");
+		settings.setValue("brickedSlicing", on);
+	});
+
+	// Options > Slice Prefetch: extract the slices ahead of scrolling on a worker thread
+	QAction* actionPrefetch = menuOptions->addAction(tr("Prefetch Slices While Scrolling"));
+	actionPrefetch->setCheckable(true);
+	const bool prefetch = settings.value("slicePrefetch", false).toBool();
+	actionPrefetch->setChecked(prefetch);
+	ui->lightboxWidget->setSlicePrefetch(prefetch ? kSlicePrefetchDepth : 0);
+	connect(actionPrefetch, &QAction::toggled, this, [this](bool on) {
+		ui->lightboxWidget->setSlicePrefetch(on ? kSlicePrefetchDepth : 0);
+		QSettings settings("CTAnalyzerX", "Display");
+		settings.setValue("slicePrefetch", on);
+	});
+
+	// Options > Native Display: render native scalars instead of a 16-bit mapped copy per view
+	QAction* actionNative = menuOptions->addAction(tr("Native Display (no 16-bit copy)"));
+	actionNative->setCheckable(true);
+	const bool native = settings.value("nativeDisplay", false).toBool();
+	actionNative->setChecked(native);
+	ui->lightboxWidget->setNativeDisplay(native);
+	connect(actionNative, &QAction::toggled, this, [this](bool on) {
+		ui->lightboxWidget->setNativeDisplay(on);
+		QSettings settings("CTAnalyzerX", "Display");
+		settings.setValue("nativeDisplay", on);
+	});
+
+	// Options > Interaction LOD: cheap filtering while dragging, refined when the view is idle
+	QAction* actionLod = menuOptions->addAction(tr("Fast Filtering While Interacting"));
+	actionLod->setCheckable(true);
+	const bool lod = settings.value("interactionLod", false).toBool();
+	actionLod->setChecked(lod);
+	ui->lightboxWidget->setInteractionLod(lod);
+	connect(actionLod, &QAction::toggled, this, [this](bool on) {
+		ui->lightboxWidget->setInteractionLod(on);
+		QSettings settings("CTAnalyzerX", "Display");
+		settings.setValue("interactionLod", on);
+	});
+
+	// Options > CPU Slice Compositing: window/level to RGBA on the CPU, for software OpenGL hosts
+	QAction* actionCompositing = menuOptions->addAction(tr("CPU Slice Compositing"));
+	actionCompositing->setCheckable(true);
+	const bool compositing = settings.value("cpuCompositing", false).toBool();
+	actionCompositing->setChecked(compositing);
+	ui->lightboxWidget->setCpuCompositing(compositing);
+	connect(actionCompositing, &QAction::toggled, this, [this](bool on) {
+		ui->lightboxWidget->setCpuCompositing(on);
+		QSettings settings("CTAnalyzerX", "Display");
+		settings.setValue("cpuCompositing", on);
+	});
+}
+
+void MainWindow::createAnalysisOptions(QMenu* menuOptions)
+{
+	// Options > Mosaic View: evenly spaced slices of one orientation in a single view
+	QAction* actionMosaic = menuOptions->addAction(tr("Mosaic View"));
+	actionMosaic->setCheckable(true);
+	connect(actionMosaic, &QAction::toggled, this, [this](bool on) {
+		ui->lightboxWidget->setMosaicMode(on);
+		// The mosaic tiles are slices of the volume view's image, which for a compressed volume is its preview
+		const int factor = ui->lightboxWidget->previewDownsampleFactor();
+		if (on && factor > 1) {
+			statusBar()->showMessage(tr("Mosaic shows the 1:%1 preview of the compressed volume").arg(factor), 5000);
+		}
+	});
+
+	// Options > Curved MPR: draw a path with the slice views' Curved Path tool; the
+	// straightened image opens in its own window
+	QAction* actionCurved = menuOptions->addAction(tr("Curved MPR"));
+	actionCurved->setCheckable(true);
+	connect(actionCurved, &QAction::toggled, this, [this, actionCurved](bool on) {
+		if (ui->lightboxWidget->setCurvedReformatMode(on)) return;
+		const QSignalBlocker block(actionCurved);
+		actionCurved->setChecked(false);
+		statusBar()->showMessage(tr("Curved MPR needs a loaded image"), 5000);
+	});
+	// Closing the window leaves the mode
+	connect(ui->lightboxWidget, &LightboxWidget::curvedReformatModeChanged, actionCurved, [actionCurved](bool on) {
+		const QSignalBlocker block(actionCurved);
+		actionCurved->setChecked(on);
+	});
+
+	// Options > Label Overlay: threshold result drawn over the slices; colour edits only touch the table
+	QMenu* menuOverlay = menuOptions->addMenu(tr("Label Overlay"));
+	menuOverlay->addAction(tr("Threshold..."), this, [this]() {
+		VolumeView* volume = ui->lightboxWidget->getVolumeView();
+		if (!volume || !volume->imageData()) return;
+		const auto [low, high] = volume->autoWindowBounds();
+		bool ok = false;
+		const double lower = QInputDialog::getDouble(this, tr("Threshold Overlay"), tr("Lower:"), 0.5 * (low + high),
+			volume->scalarRangeMin(), volume->scalarRangeMax(), 3, &ok);
+		if (!ok) return;
+		const double upper = QInputDialog::getDouble(this, tr("Threshold Overlay"), tr("Upper:"),
+			std::max(high, lower), lower, volume->scalarRangeMax(), 3, &ok);
+		if (!ok) return;
+		if (!ui->lightboxWidget->setThresholdOverlay(lower, upper)) {
+			statusBar()->showMessage(tr("Not enough memory for the threshold overlay"), 5000);
+		}
+	});
+	menuOverlay->addAction(tr("Color..."), this, [this]() {
+		LabelPalette& palette = ui->lightboxWidget->labelPalette();
+		double rgb[3];
+		palette.color(1, rgb);
+		const QColor color = QColorDialog::getColor(QColor::fromRgbF(rgb[0], rgb[1], rgb[2], palette.opacity(1)), this,
+			tr("Overlay Color"), QColorDialog::ShowAlphaChannel);
+		if (!color.isValid()) return;
+		palette.setColor(1, color.redF(), color.greenF(), color.blueF());
+		palette.setOpacity(1, color.alphaF());
+		ui->lightboxWidget->refreshLabelOverlay();
+	});
+	QAction* actionOverlayVisible = menuOverlay->addAction(tr("Show"));
+	actionOverlayVisible->setCheckable(true);
+	actionOverlayVisible->setChecked(true);
+	connect(actionOverlayVisible, &QAction::toggled, this, [this](bool on) {
+		ui->lightboxWidget->labelPalette().setVisible(1, on);
+		ui->lightboxWidget->refreshLabelOverlay();
+	});
+	menuOverlay->addAction(tr("Clear"), this, [this]() { ui->lightboxWidget->setLabelMap(nullptr); });
+}
+
 MainWindow::~MainWindow()
 {
 	saveRecentFiles();
@@ -380,6 +650,37 @@ void MainWindow::openFile(const QString& filePath)
 
 	imageLoader->SetInputPath(filePath);
 
+	// Compressed storage: stream straight into bit-packed bricks. Unsupported scalar types
+	// fall through to the regular load.
+	if (QSettings("CTAnalyzerX", "Loading").value("compressedStorage", false).toBool()) {
+		std::shared_ptr<CompressedVolume> compressed;
+		try {
+			compressed = imageLoader->LoadCompressed();
+		}
+		catch (const std::exception& ex) {
+			QMessageBox::critical(this, "Error Loading File",
+				QString("An error occurred while loading the file:\n%1\n\nDetails: %2")
+					.arg(filePath, ex.what()));
+			return;
+		}
+		if (compressed) {
+			const int cacheMegabytes = QSettings("CTAnalyzerX", "Loading").value("compressedCacheMB", 0).toInt();
+			compressed->setCacheBudgetBytes(static_cast<std::size_t>(std::max(cacheMegabytes, 0)) << 20);
+			currentImageData = nullptr;
+			ui->lightboxWidget->setCompressedVolume(compressed);
+			statusBar()->showMessage(
+				tr("Compressed storage: %1 MB of %2 MB (%3:1)")
+					.arg(static_cast<double>(compressed->compressedBytes()) / (1024.0 * 1024.0), 0, 'f', 1)
+					.arg(static_cast<double>(compressed->uncompressedBytes()) / (1024.0 * 1024.0), 0, 'f', 1)
+					.arg(static_cast<double>(compressed->uncompressedBytes()) /
+						static_cast<double>(std::max<unsigned long long>(compressed->compressedBytes(), 1)), 0, 'f', 2),
+				10000);
+			addToRecentFiles(filePath);
+			saveRecentFiles();
+			return;
+		}
+	}
+
 	// Try to load the image with detailed error feedback
 	vtkSmartPointer<vtkImageData> vtkImage;
 	try {
@@ -406,6 +707,19 @@ void MainWindow::openFile(const QString& filePath)
 	// Display the loaded image
 	loadVolume(vtkImage);
 
+	// Report the optional resampling stage (time, memory kept for the isotropic volume
+	// and memory freed by dropping the native one)
+	if (imageLoader->GetLastLoadResampled()) {
+		const double spacing = vtkImage->GetSpacing()[0];
+		statusBar()->showMessage(
+			tr("Resampled to isotropic %1 spacing in %2 s (%3 MB retained, %4 MB of native volume released)")
+				.arg(spacing, 0, 'g', 4)
+				.arg(imageLoader->GetLastResampleSeconds(), 0, 'f', 2)
+				.arg(static_cast<double>(imageLoader->GetLastResampleMemoryBytes()) / (1024.0 * 1024.0), 0, 'f', 1)
+				.arg(static_cast<double>(imageLoader->GetLastResampleReleasedBytes()) / (1024.0 * 1024.0), 0, 'f', 1),
+			10000);
+	}
+
 	// Update recent files list
 	addToRecentFiles(filePath);
 
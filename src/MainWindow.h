@@ -6,6 +6,9 @@
 #include <QProgressBar>
 #include <vtkSmartPointer.h>
 
+class QLabel;
+class QMenu;
+
 namespace Ui {
 	class MainWindow;
 }
@@ -47,6 +50,11 @@ private:
 	void loadRecentFiles();
 	void saveRecentFiles();
 	void openFile(const QString& filePath);
+	void createOptionsMenu();
+	// Sections of the Options menu: loading and memory, display, analysis tools
+	void createLoadingOptions(QMenu* menuOptions);
+	void createDisplayOptions(QMenu* menuOptions);
+	void createAnalysisOptions(QMenu* menuOptions);
 
 	Ui::MainWindow* ui;
 	QStringList recentFiles;
@@ -54,6 +62,7 @@ private:
 	vtkSmartPointer<vtkEventQtSlotConnect> vtkConnections;
 	vtkSmartPointer<ImageLoader> imageLoader = nullptr;
 	QProgressBar* progressBar = nullptr;
+	QLabel* probeLabel = nullptr; // voxel under the mouse
 	bool defaultImageLoaded = false;
 };
 
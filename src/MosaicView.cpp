@@ -0,0 +1,416 @@
+#include "MosaicView.h"
+#include "MenuButton.h"
+
+#include <QInputDialog>
+#include <QVTKOpenGLNativeWidget.h>
+
+#include <vtkCamera.h>
+#include <vtkCommand.h>
+#include <vtkEventQtSlotConnect.h>
+#include <vtkGenericOpenGLRenderWindow.h>
+#include <vtkImageData.h>
+#include <vtkImageProperty.h>
+#include <vtkImageSlice.h>
+#include <vtkImageSliceMapper.h>
+#include <vtkInteractorStyleImage.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkRenderer.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	constexpr int kMaxGridSide = 16;
+
+	// Gap between tiles relative to the larger tile side
+	constexpr double kTileGap = 0.04;
+}
+
+MosaicView::MosaicView(QWidget* parent)
+	: ImageFrameWidget(parent)
+{
+	m_renderArea = new QVTKOpenGLNativeWidget(this);
+	setSceneContent(m_renderArea);
+	m_renderArea->setRenderWindow(m_renderWindow);
+	m_renderArea->setFocusPolicy(Qt::StrongFocus);
+	setFocusProxy(m_renderArea);
+
+	createMenuAndActions();
+
+	if (auto* cam = m_renderer->GetActiveCamera()) {
+		cam->ParallelProjectionOn();
+	}
+
+	// One property for all tiles: window/level and interpolation are set once
+	m_property = vtkSmartPointer<vtkImageProperty>::New();
+	m_property->SetInterpolationTypeToLinear();
+
+	m_connections = vtkSmartPointer<vtkEventQtSlotConnect>::New();
+	if (auto* iren = m_renderWindow->GetInteractor()) {
+		m_style = vtkSmartPointer<vtkInteractorStyleImage>::New();
+		m_style->SetInteractionModeToImage2D();
+		m_style->SetDefaultRenderer(m_renderer);
+		m_style->AutoAdjustCameraClippingRangeOn();
+		m_style->SetHandleObservers(true);
+		iren->SetInteractorStyle(m_style);
+
+		m_connections->Connect(m_style, vtkCommand::StartWindowLevelEvent,
+			this, SLOT(onInteractorStartWindowLevel(vtkObject*)), nullptr, -1.0f);
+		m_connections->Connect(m_style, vtkCommand::WindowLevelEvent,
+			this, SLOT(onInteractorWindowLevel(vtkObject*)), nullptr, -1.0f);
+		m_connections->Connect(m_style, vtkCommand::EndWindowLevelEvent,
+			this, SLOT(onInteractorEndWindowLevel(vtkObject*)), nullptr, -1.0f);
+		m_connections->Connect(m_style, vtkCommand::ResetWindowLevelEvent,
+			this, SLOT(onResetWindowLevel(vtkObject*)));
+	}
+
+	rebuildTiles();
+	setTitle(orientationLabel(m_viewOrientation));
+}
+
+MosaicView::~MosaicView() = default;
+
+void MosaicView::createMenuAndActions()
+{
+	setSelectionList({
+		QStringLiteral("XY"),
+		QStringLiteral("YZ"),
+		QStringLiteral("XZ"),
+		QStringLiteral("--"),
+		QStringLiteral("Grid..."),
+		QStringLiteral("Slice Range..."),
+		QStringLiteral("All Slices"),
+		QStringLiteral("Reset Camera")
+	});
+
+	if (auto* mb = menuButton()) {
+		connect(mb, &MenuButton::itemSelected, this, [this](const QString& item) {
+			if (item == QLatin1String("XY") || item == QLatin1String("YZ") || item == QLatin1String("XZ")) {
+				setViewOrientation(labelToOrientation(item));
+			}
+			else if (item == QLatin1String("Grid...")) {
+				bool ok = false;
+				const int rows = QInputDialog::getInt(this, tr("Mosaic Grid"), tr("Rows:"), m_rows, 1, kMaxGridSide, 1, &ok);
+				if (!ok) return;
+				const int columns = QInputDialog::getInt(this, tr("Mosaic Grid"), tr("Columns:"), m_columns, 1, kMaxGridSide, 1, &ok);
+				if (ok) setGrid(rows, columns);
+			}
+			else if (item == QLatin1String("Slice Range...")) {
+				if (!m_imageData) return;
+				const int axis = m_viewOrientation;
+				const int lo = m_extent[2 * axis];
+				const int hi = m_extent[2 * axis + 1];
+				bool ok = false;
+				const int first = QInputDialog::getInt(this, tr("Mosaic Slices"), tr("First slice:"), m_first, lo, hi, 1, &ok);
+				if (!ok) return;
+				const int last = QInputDialog::getInt(this, tr("Mosaic Slices"), tr("Last slice:"), std::max(m_last, first), first, hi, 1, &ok);
+				if (ok) setSliceRange(first, last);
+			}
+			else if (item == QLatin1String("All Slices")) {
+				resetSliceRange();
+			}
+			else if (item == QLatin1String("Reset Camera")) {
+				resetCamera();
+			}
+		});
+	}
+}
+
+void MosaicView::setImageData(vtkImageData* image)
+{
+	if (!image) return;
+
+	m_imageData = image;
+	computeShiftScaleFromInput();
+	cacheImageGeometry();
+
+	for (Tile& tile : m_tiles) {
+		tile.mapper->SetInputConnection(displayOutputPort());
+		applyOrientation(tile.mapper);
+		tile.placed = false;
+	}
+	m_imageInitialized = true;
+
+	// Same percentile baseline as the other views
+	const auto [lb, ub] = autoWindowBounds();
+	setBaselineWindowLevel(std::max(ub - lb, minimumWindowNative()), 0.5 * (ub + lb));
+	const auto [windowMapped, levelMapped] = baselineMapped();
+	m_property->SetColorWindow(std::max(windowMapped, minimumWindowMapped()));
+	m_property->SetColorLevel(levelMapped);
+
+	// The style edits the last image prop's property, which every tile shares
+	if (m_style) {
+		m_style->SetCurrentRenderer(m_renderer);
+		m_style->SetCurrentImageNumber(-1);
+	}
+
+	if (m_fullRange) resetSliceRange();
+	else setSliceRange(m_first, m_last);
+	fitCamera();
+	render();
+}
+
+void MosaicView::setViewOrientation(ViewOrientation orientation)
+{
+	if (m_viewOrientation == orientation) return;
+	m_viewOrientation = orientation;
+	setTitle(orientationLabel(m_viewOrientation));
+
+	if (m_imageData) {
+		for (Tile& tile : m_tiles) {
+			applyOrientation(tile.mapper);
+			tile.placed = false;
+		}
+		// A range along the old axis means nothing along the new one
+		resetSliceRange();
+		fitCamera();
+		render();
+	}
+	notifyViewOrientationChanged();
+}
+
+void MosaicView::setInterpolation(Interpolation newInterpolation)
+{
+	if (newInterpolation == m_interpolation) return;
+	m_interpolation = newInterpolation;
+	switch (m_interpolation) {
+		case Nearest: m_property->SetInterpolationTypeToNearest(); break;
+		case Linear:  m_property->SetInterpolationTypeToLinear(); break;
+		case Cubic:   m_property->SetInterpolationTypeToCubic(); break;
+	}
+	render();
+	emit interpolationChanged(m_interpolation);
+}
+
+void MosaicView::setGrid(int rows, int columns)
+{
+	rows = std::clamp(rows, 1, kMaxGridSide);
+	columns = std::clamp(columns, 1, kMaxGridSide);
+	if (rows == m_rows && columns == m_columns) return;
+	m_rows = rows;
+	m_columns = columns;
+
+	rebuildTiles();
+	if (!m_imageData) return;
+	layoutTiles();
+	fitCamera();
+	render();
+}
+
+void MosaicView::setSliceRange(int first, int last)
+{
+	if (!m_imageData) return;
+	const int axis = m_viewOrientation;
+	const int lo = m_extent[2 * axis];
+	const int hi = m_extent[2 * axis + 1];
+	m_first = std::clamp(std::min(first, last), lo, hi);
+	m_last = std::clamp(std::max(first, last), lo, hi);
+	m_fullRange = (m_first == lo && m_last == hi);
+
+	layoutTiles();
+	render();
+}
+
+void MosaicView::resetSliceRange()
+{
+	if (!m_imageData) return;
+	const int axis = m_viewOrientation;
+	setSliceRange(m_extent[2 * axis], m_extent[2 * axis + 1]);
+}
+
+void MosaicView::updateData()
+{
+	// Scalars changed in place: every tile's texture is stale
+	updateDisplayInput();
+	for (Tile& tile : m_tiles) tile.slice->Modified();
+	render();
+}
+
+void MosaicView::resetCamera()
+{
+	fitCamera();
+	render();
+}
+
+void MosaicView::rebuildTiles()
+{
+	for (Tile& tile : m_tiles) m_renderer->RemoveViewProp(tile.slice);
+	m_tiles.clear();
+
+	const int count = m_rows * m_columns;
+	m_tiles.resize(count);
+	for (Tile& tile : m_tiles) {
+		tile.mapper = vtkSmartPointer<vtkImageSliceMapper>::New();
+		tile.mapper->StreamingOn();
+		tile.mapper->SliceFacesCameraOff();
+		tile.mapper->SliceAtFocalPointOff();
+		if (m_imageData) {
+			tile.mapper->SetInputConnection(displayOutputPort());
+			applyOrientation(tile.mapper);
+		}
+
+		tile.slice = vtkSmartPointer<vtkImageSlice>::New();
+		tile.slice->SetMapper(tile.mapper);
+		tile.slice->SetProperty(m_property);
+		tile.slice->VisibilityOff();
+		m_renderer->AddViewProp(tile.slice);
+	}
+}
+
+void MosaicView::applyOrientation(vtkImageSliceMapper* mapper) const
+{
+	switch (m_viewOrientation) {
+		case VIEW_ORIENTATION_YZ: mapper->SetOrientationToX(); break;
+		case VIEW_ORIENTATION_XZ: mapper->SetOrientationToY(); break;
+		case VIEW_ORIENTATION_XY:
+		default:                  mapper->SetOrientationToZ(); break;
+	}
+}
+
+int MosaicView::tileSlice(int tile) const
+{
+	const int count = static_cast<int>(m_tiles.size());
+	const int span = m_last - m_first;
+	if (span < 0 || tile >= count) return -1;
+	if (span < count) return tile <= span ? m_first + tile : -1;
+	if (count == 1) return midIndex(m_first, m_last);
+	return m_first + static_cast<int>(std::lround(static_cast<double>(tile) * span / (count - 1)));
+}
+
+void MosaicView::layoutTiles()
+{
+	if (!m_imageData) return;
+
+	const int w = m_viewOrientation;
+	const int u = (w == 0) ? 1 : 0;
+	const int v = (w == 2) ? 1 : 2;
+
+	// Columns advance to screen right, which is -x when looking at XZ (see fitCamera)
+	const double rightSign = (w == 1) ? -1.0 : 1.0;
+	const double width = m_spacing[u] * (m_extent[2 * u + 1] - m_extent[2 * u] + 1);
+	const double height = m_spacing[v] * (m_extent[2 * v + 1] - m_extent[2 * v] + 1);
+	const double gap = kTileGap * std::max(width, height);
+
+	for (int t = 0; t < static_cast<int>(m_tiles.size()); ++t) {
+		Tile& tile = m_tiles[t];
+		const int index = tileSlice(t);
+		if (index < 0) {
+			tile.slice->VisibilityOff();
+			continue;
+		}
+		tile.slice->VisibilityOn();
+		// Unchanged tiles keep their mapper state and texture
+		if (tile.placed && tile.index == index) continue;
+
+		tile.index = index;
+		tile.mapper->SetSliceNumber(index);
+
+		// Move the slice into its grid cell and back onto the plane of the first slice
+		double position[3] = { 0.0, 0.0, 0.0 };
+		position[u] = rightSign * (t % m_columns) * (width + gap);
+		position[v] = -(t / m_columns) * (height + gap);
+		position[w] = -(index - m_extent[2 * w]) * m_spacing[w];
+		tile.slice->SetPosition(position);
+		tile.placed = true;
+	}
+}
+
+void MosaicView::fitCamera()
+{
+	if (!m_imageData) {
+		m_renderer->ResetCamera();
+		return;
+	}
+
+	// Same camera frame as SliceView: look along +w with v up
+	const int w = m_viewOrientation;
+	const int v = (w == 2) ? 1 : 2;
+	double focal[3] = { 0.0, 0.0, 0.0 };
+	double position[3] = { 0.0, 0.0, 0.0 };
+	double up[3] = { 0.0, 0.0, 0.0 };
+	position[w] = 1.0;
+	up[v] = 1.0;
+
+	auto* camera = m_renderer->GetActiveCamera();
+	camera->ParallelProjectionOn();
+	camera->SetFocalPoint(focal);
+	camera->SetPosition(position);
+	camera->SetViewUp(up);
+	camera->OrthogonalizeViewUp();
+
+	// Frame the visible tiles
+	m_renderer->ResetCamera();
+	m_renderer->ResetCameraClippingRange();
+}
+
+void MosaicView::setWindowLevelNative(double window, double level)
+{
+	if (!m_imageData) return;
+
+	const auto [windowMapped, levelMapped] = mapWindowLevelToMapped(window, level);
+	m_property->SetColorWindow(std::max(windowMapped, minimumWindowMapped()));
+	m_property->SetColorLevel(levelMapped);
+
+	render();
+	emit windowLevelChanged(window, level);
+}
+
+std::pair<double, double> MosaicView::nativeWindowLevel() const
+{
+	// Inverse of (native + shift) * scale
+	const double window = std::fabs(m_property->GetColorWindow()) / m_scalarScale;
+	const double level = m_property->GetColorLevel() / m_scalarScale - m_scalarShift;
+	return { std::max(window, minimumWindowNative()), level };
+}
+
+void MosaicView::onInteractorStartWindowLevel(vtkObject* /*caller*/)
+{
+	m_windowLevelInitial[0] = m_property->GetColorWindow();
+	m_windowLevelInitial[1] = m_property->GetColorLevel();
+}
+
+void MosaicView::onInteractorWindowLevel(vtkObject* caller)
+{
+	auto* style = vtkInteractorStyleImage::SafeDownCast(caller);
+	if (!style || !m_imageData) return;
+
+	int size[2] = { 1, 1 };
+	if (const int* s = m_renderWindow->GetSize()) {
+		size[0] = std::max(s[0], 1);
+		size[1] = std::max(s[1], 1);
+	}
+
+	// vtkInteractorStyleImage's mapping, with SliceView's float-aware floor
+	const int* start = style->GetWindowLevelStartPosition();
+	const int* current = style->GetWindowLevelCurrentPosition();
+	const double window = m_windowLevelInitial[0];
+	const double level = m_windowLevelInitial[1];
+	const double eps = std::min(0.01, minimumWindowMapped());
+
+	double dx = (current[0] - start[0]) * 4.0 / size[0];
+	double dy = (start[1] - current[1]) * 4.0 / size[1];
+	dx *= std::fabs(window) > eps ? window : (window < 0 ? -eps : eps);
+	dy *= std::fabs(level) > eps ? level : (level < 0 ? -eps : eps);
+	if (window < 0.0) dx = -dx;
+	if (level < 0.0) dy = -dy;
+
+	m_property->SetColorWindow(std::max(window + dx, eps));
+	m_property->SetColorLevel(level - dy);
+	render();
+
+	const auto [nativeWindow, nativeLevel] = nativeWindowLevel();
+	emit windowLevelChanged(nativeWindow, nativeLevel);
+}
+
+void MosaicView::onInteractorEndWindowLevel(vtkObject* /*caller*/)
+{
+	if (!m_imageData) return;
+	const auto [nativeWindow, nativeLevel] = nativeWindowLevel();
+	emit windowLevelChanged(nativeWindow, nativeLevel);
+}
+
+void MosaicView::onResetWindowLevel(vtkObject* /*caller*/)
+{
+	// 'r' in the view restores the retained baseline
+	resetWindowLevel();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "ImageFrameWidget.h"
+
+#include <vtkSmartPointer.h>
+
+#include <utility>
+#include <vector>
+
+class QVTKOpenGLNativeWidget;
+class vtkEventQtSlotConnect;
+class vtkImageProperty;
+class vtkImageSlice;
+class vtkImageSliceMapper;
+class vtkInteractorStyleImage;
+class vtkObject;
+
+// Lightbox mosaic: rows x columns evenly spaced slices of one orientation in a single
+// render window.
+//
+// All tiles are vtkImageSlice props in one renderer, laid out side by side in the view
+// plane, so the whole mosaic is one render pass on one GL context. The tiles read the
+// same display input and share one vtkImageProperty: a window/level change is a single
+// property update, and a tile's mapper (and its texture) only changes when that tile is
+// given a different slice. Pan, zoom and window/level act on the mosaic as a whole.
+class MosaicView : public ImageFrameWidget
+{
+	Q_OBJECT
+
+public:
+	explicit MosaicView(QWidget* parent = nullptr);
+	~MosaicView() override;
+
+	void setImageData(vtkImageData* image) override;
+	void setViewOrientation(ViewOrientation orientation) override;
+	void setInterpolation(Interpolation newInterpolation) override;
+
+	// Native-domain window/level for all tiles (one shared property); emits windowLevelChanged
+	void setWindowLevelNative(double window, double level);
+	void setColorWindowLevel(double window, double level) override { setWindowLevelNative(window, level); }
+
+	void setGrid(int rows, int columns);
+	int rows() const { return m_rows; }
+	int columns() const { return m_columns; }
+
+	// Slices spread over the tiles (clamped to the extent); resetSliceRange() covers the whole axis
+	void setSliceRange(int first, int last);
+	void resetSliceRange();
+	int firstSlice() const { return m_first; }
+	int lastSlice() const { return m_last; }
+
+public slots:
+	void updateData() override;
+
+protected:
+	void resetCamera() override;
+
+private slots:
+	void onInteractorStartWindowLevel(vtkObject* caller);
+	void onInteractorWindowLevel(vtkObject* caller);
+	void onInteractorEndWindowLevel(vtkObject* caller);
+	void onResetWindowLevel(vtkObject* caller);
+
+private:
+	struct Tile
+	{
+		vtkSmartPointer<vtkImageSliceMapper> mapper;
+		vtkSmartPointer<vtkImageSlice> slice;
+		int index = 0;
+		bool placed = false;
+	};
+
+	void createMenuAndActions();
+	// Match the tile count to the grid
+	void rebuildTiles();
+	// Assign slices and positions; only tiles whose slice changes are touched
+	void layoutTiles();
+	void fitCamera();
+	// Slice shown by tile `tile`, or -1 when the range has fewer slices than tiles
+	int tileSlice(int tile) const;
+	void applyOrientation(vtkImageSliceMapper* mapper) const;
+	// Current property window/level converted to the native domain
+	std::pair<double, double> nativeWindowLevel() const;
+
+	QVTKOpenGLNativeWidget* m_renderArea = nullptr;
+	vtkSmartPointer<vtkInteractorStyleImage> m_style;
+	vtkSmartPointer<vtkImageProperty> m_property;
+	vtkSmartPointer<vtkEventQtSlotConnect> m_connections;
+	std::vector<Tile> m_tiles;
+	double m_windowLevelInitial[2] = { 1.0, 0.5 }; // mapped window/level at drag start
+
+	int m_rows = 6;
+	int m_columns = 8;
+	int m_first = 0;
+	int m_last = -1;
+	bool m_fullRange = true;
+};
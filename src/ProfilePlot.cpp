@@ -0,0 +1,94 @@
+#include "ProfilePlot.h"
+
+#include <QCloseEvent>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPaintEvent>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	constexpr int kMargin = 6;
+}
+
+ProfilePlot::ProfilePlot(QWidget* parent)
+	: QWidget(parent)
+{
+	setAttribute(Qt::WA_OpaquePaintEvent);
+	setMinimumSize(240, 120);
+}
+
+void ProfilePlot::setProfile(std::vector<float> values, double step)
+{
+	m_values = std::move(values);
+	m_step = step;
+	update();
+}
+
+void ProfilePlot::clear()
+{
+	m_values.clear();
+	m_step = 0.0;
+	update();
+}
+
+QSize ProfilePlot::sizeHint() const
+{
+	return QSize(420, 220);
+}
+
+void ProfilePlot::paintEvent(QPaintEvent* event)
+{
+	Q_UNUSED(event);
+	QPainter painter(this);
+	painter.fillRect(rect(), palette().base());
+	painter.setPen(palette().color(QPalette::Text));
+
+	if (m_values.size() < 2) {
+		painter.drawText(rect(), Qt::AlignCenter, tr("Drag on the slice to draw a line"));
+		return;
+	}
+
+	const auto [lo, hi] = std::minmax_element(m_values.begin(), m_values.end());
+	const double minValue = *lo;
+	const double maxValue = *hi;
+	const double length = m_step * (m_values.size() - 1);
+
+	// Axis labels: value range on the left, distance along the bottom
+	const QFontMetrics fm = painter.fontMetrics();
+	const QString top = QString::number(maxValue, 'g', 6);
+	const QString bottom = QString::number(minValue, 'g', 6);
+	const int labelWidth = std::max(fm.horizontalAdvance(top), fm.horizontalAdvance(bottom));
+	const QRect plot = rect().adjusted(kMargin + labelWidth + kMargin, kMargin, -kMargin, -(kMargin + fm.height()));
+	if (plot.width() < 2 || plot.height() < 2) return;
+
+	painter.drawText(QRect(kMargin, plot.top(), labelWidth, fm.height()), Qt::AlignRight, top);
+	painter.drawText(QRect(kMargin, plot.bottom() - fm.height(), labelWidth, fm.height()), Qt::AlignRight, bottom);
+	painter.drawText(QRect(plot.left(), plot.bottom() + 2, plot.width(), fm.height()), Qt::AlignLeft, QStringLiteral("0"));
+	painter.drawText(QRect(plot.left(), plot.bottom() + 2, plot.width(), fm.height()), Qt::AlignRight,
+		QString::number(length, 'g', 4));
+	painter.setPen(palette().color(QPalette::Mid));
+	painter.drawRect(plot.adjusted(0, 0, -1, -1));
+
+	// A flat profile is drawn through the middle
+	const double span = maxValue > minValue ? maxValue - minValue : 1.0;
+	const double base = maxValue > minValue ? minValue : minValue - 0.5;
+	const double sx = (plot.width() - 1) / static_cast<double>(m_values.size() - 1);
+	const double sy = (plot.height() - 1) / span;
+	QPainterPath path;
+	for (std::size_t i = 0; i < m_values.size(); ++i) {
+		const QPointF p(plot.left() + i * sx, plot.bottom() - (m_values[i] - base) * sy);
+		if (i == 0) path.moveTo(p);
+		else path.lineTo(p);
+	}
+	painter.setRenderHint(QPainter::Antialiasing);
+	painter.setPen(QPen(palette().color(QPalette::Highlight), 1.5));
+	painter.drawPath(path);
+}
+
+void ProfilePlot::closeEvent(QCloseEvent* event)
+{
+	QWidget::closeEvent(event);
+	emit closed();
+}
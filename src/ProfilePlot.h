@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QWidget>
+
+#include <vector>
+
+class QPaintEvent;
+class QCloseEvent;
+
+// Line chart of an intensity profile, redrawn whenever a new profile is set. Used by
+// SliceView's line-profile tool as a small tool window that follows the drag live.
+class ProfilePlot : public QWidget
+{
+	Q_OBJECT
+
+public:
+	explicit ProfilePlot(QWidget* parent = nullptr);
+
+	// `step` is the world distance between samples
+	void setProfile(std::vector<float> values, double step);
+	void clear();
+
+	QSize sizeHint() const override;
+
+signals:
+	void closed();
+
+protected:
+	void paintEvent(QPaintEvent* event) override;
+	void closeEvent(QCloseEvent* event) override;
+
+private:
+	std::vector<float> m_values;
+	double m_step = 0.0;
+};
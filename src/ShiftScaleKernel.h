@@ -0,0 +1,214 @@
+#pragma once
+
+#include "CpuFeatures.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Clamp-and-convert kernels used by ImageShiftScaleFilter.
+//
+// Each kernel computes out = clamp((double(in) + shift) * scale, 0, 65535) and truncates
+// to unsigned short, which is what vtkImageShiftScale does with ClampOverflowOn and an
+// unsigned short output for every non-NaN input. The arithmetic stays in double on every
+// path (scalar, AVX2, NEON), so the vector results are bit-identical to the scalar
+// reference. NaN maps to 0 on all paths (the stock filter's cast of NaN is undefined).
+//
+// On x86-64 the AVX2 loop is compiled for AVX2 only and chosen at run time, see
+// CpuFeatures.h; NEON is baseline on aarch64.
+namespace ShiftScaleKernel
+{
+	inline unsigned short convertOne(double value, double shift, double scale)
+	{
+		double val = (value + shift) * scale;
+		if (val > 65535.0) val = 65535.0;
+		if (!(val >= 0.0)) val = 0.0; // also catches NaN
+		return static_cast<unsigned short>(val);
+	}
+
+	template <typename T>
+	inline void convertScalar(const T* in, unsigned short* out, std::size_t n, double shift, double scale)
+	{
+		for (std::size_t i = 0; i < n; ++i) {
+			out[i] = convertOne(static_cast<double>(in[i]), shift, scale);
+		}
+	}
+
+#if defined(CTANALYZERX_X86_64)
+	namespace detail
+	{
+		// Widen 8 input values to two vectors of 4 doubles
+		template <typename T>
+		CTANALYZERX_TARGET_AVX2 inline void load8(const T* p, __m256d& lo, __m256d& hi)
+		{
+			if constexpr (std::is_same_v<T, float>) {
+				const __m256 v = _mm256_loadu_ps(p);
+				lo = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+				hi = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+			}
+			else if constexpr (std::is_same_v<T, double>) {
+				lo = _mm256_loadu_pd(p);
+				hi = _mm256_loadu_pd(p + 4);
+			}
+			else {
+				__m256i i32;
+				if constexpr (std::is_same_v<T, std::int32_t>) {
+					i32 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+				}
+				else if constexpr (std::is_same_v<T, std::int16_t>) {
+					i32 = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+				}
+				else if constexpr (std::is_same_v<T, std::uint16_t>) {
+					i32 = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+				}
+				else if constexpr (std::is_signed_v<T> && sizeof(T) == 1) {
+					i32 = _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+				}
+				else {
+					static_assert(std::is_unsigned_v<T> && sizeof(T) == 1, "unsupported AVX2 input type");
+					i32 = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+				}
+				lo = _mm256_cvtepi32_pd(_mm256_castsi256_si128(i32));
+				hi = _mm256_cvtepi32_pd(_mm256_extracti128_si256(i32, 1));
+			}
+		}
+
+		CTANALYZERX_TARGET_AVX2 inline __m128i clampTruncate(__m256d v, __m256d shift, __m256d scale, __m256d zero, __m256d top)
+		{
+			v = _mm256_mul_pd(_mm256_add_pd(v, shift), scale);
+			// max_pd returns the second operand when the first is NaN, so NaN -> 0
+			v = _mm256_max_pd(v, zero);
+			v = _mm256_min_pd(v, top);
+			return _mm256_cvttpd_epi32(v);
+		}
+	}
+
+	template <typename T>
+	inline constexpr bool hasVectorPath =
+		std::is_same_v<T, float> || std::is_same_v<T, double> ||
+		std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::int16_t> ||
+		std::is_same_v<T, std::uint16_t> || (std::is_integral_v<T> && sizeof(T) == 1);
+
+	namespace detail
+	{
+		// Converts whole groups of 8 and returns how many values it handled
+		template <typename T>
+		CTANALYZERX_TARGET_AVX2 std::size_t convertAvx2(const T* in, unsigned short* out, std::size_t n,
+			double shift, double scale)
+		{
+			const __m256d vShift = _mm256_set1_pd(shift);
+			const __m256d vScale = _mm256_set1_pd(scale);
+			const __m256d vZero = _mm256_setzero_pd();
+			const __m256d vTop = _mm256_set1_pd(65535.0);
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				__m256d lo, hi;
+				load8(in + i, lo, hi);
+				const __m128i a = clampTruncate(lo, vShift, vScale, vZero, vTop);
+				const __m128i b = clampTruncate(hi, vShift, vScale, vZero, vTop);
+				// Values are already in [0, 65535]; unsigned saturation is exact
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi32(a, b));
+			}
+			return i;
+		}
+	}
+
+	template <typename T>
+	inline void convert(const T* in, unsigned short* out, std::size_t n, double shift, double scale)
+	{
+		std::size_t i = 0;
+		if constexpr (hasVectorPath<T>) {
+			if (CpuFeatures::hasAvx2()) i = detail::convertAvx2(in, out, n, shift, scale);
+		}
+		convertScalar(in + i, out + i, n - i, shift, scale);
+	}
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	namespace detail
+	{
+		inline uint16x4_t clampTruncate(float64x2_t a, float64x2_t b, float64x2_t shift, float64x2_t scale,
+			float64x2_t zero, float64x2_t top)
+		{
+			a = vmulq_f64(vaddq_f64(a, shift), scale);
+			b = vmulq_f64(vaddq_f64(b, shift), scale);
+			// maxNum returns the numeric operand when the other is NaN, so NaN -> 0
+			a = vminnmq_f64(vmaxnmq_f64(a, zero), top);
+			b = vminnmq_f64(vmaxnmq_f64(b, zero), top);
+			const int32x4_t i32 = vcombine_s32(vmovn_s64(vcvtq_s64_f64(a)), vmovn_s64(vcvtq_s64_f64(b)));
+			return vqmovun_s32(i32);
+		}
+
+		// Widen 4 input values to two vectors of 2 doubles
+		template <typename T>
+		inline void load4(const T* p, float64x2_t& lo, float64x2_t& hi)
+		{
+			if constexpr (std::is_same_v<T, float>) {
+				const float32x4_t v = vld1q_f32(p);
+				lo = vcvt_f64_f32(vget_low_f32(v));
+				hi = vcvt_high_f64_f32(v);
+			}
+			else if constexpr (std::is_same_v<T, double>) {
+				lo = vld1q_f64(p);
+				hi = vld1q_f64(p + 2);
+			}
+			else if constexpr (std::is_same_v<T, std::int32_t>) {
+				const int32x4_t v = vld1q_s32(p);
+				lo = vcvtq_f64_s64(vmovl_s32(vget_low_s32(v)));
+				hi = vcvtq_f64_s64(vmovl_high_s32(v));
+			}
+			else if constexpr (std::is_same_v<T, std::int16_t>) {
+				const int32x4_t v = vmovl_s16(vld1_s16(p));
+				lo = vcvtq_f64_s64(vmovl_s32(vget_low_s32(v)));
+				hi = vcvtq_f64_s64(vmovl_high_s32(v));
+			}
+			else {
+				static_assert(std::is_same_v<T, std::uint16_t>, "unsupported NEON input type");
+				const uint32x4_t v = vmovl_u16(vld1_u16(p));
+				lo = vcvtq_f64_u64(vmovl_u32(vget_low_u32(v)));
+				hi = vcvtq_f64_u64(vmovl_high_u32(v));
+			}
+		}
+	}
+
+	template <typename T>
+	inline constexpr bool hasVectorPath =
+		std::is_same_v<T, float> || std::is_same_v<T, double> ||
+		std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::int16_t> ||
+		std::is_same_v<T, std::uint16_t>;
+
+	template <typename T>
+	inline void convert(const T* in, unsigned short* out, std::size_t n, double shift, double scale)
+	{
+		std::size_t i = 0;
+		if constexpr (hasVectorPath<T>) {
+			const float64x2_t vShift = vdupq_n_f64(shift);
+			const float64x2_t vScale = vdupq_n_f64(scale);
+			const float64x2_t vZero = vdupq_n_f64(0.0);
+			const float64x2_t vTop = vdupq_n_f64(65535.0);
+			for (; i + 8 <= n; i += 8) {
+				float64x2_t a, b, c, d;
+				detail::load4(in + i, a, b);
+				detail::load4(in + i + 4, c, d);
+				const uint16x4_t lo = detail::clampTruncate(a, b, vShift, vScale, vZero, vTop);
+				const uint16x4_t hi = detail::clampTruncate(c, d, vShift, vScale, vZero, vTop);
+				vst1q_u16(out + i, vcombine_u16(lo, hi));
+			}
+		}
+		convertScalar(in + i, out + i, n - i, shift, scale);
+	}
+
+#else
+	template <typename T>
+	inline constexpr bool hasVectorPath = false;
+
+	template <typename T>
+	inline void convert(const T* in, unsigned short* out, std::size_t n, double shift, double scale)
+	{
+		convertScalar(in, out, n, shift, scale);
+	}
+#endif
+}
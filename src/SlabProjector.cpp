@@ -0,0 +1,300 @@
+#include "SlabProjector.h"
+#include "SliceProvider.h"
+#include "VolumeKernels.h"
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace {
+	// Incremental steps before the slab is rebuilt, bounding rounding drift in the sum
+	constexpr int kRebuildSteps = 256;
+	// No slice
+	constexpr int kNone = std::numeric_limits<int>::min();
+
+	template <typename T, bool Max>
+	inline T pick(T a, T b)
+	{
+		if constexpr (Max) return a < b ? b : a;
+		else return b < a ? b : a;
+	}
+
+	// Identity of pick(): never wins against a real value
+	template <typename T, bool Max>
+	constexpr T neutral()
+	{
+		return Max ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max();
+	}
+
+	// Call f(begin, end) for the pixel ranges of bands of whole rows of a slice, in
+	// parallel; the slice is walked as a stack of rows
+	template <typename F>
+	void forEachBand(int rows, vtkIdType rowLength, F&& f)
+	{
+		const int extent[6] = { 0, static_cast<int>(rowLength) - 1, 0, 0, 0, rows - 1 };
+		VolumeKernels::forEachSlab(extent, [&f, rowLength](int r0, int r1) {
+			f(r0 * rowLength, (r1 + 1) * rowLength);
+		}, VolumeKernels::slabDepth(extent));
+	}
+
+	// Move the running extreme `ext` by one step: fold in `in` (may be null), drop `out`
+	// (may be null) and store `in` into `inSlot`, which may alias `out`. Pixels whose
+	// extreme was the leaving value are rescanned over slabSlice(first..last).
+	template <typename T, bool Max, typename SliceAt>
+	void stepExtreme(T* ext, const T* out, const T* in, T* inSlot, unsigned char* rescan, int rows,
+		vtkIdType rowLength, int first, int last, const SliceAt& slabSlice)
+	{
+		forEachBand(rows, rowLength, [&](vtkIdType begin, vtkIdType end) {
+			// Branch-free pass: fold, flag, store
+			bool any = false;
+			for (vtkIdType p = begin; p < end; ++p) {
+				const T m = ext[p];
+				const T o = out ? out[p] : neutral<T, Max>();
+				const T v = in ? in[p] : neutral<T, Max>();
+				const T next = pick<T, Max>(m, v);
+				const unsigned char lost = (out && o == m && next == m && !(v == m)) ? 1 : 0;
+				rescan[p] = lost;
+				any |= lost != 0;
+				ext[p] = next;
+				if (inSlot) inSlot[p] = v;
+			}
+			if (!any) return;
+
+			for (vtkIdType p = begin; p < end; ++p) {
+				if (!rescan[p]) continue;
+				T r = neutral<T, Max>();
+				for (int i = first; i <= last; ++i) r = pick<T, Max>(r, slabSlice(i)[p]);
+				ext[p] = r;
+			}
+		});
+	}
+
+	template <typename T>
+	inline T fromMean(double v)
+	{
+		if constexpr (std::is_integral_v<T>) return static_cast<T>(std::nearbyint(v));
+		else return static_cast<T>(v);
+	}
+}
+
+SlabProjector::SlabProjector(std::shared_ptr<SliceProvider> provider, int axis)
+	: m_provider(std::move(provider))
+	, m_axis(std::clamp(axis, 0, 2))
+{
+	m_fetched = vtkSmartPointer<vtkImageData>::New();
+	m_output = vtkSmartPointer<vtkImageData>::New();
+	if (!m_provider) return;
+
+	m_provider->getExtent(m_extent);
+	m_scalarType = m_provider->scalarType();
+	m_elementSize = vtkDataArray::GetDataTypeSize(m_scalarType);
+	const int u = (m_axis + 1) % 3;
+	const int v = (m_axis + 2) % 3;
+	// Slices keep x-fastest order, so rows run along the lower of the two in-plane axes
+	const int row = std::min(u, v);
+	const int column = std::max(u, v);
+	m_rowLength = std::max(m_extent[2 * row + 1] - m_extent[2 * row] + 1, 0);
+	m_rows = std::max(m_extent[2 * column + 1] - m_extent[2 * column] + 1, 0);
+	m_pixels = static_cast<std::size_t>(m_rowLength) * static_cast<std::size_t>(m_rows);
+}
+
+SlabProjector::~SlabProjector() = default;
+
+void SlabProjector::setMode(Mode mode)
+{
+	if (m_mode == mode) return;
+	m_mode = mode;
+	invalidate();
+}
+
+void SlabProjector::setThickness(int slices)
+{
+	slices = std::max(slices, 1);
+	if (m_thickness == slices) return;
+	m_thickness = slices;
+	invalidate();
+}
+
+unsigned char* SlabProjector::slot(int index)
+{
+	const int n = m_thickness;
+	const std::size_t s = static_cast<std::size_t>(((index % n) + n) % n);
+	return m_ring.data() + s * m_pixels * static_cast<std::size_t>(m_elementSize);
+}
+
+bool SlabProjector::fetch(int index)
+{
+	if (!m_provider->extractSlice(m_axis, index, m_fetched)) return false;
+	vtkDataArray* scalars = m_fetched->GetPointData() ? m_fetched->GetPointData()->GetScalars() : nullptr;
+	return scalars && scalars->GetNumberOfComponents() == 1 && scalars->GetDataType() == m_scalarType &&
+		static_cast<std::size_t>(scalars->GetNumberOfTuples()) == m_pixels;
+}
+
+vtkImageData* SlabProjector::project(int index)
+{
+	if (!m_provider || m_pixels == 0) return nullptr;
+	const int lo = m_extent[2 * m_axis];
+	const int hi = m_extent[2 * m_axis + 1];
+	if (index < lo || index > hi) return nullptr;
+
+	const int first = std::max(lo, index - (m_thickness - 1) / 2);
+	const int last = std::min(hi, index + m_thickness / 2);
+
+	bool ok = false;
+	VolumeKernels::dispatch(m_scalarType, [&](auto tag) {
+		using T = VolumeKernels::ValueType<decltype(tag)>;
+		ok = update<T>(first, last);
+		if (ok) writeOutput<T>(index);
+	});
+	if (!ok) {
+		invalidate();
+		return nullptr;
+	}
+	return m_output;
+}
+
+template <typename T>
+bool SlabProjector::update(int first, int last)
+{
+	if (first == m_first && last == m_last) return true;
+
+	// Slide when most of the slab is kept; otherwise fetching everything again is as cheap
+	const int keep = m_thickness / 2;
+	const bool valid = m_first <= m_last && m_steps < kRebuildSteps;
+	const bool forward = first >= m_first && last >= m_last && first - m_first <= keep && last - m_last <= keep;
+	const bool backward = first <= m_first && last <= m_last && m_first - first <= keep && m_last - last <= keep;
+	if (!valid || !(forward || backward)) return rebuild<T>(first, last);
+
+	// One entering and/or one leaving slice per step; the window is never wider than the ring
+	const int f0 = m_first;
+	const int l0 = m_last;
+	if (forward) {
+		const int leaves = first - f0;
+		const int enters = last - l0;
+		for (int i = 0; i < std::max(leaves, enters); ++i) {
+			const int leave = i < leaves ? f0 + i : kNone;
+			const int enter = i < enters ? l0 + 1 + i : kNone;
+			if (!step<T>(leave, enter, f0 + std::min(i + 1, leaves), l0 + std::min(i + 1, enters))) return false;
+		}
+	}
+	else {
+		const int leaves = l0 - last;
+		const int enters = f0 - first;
+		for (int i = 0; i < std::max(leaves, enters); ++i) {
+			const int leave = i < leaves ? l0 - i : kNone;
+			const int enter = i < enters ? f0 - 1 - i : kNone;
+			if (!step<T>(leave, enter, f0 - std::min(i + 1, enters), l0 - std::min(i + 1, leaves))) return false;
+		}
+	}
+	++m_steps;
+	return true;
+}
+
+template <typename T>
+bool SlabProjector::rebuild(int first, int last)
+{
+	const std::size_t sliceBytes = m_pixels * sizeof(T);
+	m_ring.resize(sliceBytes * static_cast<std::size_t>(m_thickness));
+	for (int i = first; i <= last; ++i) {
+		if (!fetch(i)) return false;
+		std::memcpy(slot(i), m_fetched->GetScalarPointer(), sliceBytes);
+	}
+
+	// Slices outer, pixels inner: each pass over a band is a straight vector loop
+	if (m_mode == Mean) {
+		m_sum.assign(m_pixels, 0.0);
+		double* sum = m_sum.data();
+		forEachBand(m_rows, m_rowLength, [&](vtkIdType begin, vtkIdType end) {
+			for (int i = first; i <= last; ++i) {
+				const T* in = reinterpret_cast<const T*>(slot(i));
+				for (vtkIdType p = begin; p < end; ++p) sum[p] += static_cast<double>(in[p]);
+			}
+		});
+	}
+	else {
+		const bool isMax = m_mode == Maximum;
+		m_extreme.resize(sliceBytes);
+		T* ext = reinterpret_cast<T*>(m_extreme.data());
+		forEachBand(m_rows, m_rowLength, [&](vtkIdType begin, vtkIdType end) {
+			std::memcpy(ext + begin, slot(first) + begin * sizeof(T), static_cast<std::size_t>(end - begin) * sizeof(T));
+			for (int i = first + 1; i <= last; ++i) {
+				const T* in = reinterpret_cast<const T*>(slot(i));
+				if (isMax) for (vtkIdType p = begin; p < end; ++p) ext[p] = pick<T, true>(ext[p], in[p]);
+				else       for (vtkIdType p = begin; p < end; ++p) ext[p] = pick<T, false>(ext[p], in[p]);
+			}
+		});
+	}
+
+	m_first = first;
+	m_last = last;
+	m_steps = 0;
+	return true;
+}
+
+template <typename T>
+bool SlabProjector::step(int leave, int enter, int first, int last)
+{
+	if (enter != kNone && !fetch(enter)) return false;
+
+	const T* in = enter != kNone ? static_cast<const T*>(m_fetched->GetScalarPointer()) : nullptr;
+	T* inSlot = enter != kNone ? reinterpret_cast<T*>(slot(enter)) : nullptr;
+	// May alias inSlot (a full slab moving by one): each pixel is read before it is replaced
+	const T* out = leave != kNone ? reinterpret_cast<const T*>(slot(leave)) : nullptr;
+
+	if (m_mode == Mean) {
+		double* sum = m_sum.data();
+		forEachBand(m_rows, m_rowLength, [&](vtkIdType begin, vtkIdType end) {
+			for (vtkIdType p = begin; p < end; ++p) {
+				const double o = out ? static_cast<double>(out[p]) : 0.0;
+				const double v = in ? static_cast<double>(in[p]) : 0.0;
+				sum[p] += v - o;
+				if (inSlot) inSlot[p] = in[p];
+			}
+		});
+	}
+	else {
+		m_rescan.resize(m_pixels);
+		auto slabSlice = [this](int i) { return reinterpret_cast<const T*>(slot(i)); };
+		T* ext = reinterpret_cast<T*>(m_extreme.data());
+		if (m_mode == Maximum) stepExtreme<T, true>(ext, out, in, inSlot, m_rescan.data(), m_rows, m_rowLength, first, last, slabSlice);
+		else stepExtreme<T, false>(ext, out, in, inSlot, m_rescan.data(), m_rows, m_rowLength, first, last, slabSlice);
+	}
+
+	m_first = first;
+	m_last = last;
+	return true;
+}
+
+template <typename T>
+void SlabProjector::writeOutput(int index)
+{
+	int ext[6];
+	std::copy(m_extent, m_extent + 6, ext);
+	ext[2 * m_axis] = ext[2 * m_axis + 1] = index;
+	double spacing[3];
+	double origin[3];
+	m_provider->getSpacing(spacing);
+	m_provider->getOrigin(origin);
+
+	m_output->SetExtent(ext);
+	m_output->SetSpacing(spacing);
+	m_output->SetOrigin(origin);
+	m_output->AllocateScalars(m_scalarType, 1);
+	T* dst = static_cast<T*>(m_output->GetScalarPointer());
+
+	const vtkIdType n = static_cast<vtkIdType>(m_pixels);
+	if (m_mode == Mean) {
+		const double inv = 1.0 / static_cast<double>(m_last - m_first + 1);
+		VolumeKernels::map(m_sum.data(), dst, n, [inv](double s) { return fromMean<T>(s * inv); });
+	}
+	else {
+		std::memcpy(dst, m_extreme.data(), m_pixels * sizeof(T));
+	}
+	m_output->Modified();
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vtkSmartPointer.h>
+#include <vtkType.h>
+
+#include <memory>
+#include <vector>
+
+class SliceProvider;
+class vtkImageData;
+
+// Thick-slab projection (MIP, MinIP, mean) along one axis of a SliceProvider.
+//
+// The slab centered on slice c covers [c - (N-1)/2, c + N/2], clipped to the extent. Its
+// slices are kept in a ring (slice i in slot i mod N), and moving the slab by a few
+// slices only fetches the slices that enter it:
+//   mean      running sum: add the entering slice, subtract the leaving one
+//   max/min   running extreme: the entering slice is folded in; only pixels where the
+//             leaving slice held the extreme are rescanned over the ring, which on real
+//             data is about 1/N of them, so a step costs O(1) per pixel on average
+// Larger jumps, and every 256 incremental steps (to bound float drift in the sum),
+// rebuild the slab from scratch. Pixel loops run over bands of whole rows on the SMP
+// backend (VolumeKernels::forEachSlab) and are written to auto-vectorize.
+//
+// Holds `thickness` slices in memory. Single-component slices only; the output has the
+// provider's scalar type.
+class SlabProjector
+{
+public:
+	enum Mode { Maximum, Minimum, Mean };
+
+	SlabProjector(std::shared_ptr<SliceProvider> provider, int axis);
+	~SlabProjector();
+
+	SlabProjector(const SlabProjector&) = delete;
+	SlabProjector& operator=(const SlabProjector&) = delete;
+
+	void setMode(Mode mode);
+	Mode mode() const { return m_mode; }
+	// Slab thickness in slices (>= 1)
+	void setThickness(int slices);
+	int thickness() const { return m_thickness; }
+	int axis() const { return m_axis; }
+
+	// Projection of the slab centered on `index`, as a one-slice image at `index`. The
+	// image is owned by the projector and reused by the next call; nullptr when the
+	// provider cannot supply the slices.
+	vtkImageData* project(int index);
+
+private:
+	template <typename T> bool update(int first, int last);
+	template <typename T> bool rebuild(int first, int last);
+	template <typename T> bool step(int leave, int enter, int first, int last);
+	template <typename T> void writeOutput(int index);
+
+	// Slice `index` into m_fetched; false if the provider cannot supply it
+	bool fetch(int index);
+	unsigned char* slot(int index);
+	void invalidate() { m_first = 0; m_last = -1; }
+
+	std::shared_ptr<SliceProvider> m_provider;
+	int m_axis = 2;
+	Mode m_mode = Maximum;
+	int m_thickness = 1;
+
+	int m_extent[6] = { 0, -1, 0, -1, 0, -1 };
+	int m_scalarType = 0;
+	int m_elementSize = 0;
+	std::size_t m_pixels = 0;     // per slice
+	int m_rows = 0;               // slice rows of m_rowLength pixels
+	vtkIdType m_rowLength = 0;
+
+	// Current window [m_first, m_last]; empty when m_first > m_last
+	int m_first = 0;
+	int m_last = -1;
+	int m_steps = 0;              // incremental steps since the last rebuild
+
+	std::vector<unsigned char> m_ring;     // m_thickness slices of m_pixels values
+	std::vector<unsigned char> m_extreme;  // running max/min (scalar type)
+	std::vector<double> m_sum;             // running sum (mean)
+	std::vector<unsigned char> m_rescan;   // pixels whose extreme left the slab
+	vtkSmartPointer<vtkImageData> m_fetched; // provider output for one slice
+	vtkSmartPointer<vtkImageData> m_output;
+};
@@ -0,0 +1,160 @@
+#include "SliceCache.h"
+#include "SliceProvider.h"
+
+#include <vtkImageData.h>
+
+#include <QThreadPool>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+	// Shared by all views: slice extraction is memory-bound and already runs on the SMP
+	// backend, so a couple of workers keep ahead of scrolling without starving rendering
+	QThreadPool* prefetchPool()
+	{
+		static QThreadPool* pool = [] {
+			auto* p = new QThreadPool();
+			p->setMaxThreadCount(2);
+			return p;
+		}();
+		return pool;
+	}
+
+	class PrefetchJob : public QRunnable
+	{
+	public:
+		template <typename F>
+		explicit PrefetchJob(F&& f) : m_run(std::forward<F>(f)) {}
+		void run() override { m_run(); }
+
+	private:
+		std::function<void()> m_run;
+	};
+}
+
+struct SliceCache::State
+{
+	struct Entry
+	{
+		int index = 0;
+		vtkSmartPointer<vtkImageData> image;
+	};
+
+	std::shared_ptr<SliceProvider> provider;
+	int axis = 2;
+	int depth = 0;
+
+	std::mutex mutex;
+	std::vector<Entry> ring;
+	std::unordered_set<int> queued;  // indices with a job in the pool
+	int center = 0;                  // window of the latest prefetch()
+	std::atomic<bool> cancelled{ false };
+
+	std::size_t slot(int index) const
+	{
+		const int n = static_cast<int>(ring.size());
+		return static_cast<std::size_t>(((index % n) + n) % n);
+	}
+
+	// Caller holds the mutex
+	vtkSmartPointer<vtkImageData> lookup(int index) const
+	{
+		const Entry& e = ring[slot(index)];
+		return (e.image && e.index == index) ? e.image : nullptr;
+	}
+
+	vtkSmartPointer<vtkImageData> extract(int index)
+	{
+		auto image = vtkSmartPointer<vtkImageData>::New();
+		if (!provider->extractSlice(axis, index, image)) return nullptr;
+		return image;
+	}
+};
+
+SliceCache::SliceCache(std::shared_ptr<SliceProvider> provider, int axis, int depth)
+	: m_state(std::make_shared<State>())
+{
+	m_state->provider = std::move(provider);
+	m_state->axis = axis;
+	m_state->depth = std::max(depth, 1);
+	m_state->ring.resize(static_cast<std::size_t>(2 * m_state->depth + 1));
+}
+
+SliceCache::~SliceCache()
+{
+	m_state->cancelled = true;
+}
+
+int SliceCache::axis() const { return m_state->axis; }
+int SliceCache::depth() const { return m_state->depth; }
+
+vtkSmartPointer<vtkImageData> SliceCache::slice(int index)
+{
+	State& s = *m_state;
+	{
+		std::lock_guard<std::mutex> lock(s.mutex);
+		if (auto image = s.lookup(index)) return image;
+	}
+
+	// Miss: extract here (a queued job for the same slice finds it stored and skips)
+	vtkSmartPointer<vtkImageData> image = s.extract(index);
+	if (image) {
+		std::lock_guard<std::mutex> lock(s.mutex);
+		s.ring[s.slot(index)] = State::Entry{ index, image };
+	}
+	return image;
+}
+
+void SliceCache::prefetch(int center, int direction)
+{
+	std::shared_ptr<State> state = m_state;
+	int extent[6];
+	state->provider->getExtent(extent);
+	const int lo = extent[2 * state->axis];
+	const int hi = extent[2 * state->axis + 1];
+
+	// Most of the window ahead, a quarter behind; nearest slices first
+	const int depth = state->depth;
+	const int behind = direction == 0 ? depth : std::max(1, depth / 4);
+	const int step = direction < 0 ? -1 : 1;
+	std::vector<int> wanted;
+	wanted.reserve(static_cast<std::size_t>(depth + behind));
+	for (int d = 1; d <= depth; ++d) {
+		wanted.push_back(center + step * d);
+		if (d <= behind) wanted.push_back(center - step * d);
+	}
+
+	std::lock_guard<std::mutex> lock(state->mutex);
+	state->center = center;
+	for (int index : wanted) {
+		if (index < lo || index > hi) continue;
+		if (state->lookup(index) || state->queued.count(index)) continue;
+		state->queued.insert(index);
+
+		prefetchPool()->start(new PrefetchJob([state, index]() {
+			{
+				// Skip slices that were extracted meanwhile or that the window has moved past
+				std::lock_guard<std::mutex> lock(state->mutex);
+				if (state->cancelled || state->lookup(index) || std::abs(index - state->center) > state->depth) {
+					state->queued.erase(index);
+					return;
+				}
+			}
+
+			vtkSmartPointer<vtkImageData> image = state->extract(index);
+
+			std::lock_guard<std::mutex> lock(state->mutex);
+			state->queued.erase(index);
+			// Only store slices still inside the window, so the slot is not needed elsewhere
+			if (image && !state->cancelled && std::abs(index - state->center) <= state->depth) {
+				state->ring[state->slot(index)] = State::Entry{ index, image };
+			}
+		}));
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vtkSmartPointer.h>
+
+#include <memory>
+
+class SliceProvider;
+class vtkImageData;
+
+// Per-view ring of extracted slices with background prefetch.
+//
+// The ring holds 2 * depth + 1 slots and slice i lives in slot i mod capacity, so every
+// slice within `depth` of the current one has its own slot and an entry is only replaced
+// once it has left that window. prefetch() queues the next `depth` slices in the
+// direction of motion (and a few behind, for reversals) on a small shared thread pool;
+// slice() returns a cached slice or extracts it synchronously on a miss.
+//
+// Cached images are never modified after they are stored (a replaced slot gets a new
+// image), so a mapper may keep rendering a slice while workers fill other slots.
+class SliceCache
+{
+public:
+	SliceCache(std::shared_ptr<SliceProvider> provider, int axis, int depth);
+	// Pending prefetches are abandoned; the destructor does not wait for running ones
+	~SliceCache();
+
+	SliceCache(const SliceCache&) = delete;
+	SliceCache& operator=(const SliceCache&) = delete;
+
+	// Slice `index` along the cache's axis; nullptr if the provider cannot supply it
+	vtkSmartPointer<vtkImageData> slice(int index);
+
+	// Queue the slices around `center`; `direction` is the sign of the last step (0: both ways)
+	void prefetch(int center, int direction);
+
+	int axis() const;
+	int depth() const;
+
+private:
+	struct State;
+	std::shared_ptr<State> m_state; // shared with queued jobs
+};
@@ -0,0 +1,115 @@
+#include "SliceCompositor.h"
+#include "VolumeKernels.h"
+#include "WindowLevelKernel.h"
+
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+
+#include <cstddef>
+
+vtkStandardNewMacro(SliceCompositor);
+
+namespace {
+	// Rows run along the first axis of `ext` with more than one sample. In a YZ slice that
+	// axis is strided in the input, so its rows are gathered through a buffer first; the
+	// output only holds the requested extent and is always contiguous along the row.
+	template <typename T>
+	void compositeExtent(vtkImageData* input, vtkImageData* output, const int ext[6], double shift, double scale,
+		const std::uint32_t* table)
+	{
+		int r = 0;
+		while (r < 2 && ext[2 * r] == ext[2 * r + 1]) ++r;
+		const int p = r == 0 ? 1 : 0;
+		const int q = r == 2 ? 1 : 2;
+		const std::size_t n = static_cast<std::size_t>(ext[2 * r + 1] - ext[2 * r] + 1);
+
+		// Increments are in scalar units; the input has one component, the output four
+		vtkIdType inInc[3];
+		vtkIdType outInc[3];
+		input->GetIncrements(inInc);
+		output->GetIncrements(outInc);
+
+		const T* inBase = static_cast<const T*>(input->GetScalarPointerForExtent(const_cast<int*>(ext)));
+		unsigned char* outBase = static_cast<unsigned char*>(output->GetScalarPointerForExtent(const_cast<int*>(ext)));
+
+		const bool contiguous = inInc[r] == 1;
+		std::vector<T> row(contiguous ? 0 : n);
+
+		for (int j = ext[2 * q]; j <= ext[2 * q + 1]; ++j) {
+			const vtkIdType dj = static_cast<vtkIdType>(j - ext[2 * q]);
+			for (int i = ext[2 * p]; i <= ext[2 * p + 1]; ++i) {
+				const vtkIdType di = static_cast<vtkIdType>(i - ext[2 * p]);
+				const T* in = inBase + di * inInc[p] + dj * inInc[q];
+				auto* out = reinterpret_cast<std::uint32_t*>(outBase + di * outInc[p] + dj * outInc[q]);
+				if (!contiguous) {
+					for (std::size_t s = 0; s < n; ++s) row[s] = in[static_cast<vtkIdType>(s) * inInc[r]];
+					in = row.data();
+				}
+				WindowLevelKernel::toRGBA(in, out, n, shift, scale, table);
+			}
+		}
+	}
+}
+
+SliceCompositor::SliceCompositor()
+{
+	// Split into whole rows across the SMP backend; a single slice has no z to split along
+	this->SetEnableSMP(true);
+	this->SetSplitModeToBeam();
+	this->SetOutputFormatToRGBA();
+}
+
+void SliceCompositor::setColorTable(const std::vector<std::uint32_t>& table)
+{
+	if (!table.empty() && table.size() != 256) return;
+	if (table == m_colorTable) return;
+	m_colorTable = table;
+	this->Modified();
+}
+
+int SliceCompositor::RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+	vtkInformationVector* outputVector)
+{
+	if (m_colorTable.empty()) return this->Superclass::RequestData(request, inputVector, outputVector);
+
+	// The superclass hands unsigned char input through untouched at window 255 / level 127.5,
+	// which would skip the colour table
+	if (this->DataWasPassed) {
+		if (vtkImageData* output = vtkImageData::GetData(outputVector)) output->GetPointData()->SetScalars(nullptr);
+		this->DataWasPassed = 0;
+	}
+	return this->vtkThreadedImageAlgorithm::RequestData(request, inputVector, outputVector);
+}
+
+void SliceCompositor::ThreadedRequestData(vtkInformation* request, vtkInformationVector** inputVector,
+	vtkInformationVector* outputVector, vtkImageData*** inData, vtkImageData** outData,
+	int outExt[6], int threadId)
+{
+	vtkImageData* input = inData[0][0];
+	vtkImageData* output = outData[0];
+
+	const bool fastPath = input && output && !this->GetLookupTable() &&
+		input->GetNumberOfScalarComponents() == 1 &&
+		output->GetScalarType() == VTK_UNSIGNED_CHAR &&
+		output->GetNumberOfScalarComponents() == 4;
+
+	if (!fastPath || outExt[0] > outExt[1] || outExt[2] > outExt[3] || outExt[4] > outExt[5]) {
+		this->Superclass::ThreadedRequestData(request, inputVector, outputVector, inData, outData, outExt, threadId);
+		return;
+	}
+
+	// Same mapping as vtkImageMapToWindowLevelColors
+	const double window = this->GetWindow();
+	const double shift = window / 2.0 - this->GetLevel();
+	const double scale = 255.0 / window;
+	const std::uint32_t* table = m_colorTable.empty() ? nullptr : m_colorTable.data();
+
+	const bool known = VolumeKernels::dispatch(input->GetScalarType(), [&](auto tag) {
+		compositeExtent<VolumeKernels::ValueType<decltype(tag)>>(input, output, outExt, shift, scale, table);
+	});
+	if (!known) {
+		this->Superclass::ThreadedRequestData(request, inputVector, outputVector, inData, outData, outExt, threadId);
+	}
+}
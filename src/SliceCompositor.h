@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vtkImageMapToWindowLevelColors.h>
+
+#include <cstdint>
+#include <vector>
+
+// Window/level (and optional colour table) to 8-bit RGBA on the CPU, for SliceView.
+//
+// Sits between a slice source and vtkImageSliceMapper. The mapper streams only the
+// displayed slice, so only that slice is converted; rows are split across all cores
+// through the vtkSMPTools backend and each row goes through the SIMD kernels in
+// WindowLevelKernel.h. The mapper then uploads the RGBA result as one texture without
+// further conversion when its property is at window 255 / level 127.5.
+//
+// Single-component input without a vtkScalarsToColors lookup table takes this path and
+// matches vtkImageMapToWindowLevelColors exactly; anything else falls back to it.
+class SliceCompositor : public vtkImageMapToWindowLevelColors
+{
+public:
+	static SliceCompositor* New();
+	vtkTypeMacro(SliceCompositor, vtkImageMapToWindowLevelColors);
+
+	// 256 packed RGBA words (R in the low byte) indexed by the windowed grey level; an
+	// empty table gives opaque grey. Only the fast path applies it.
+	void setColorTable(const std::vector<std::uint32_t>& table);
+	const std::vector<std::uint32_t>& colorTable() const { return m_colorTable; }
+
+protected:
+	SliceCompositor();
+	~SliceCompositor() override = default;
+
+	int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+		vtkInformationVector* outputVector) override;
+
+	void ThreadedRequestData(vtkInformation* request, vtkInformationVector** inputVector,
+		vtkInformationVector* outputVector, vtkImageData*** inData, vtkImageData** outData,
+		int outExt[6], int threadId) override;
+
+private:
+	SliceCompositor(const SliceCompositor&) = delete;
+	void operator=(const SliceCompositor&) = delete;
+
+	std::vector<std::uint32_t> m_colorTable;
+};
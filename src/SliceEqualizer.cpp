@@ -0,0 +1,198 @@
+#include "SliceEqualizer.h"
+#include "VolumeKernels.h"
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace {
+	using Histogram = std::array<std::uint32_t, SliceEqualizer::Bins>;
+
+	// Grey mapping (0..1 per bin) of the w x h tile at (x0, y0) of a bin image of width `stride`
+	void tileMapping(const std::uint8_t* bins, int stride, int x0, int y0, int w, int h, double clipLimit, float* map)
+	{
+		Histogram hist{};
+		for (int y = y0; y < y0 + h; ++y) {
+			const std::uint8_t* row = bins + static_cast<std::size_t>(y) * stride + x0;
+			for (int x = 0; x < w; ++x) ++hist[row[x]];
+		}
+
+		const std::uint32_t count = static_cast<std::uint32_t>(w) * static_cast<std::uint32_t>(h);
+		if (clipLimit > 0.0) {
+			const std::uint32_t limit = std::max<std::uint32_t>(1,
+				static_cast<std::uint32_t>(clipLimit * count / SliceEqualizer::Bins));
+			std::uint32_t excess = 0;
+			for (std::uint32_t& n : hist) {
+				if (n > limit) {
+					excess += n - limit;
+					n = limit;
+				}
+			}
+			// Spread the clipped counts evenly; the remainder goes to evenly spaced bins
+			const std::uint32_t share = excess / SliceEqualizer::Bins;
+			const std::uint32_t rest = excess % SliceEqualizer::Bins;
+			for (std::uint32_t& n : hist) n += share;
+			if (rest > 0) {
+				const std::uint32_t step = SliceEqualizer::Bins / rest;
+				for (std::uint32_t i = 0, b = 0; i < rest; ++i, b += step) ++hist[b];
+			}
+		}
+
+		const float norm = 1.0f / static_cast<float>(count);
+		std::uint32_t cdf = 0;
+		for (int b = 0; b < SliceEqualizer::Bins; ++b) {
+			cdf += hist[b];
+			map[b] = static_cast<float>(cdf) * norm;
+		}
+	}
+
+	// Interpolation between tile centres along one axis: tiles a and b with weight f of b
+	struct Blend
+	{
+		int a;
+		int b;
+		float f;
+	};
+
+	std::vector<Blend> blends(int size, int tiles)
+	{
+		std::vector<Blend> out(size);
+		for (int i = 0; i < size; ++i) {
+			const double g = (i + 0.5) * tiles / size - 0.5;
+			if (g <= 0.0) out[i] = { 0, 0, 0.0f };
+			else if (g >= tiles - 1) out[i] = { tiles - 1, tiles - 1, 0.0f };
+			else {
+				const int a = static_cast<int>(g);
+				out[i] = { a, a + 1, static_cast<float>(g - a) };
+			}
+		}
+		return out;
+	}
+}
+
+void SliceEqualizer::setRange(double lower, double upper)
+{
+	if (lower == m_lower && upper == m_upper) return;
+	m_lower = lower;
+	m_upper = upper;
+	clear();
+}
+
+void SliceEqualizer::setCacheBudget(std::size_t bytes)
+{
+	m_budget = bytes;
+	evict();
+}
+
+void SliceEqualizer::clear()
+{
+	m_entries.clear();
+	m_bytes = 0;
+}
+
+vtkImageData* SliceEqualizer::find(int axis, int index, int variant)
+{
+	for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+		if (it->axis == axis && it->index == index && it->variant == variant && it->parameters == m_parameters) {
+			m_entries.splice(m_entries.begin(), m_entries, it);
+			return m_entries.front().image;
+		}
+	}
+	return nullptr;
+}
+
+vtkImageData* SliceEqualizer::equalize(int axis, int index, int variant, vtkImageData* slice)
+{
+	vtkDataArray* scalars = slice ? slice->GetPointData()->GetScalars() : nullptr;
+	if (!scalars || scalars->GetNumberOfComponents() != 1 || axis < 0 || axis > 2) return nullptr;
+	if (!(m_upper > m_lower)) return nullptr;
+
+	int ext[6];
+	slice->GetExtent(ext);
+	const int u = axis == 0 ? 1 : 0;
+	const int v = axis == 2 ? 1 : 2;
+	const int width = ext[2 * u + 1] - ext[2 * u] + 1;
+	const int height = ext[2 * v + 1] - ext[2 * v] + 1;
+	const vtkIdType n = static_cast<vtkIdType>(width) * height;
+	if (width <= 0 || height <= 0 || scalars->GetNumberOfTuples() != n) return nullptr;
+
+	// Bin once; tiles and the blend both read the bins
+	std::vector<std::uint8_t> bins(static_cast<std::size_t>(n));
+	const double lower = m_lower;
+	const double toBin = Bins / (m_upper - m_lower);
+	const bool known = VolumeKernels::dispatch(scalars->GetDataType(), [&](auto tag) {
+		using T = VolumeKernels::ValueType<decltype(tag)>;
+		VolumeKernels::map(static_cast<const T*>(scalars->GetVoidPointer(0)), bins.data(), n, [lower, toBin](T value) {
+			double b = (static_cast<double>(value) - lower) * toBin;
+			if (b > Bins - 1) b = Bins - 1;
+			if (!(b >= 0.0)) b = 0.0; // also catches NaN
+			return static_cast<std::uint8_t>(b);
+		});
+	});
+	if (!known) return nullptr;
+
+	const int tilesX = std::clamp(m_parameters.tiles, 1, width);
+	const int tilesY = std::clamp(m_parameters.tiles, 1, height);
+	std::vector<float> maps(static_cast<std::size_t>(tilesX) * tilesY * Bins);
+	const double clipLimit = m_parameters.clipLimit;
+	vtkSMPTools::For(0, static_cast<vtkIdType>(tilesX) * tilesY, 1, [&](vtkIdType begin, vtkIdType end) {
+		for (vtkIdType t = begin; t < end; ++t) {
+			const int tx = static_cast<int>(t % tilesX);
+			const int ty = static_cast<int>(t / tilesX);
+			const int x0 = tx * width / tilesX;
+			const int y0 = ty * height / tilesY;
+			const int x1 = (tx + 1) * width / tilesX;
+			const int y1 = (ty + 1) * height / tilesY;
+			tileMapping(bins.data(), width, x0, y0, x1 - x0, y1 - y0, clipLimit, maps.data() + t * Bins);
+		}
+	});
+
+	auto out = vtkSmartPointer<vtkImageData>::New();
+	out->SetExtent(ext);
+	out->SetSpacing(slice->GetSpacing());
+	out->SetOrigin(slice->GetOrigin());
+	out->AllocateScalars(VTK_FLOAT, 1);
+	float* result = static_cast<float*>(out->GetScalarPointer());
+
+	const std::vector<Blend> bx = blends(width, tilesX);
+	const std::vector<Blend> by = blends(height, tilesY);
+	const float base = static_cast<float>(m_lower);
+	const float span = static_cast<float>(m_upper - m_lower);
+	vtkSMPTools::For(0, height, [&](vtkIdType begin, vtkIdType end) {
+		for (vtkIdType y = begin; y < end; ++y) {
+			const Blend& ry = by[y];
+			const float* top = maps.data() + static_cast<std::size_t>(ry.a) * tilesX * Bins;
+			const float* bottom = maps.data() + static_cast<std::size_t>(ry.b) * tilesX * Bins;
+			const std::uint8_t* in = bins.data() + static_cast<std::size_t>(y) * width;
+			float* row = result + static_cast<std::size_t>(y) * width;
+			for (int x = 0; x < width; ++x) {
+				const Blend& rx = bx[x];
+				const int b = in[x];
+				const float t = top[rx.a * Bins + b] + rx.f * (top[rx.b * Bins + b] - top[rx.a * Bins + b]);
+				const float d = bottom[rx.a * Bins + b] + rx.f * (bottom[rx.b * Bins + b] - bottom[rx.a * Bins + b]);
+				row[x] = base + span * (t + ry.f * (d - t));
+			}
+		}
+	});
+
+	const std::size_t bytes = static_cast<std::size_t>(n) * sizeof(float);
+	m_entries.push_front({ axis, index, variant, m_parameters, out, bytes });
+	m_bytes += bytes;
+	evict();
+	// The newest entry stays even when it alone exceeds the budget
+	return m_entries.front().image;
+}
+
+void SliceEqualizer::evict()
+{
+	while (m_bytes > m_budget && m_entries.size() > 1) {
+		m_bytes -= m_entries.back().bytes;
+		m_entries.pop_back();
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vtkSmartPointer.h>
+
+#include <cstddef>
+#include <list>
+
+class vtkImageData;
+
+// Contrast-limited adaptive histogram equalization (CLAHE) of single slices, with a cache
+// of the results.
+//
+// Values are binned over a fixed range (the display range of the whole volume, so a value
+// falls in the same bin on every slice). Each tile of a tiles x tiles grid gets a
+// histogram clipped at clipLimit times the mean bin count, with the excess spread over
+// all bins, and its CDF becomes the tile's grey mapping; every pixel blends the mappings
+// of the four nearest tile centres. One tile without a clip limit is plain histogram
+// equalization. The result is written back into the binning range as float, so
+// window/level and colour maps still apply on top.
+//
+// Results are kept per (axis, slice, source variant, parameters) within a byte budget,
+// least recently used out first, so panning, zooming and scrolling back over equalized
+// slices reuse them.
+class SliceEqualizer
+{
+public:
+	static constexpr int Bins = 256;
+
+	struct Parameters
+	{
+		int tiles = 8;          // per side
+		double clipLimit = 2.0; // times the mean bin count; 0 = unlimited
+		bool operator==(const Parameters& o) const { return tiles == o.tiles && clipLimit == o.clipLimit; }
+	};
+
+	// Binning range; a different range drops the cache
+	void setRange(double lower, double upper);
+	void setParameters(const Parameters& parameters) { m_parameters = parameters; }
+	const Parameters& parameters() const { return m_parameters; }
+	void setCacheBudget(std::size_t bytes);
+	void clear();
+
+	// Cached result for the current parameters, or nullptr. `variant` tells apart different
+	// inputs for the same slice (e.g. slab settings).
+	vtkImageData* find(int axis, int index, int variant);
+	// Equalize `slice` (single component, one sample thick along `axis`) and cache the
+	// result; nullptr if it cannot be equalized
+	vtkImageData* equalize(int axis, int index, int variant, vtkImageData* slice);
+
+private:
+	struct Entry
+	{
+		int axis;
+		int index;
+		int variant;
+		Parameters parameters;
+		vtkSmartPointer<vtkImageData> image;
+		std::size_t bytes;
+	};
+
+	void evict();
+
+	double m_lower = 0.0;
+	double m_upper = 0.0;
+	Parameters m_parameters;
+	std::list<Entry> m_entries; // most recently used first
+	std::size_t m_bytes = 0;
+	std::size_t m_budget = std::size_t(256) << 20;
+};
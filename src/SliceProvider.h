@@ -0,0 +1,27 @@
+#pragma once
+
+class vtkImageData;
+
+// Source of axis-aligned slices for SliceView when the full volume is not held as one
+// contiguous vtkImageData (e.g. compressed or bricked storage).
+//
+// Geometry is that of the full-resolution volume. Slices are returned as one-voxel-thick
+// images that keep the volume's origin and spacing, so their world coordinates (and slice
+// numbers) match the full volume exactly.
+class SliceProvider
+{
+public:
+	virtual ~SliceProvider() = default;
+
+	virtual void getExtent(int extent[6]) const = 0;
+	virtual void getSpacing(double spacing[3]) const = 0;
+	virtual void getOrigin(double origin[3]) const = 0;
+	virtual int scalarType() const = 0;
+
+	// Fill `slice` with the plane normal to `axis` (0 = x, 1 = y, 2 = z) at `index`.
+	// Returns false if the index is outside the extent.
+	virtual bool extractSlice(int axis, int index, vtkImageData* slice) = 0;
+
+	// Single voxel value in native units (probes, analysis tools)
+	virtual double voxelValue(int i, int j, int k) = 0;
+};
@@ -2,8 +2,20 @@
 #include "ui_SliceView.h"
 #include "SunkenSliderStyle.h"
 #include "MenuButton.h"
+#include "SliceProvider.h"
+#include "SliceCache.h"
+#include "SliceCompositor.h"
+#include "ImageResliceHelper.h"
+#include "ImageSliceProvider.h"
+#include "SlabProjector.h"
+#include "SliceEqualizer.h"
+#include "ProfilePlot.h"
+#include "VolumeKernels.h"
+#include "FrameThrottle.h"
+#include "CinePlayer.h"
 
 #include <QAction>
+#include <QActionGroup>
 #include <QMenu>
 #include <QWidget>
 #include <QVBoxLayout>
@@ -19,6 +31,9 @@
 #include <QMouseEvent>
 #include <QTimer>
 #include <QDebug>
+#include <QInputDialog>
+#include <QStyle>
+#include <QToolButton>
 
 #include <vtkRenderWindow.h>
 #include <vtkGenericOpenGLRenderWindow.h>
@@ -28,6 +43,8 @@
 #include <vtkCamera.h>
 #include <vtkImageSliceMapper.h>
 #include <vtkImageSlice.h>
+#include <vtkImageStack.h>
+#include <vtkLookupTable.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkInformation.h>
 #include <vtkImageProperty.h>
@@ -35,6 +52,51 @@
 #include <vtkRenderWindowInteractor.h>
 #include <vtkCommand.h>
 #include <vtkImageShiftScale.h>
+#include <vtkMath.h>
+#include <vtkActor.h>
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkPoints.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkProperty.h>
+
+#include <cmath>
+
+namespace {
+	// Thickness used when a slab operator is picked from single-slice mode
+	constexpr int kDefaultSlabThickness = 10;
+
+	// Cine keeps this much playback extracted ahead, within [kCineMinReadAhead, kCineMaxReadAhead] slices
+	constexpr double kCineReadAheadSeconds = 0.5;
+	constexpr int kCineMinReadAhead = 4;
+	constexpr int kCineMaxReadAhead = 64;
+
+	// Idle time after the last interaction before the full-quality render
+	constexpr int kRefineDelayMs = 150;
+
+	// Plane tilt per pixel of Ctrl+drag
+	constexpr double kObliqueDegreesPerPixel = 0.25;
+
+	// A press this close (in pixels) to a profile end or path point drags it
+	constexpr double kGrabPixels = 6.0;
+
+	// Chords per path segment when drawing the spline
+	constexpr int kPathChordsPerSegment = 16;
+
+	// Rotate v about the unit axis a by `degrees` (Rodrigues)
+	void rotateAbout(double v[3], const double a[3], double degrees)
+	{
+		const double t = vtkMath::RadiansFromDegrees(degrees);
+		const double c = std::cos(t);
+		const double s = std::sin(t);
+		double axv[3];
+		vtkMath::Cross(a, v, axv);
+		const double d = vtkMath::Dot(a, v);
+		for (int i = 0; i < 3; ++i) v[i] = v[i] * c + axv[i] * s + a[i] * d * (1.0 - c);
+	}
+}
 
 SliceView::SliceView(QWidget* parent, ViewOrientation initialOrientation)
 	: ImageFrameWidget(parent)
@@ -114,12 +176,38 @@ SliceView::SliceView(QWidget* parent, ViewOrientation initialOrientation)
 	sliceMapper->SliceFacesCameraOff();
 	sliceMapper->SliceAtFocalPointOff();
 
-	sliceMapper->SetInputConnection(m_shiftScaleFilter->GetOutputPort());
+	// Crosshair: two lines, positioned by updateCrosshair()
+	{
+		auto points = vtkSmartPointer<vtkPoints>::New();
+		points->SetNumberOfPoints(4);
+		auto lines = vtkSmartPointer<vtkCellArray>::New();
+		const vtkIdType first[2] = { 0, 1 };
+		const vtkIdType second[2] = { 2, 3 };
+		lines->InsertNextCell(2, first);
+		lines->InsertNextCell(2, second);
+		m_crosshairPoly = vtkSmartPointer<vtkPolyData>::New();
+		m_crosshairPoly->SetPoints(points);
+		m_crosshairPoly->SetLines(lines);
+
+		auto mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+		mapper->SetInputData(m_crosshairPoly);
+		m_crosshairActor = vtkSmartPointer<vtkActor>::New();
+		m_crosshairActor->SetMapper(mapper);
+		m_crosshairActor->GetProperty()->SetColor(1.0, 0.8, 0.0);
+		m_crosshairActor->GetProperty()->SetLighting(false);
+		m_crosshairActor->PickableOff();
+		m_crosshairActor->VisibilityOff();
+		m_renderer->AddViewProp(m_crosshairActor);
+	}
 
 	this->qvtkConnection = vtkSmartPointer<vtkEventQtSlotConnect>::New();
 	this->qvtkConnection->Connect(interactorStyle, vtkCommand::LeftButtonPressEvent,
 		this, SLOT(trapSpin(vtkObject*)));
 
+	// Oblique mode resamples the visible region before each render
+	this->qvtkConnection->Connect(m_renderer, vtkCommand::StartEvent,
+		this, SLOT(onRendererStart(vtkObject*)));
+
 	m_windowLevelStartPosition[0] = 0;
 	m_windowLevelStartPosition[1] = 0;
 
@@ -145,9 +233,71 @@ SliceView::SliceView(QWidget* parent, ViewOrientation initialOrientation)
 
 		this->qvtkConnection->Connect(interactorStyle, vtkCommand::EndWindowLevelEvent,
 			this, SLOT(onInteractorEndWindowLevel(vtkObject*)), nullptr, -1.0f);
+
+		// Every style drag (pan, zoom, window/level) is bracketed by these
+		this->qvtkConnection->Connect(interactorStyle, vtkCommand::StartInteractionEvent,
+			this, SLOT(onInteractionStart(vtkObject*)));
+		this->qvtkConnection->Connect(interactorStyle, vtkCommand::EndInteractionEvent,
+			this, SLOT(onInteractionEnd(vtkObject*)));
 	}
 
-	connect(ui->sliderSlicePosition, &QSlider::valueChanged, this, &SliceView::setSliceIndex);
+	m_refineTimer = new QTimer(this);
+	m_refineTimer->setSingleShot(true);
+	m_refineTimer->setInterval(kRefineDelayMs);
+	connect(m_refineTimer, &QTimer::timeout, this, &SliceView::refineAfterInteraction);
+
+	// Slider drags emit a value per pixel; apply the newest one at most once per frame
+	m_sliderThrottle = new FrameThrottle(this, [this]() {
+		if (m_pendingSliderValue != m_currentSlice) setSliceIndex(m_pendingSliderValue);
+	});
+	connect(ui->sliderSlicePosition, &QSlider::valueChanged, this, [this](int value) {
+		m_pendingSliderValue = value;
+		m_sliderThrottle->request();
+	});
+	connect(ui->sliderSlicePosition, &QSlider::sliderReleased, m_sliderThrottle, &FrameThrottle::flush);
+
+	// Alt+drag picks the cursor at most once per frame
+	m_cursorThrottle = new FrameThrottle(this, [this]() {
+		int voxel[3];
+		if (voxelAt(m_pendingCursorPos, voxel)) emit cursorPicked(voxel[0], voxel[1], voxel[2]);
+	});
+
+	// Profile drags resample at most once per frame; the plot repaints on its own, so only
+	// a moved segment needs a render
+	m_profileThrottle = new FrameThrottle(this, [this]() {
+		updateProfile();
+		if (!m_profileMoved) return;
+		m_profileMoved = false;
+		updateProfileLine();
+		render();
+	});
+
+	// Path edits redraw and report the path at most once per frame (each report resamples
+	// the reformat)
+	m_pathThrottle = new FrameThrottle(this, [this]() {
+		updatePathLine();
+		render();
+		emit pathEdited(m_path);
+	});
+
+	// Cine frames go through the regular slice path; grabbing the slider stops playback
+	m_cine = new CinePlayer(this);
+	connect(m_cine, &CinePlayer::frame, this, &SliceView::setSliceIndex);
+	connect(m_cine, &CinePlayer::playingChanged, this, [this](bool playing) {
+		m_playButton->setIcon(style()->standardIcon(playing ? QStyle::SP_MediaPause : QStyle::SP_MediaPlay));
+		m_playButton->setToolTip(playing ? tr("Pause") : tr("Play"));
+	});
+	connect(m_cine, &CinePlayer::statistics, this, [this](double fps, int dropped) {
+		m_playButton->setToolTip(tr("Pause (%1 fps, %2 dropped frames)").arg(fps, 0, 'f', 1).arg(dropped));
+	});
+	connect(m_playButton, &QToolButton::clicked, this, [this]() { setCinePlaying(!isCinePlaying()); });
+	connect(ui->sliderSlicePosition, &QSlider::sliderPressed, m_cine, &CinePlayer::stop);
+
+	// Ctrl+drag accumulates plane rotation; apply it once per frame
+	m_rotateThrottle = new FrameThrottle(this, [this]() {
+		rotatePlane(m_pendingRotation[0], m_pendingRotation[1]);
+		m_pendingRotation[0] = m_pendingRotation[1] = 0.0;
+	});
 
 	// Keep only the editor in sync when slice changes (remove "Slice:" label usage)
 	connect(this, &SliceView::sliceChanged, this, [this](int value) {
@@ -200,6 +350,238 @@ void SliceView::createMenuAndActions()
 			setTitle(orientationLabel(m_viewOrientation));
 		});
 	}
+
+	// Display modes and tools live in submenus of checkable actions
+	createSlabMenu();
+	createCineMenu();
+	createColorMenus();
+	createProfileMenu();
+	createPathMenu();
+}
+
+QMenu* SliceView::addViewMenu(const QString& title)
+{
+	MenuButton* mb = menuButton();
+	QMenu* menu = mb ? mb->menu() : nullptr;
+	if (!menu) return nullptr;
+
+	// Insert ahead of the frame's rename/close actions, if any
+	QAction* before = nullptr;
+	bool hasSubmenu = false;
+	for (QAction* act : menu->actions()) {
+		if (act->objectName().startsWith(QLatin1String("SelectionFrame-"))) {
+			before = act;
+			break;
+		}
+		hasSubmenu |= act->menu() != nullptr;
+	}
+	if (!hasSubmenu) menu->insertSeparator(before);
+
+	auto* submenu = new QMenu(title, menu);
+	menu->insertMenu(before, submenu);
+	return submenu;
+}
+
+void SliceView::createSlabMenu()
+{
+	QMenu* menu = addViewMenu(tr("Slab"));
+	if (!menu) return;
+
+	// Action data: the SlabMode, or -1 for a single slice
+	auto* group = new QActionGroup(menu);
+	group->setExclusive(true);
+	struct SlabItem { QString label; int mode; };
+	const SlabItem items[] = {
+		{ tr("Single Slice"), -1 },
+		{ tr("MIP"), SlabMaximum },
+		{ tr("MinIP"), SlabMinimum },
+		{ tr("Mean"), SlabMean }
+	};
+	for (const SlabItem& item : items) {
+		QAction* action = menu->addAction(item.label);
+		action->setCheckable(true);
+		action->setData(item.mode);
+		group->addAction(action);
+	}
+	connect(group, &QActionGroup::triggered, this, [this](QAction* action) {
+		const int mode = action->data().toInt();
+		if (mode < 0) setSlab(m_slabMode, 1);
+		else setSlab(static_cast<SlabMode>(mode), m_slabThickness > 1 ? m_slabThickness : kDefaultSlabThickness);
+	});
+
+	menu->addSeparator();
+	connect(menu->addAction(tr("Thickness...")), &QAction::triggered, this, [this]() {
+		bool ok = false;
+		const int thickness = QInputDialog::getInt(this, tr("Slab Thickness"), tr("Slices:"),
+			m_slabThickness > 1 ? m_slabThickness : kDefaultSlabThickness, 1, 1000, 1, &ok);
+		if (ok) setSlab(m_slabMode, thickness);
+	});
+
+	// The check follows the view, however the slab was last set
+	connect(menu, &QMenu::aboutToShow, this, [this, group]() {
+		const int current = m_slabThickness > 1 ? static_cast<int>(m_slabMode) : -1;
+		for (QAction* action : group->actions()) action->setChecked(action->data().toInt() == current);
+	});
+}
+
+void SliceView::createCineMenu()
+{
+	QMenu* menu = addViewMenu(tr("Cine"));
+	if (!menu) return;
+
+	auto* group = new QActionGroup(menu);
+	group->setExclusive(true);
+	struct ModeItem { QString label; CinePlayer::Mode mode; };
+	const ModeItem items[] = { { tr("Loop"), CinePlayer::Loop }, { tr("Bounce"), CinePlayer::Bounce } };
+	for (const ModeItem& item : items) {
+		QAction* action = menu->addAction(item.label);
+		action->setCheckable(true);
+		action->setData(static_cast<int>(item.mode));
+		group->addAction(action);
+	}
+	connect(group, &QActionGroup::triggered, this, [this](QAction* action) {
+		m_cine->setMode(static_cast<CinePlayer::Mode>(action->data().toInt()));
+	});
+
+	menu->addSeparator();
+	connect(menu->addAction(tr("Frame Rate...")), &QAction::triggered, this, [this]() {
+		bool ok = false;
+		const double fps = QInputDialog::getDouble(this, tr("Cine Frame Rate"), tr("Frames per second:"),
+			m_cine->frameRate(), 0.5, 240.0, 1, &ok);
+		if (ok) m_cine->setFrameRate(fps);
+	});
+
+	connect(menu, &QMenu::aboutToShow, this, [this, group]() {
+		for (QAction* action : group->actions()) action->setChecked(action->data().toInt() == m_cine->mode());
+	});
+}
+
+void SliceView::createColorMenus()
+{
+	if (QMenu* menu = addViewMenu(tr("Colormap"))) {
+		auto* group = new QActionGroup(menu);
+		group->setExclusive(true);
+		for (int p = 0; p < Colormap::PresetCount; ++p) {
+			QAction* action = menu->addAction(QString::fromLatin1(Colormap::name(static_cast<Colormap::Preset>(p))));
+			action->setCheckable(true);
+			action->setData(p);
+			group->addAction(action);
+		}
+		connect(group, &QActionGroup::triggered, this, [this](QAction* action) {
+			setColormap(static_cast<Colormap::Preset>(action->data().toInt()));
+		});
+		connect(menu, &QMenu::aboutToShow, this, [this, group]() {
+			for (QAction* action : group->actions()) action->setChecked(action->data().toInt() == m_colormap);
+		});
+	}
+
+	if (QMenu* menu = addViewMenu(tr("Equalization"))) {
+		auto* group = new QActionGroup(menu);
+		group->setExclusive(true);
+		struct EqualizeItem { QString label; EqualizeMode mode; };
+		const EqualizeItem items[] = {
+			{ tr("None"), EqualizeOff },
+			{ tr("Adaptive (CLAHE)"), EqualizeAdaptive },
+			{ tr("Histogram"), EqualizeGlobal }
+		};
+		for (const EqualizeItem& item : items) {
+			QAction* action = menu->addAction(item.label);
+			action->setCheckable(true);
+			action->setData(static_cast<int>(item.mode));
+			group->addAction(action);
+		}
+		connect(group, &QActionGroup::triggered, this, [this](QAction* action) {
+			setEqualization(static_cast<EqualizeMode>(action->data().toInt()));
+		});
+
+		menu->addSeparator();
+		connect(menu->addAction(tr("CLAHE Parameters...")), &QAction::triggered, this, [this]() {
+			bool ok = false;
+			const int tiles = QInputDialog::getInt(this, tr("CLAHE"), tr("Tiles per side:"), m_claheTiles, 1, 64, 1, &ok);
+			const double clip = ok ? QInputDialog::getDouble(this, tr("CLAHE"), tr("Clip limit (0 = none):"),
+				m_claheClipLimit, 0.0, 100.0, 1, &ok) : 0.0;
+			if (ok) setClaheParameters(tiles, clip);
+		});
+
+		connect(menu, &QMenu::aboutToShow, this, [this, group]() {
+			for (QAction* action : group->actions()) action->setChecked(action->data().toInt() == m_equalization);
+		});
+	}
+}
+
+void SliceView::createProfileMenu()
+{
+	QMenu* menu = addViewMenu(tr("Line Profile"));
+	if (!menu) return;
+
+	QAction* tool = menu->addAction(tr("Profile Tool"));
+	tool->setCheckable(true);
+	connect(tool, &QAction::triggered, this, &SliceView::setProfileTool);
+
+	menu->addSeparator();
+	auto* group = new QActionGroup(menu);
+	group->setExclusive(true);
+	struct InterpolationItem { QString label; LineProfile::Interpolation interpolation; };
+	const InterpolationItem items[] = {
+		{ tr("Nearest"), LineProfile::Nearest },
+		{ tr("Linear"), LineProfile::Linear },
+		{ tr("Cubic"), LineProfile::Cubic }
+	};
+	for (const InterpolationItem& item : items) {
+		QAction* action = menu->addAction(item.label);
+		action->setCheckable(true);
+		action->setData(static_cast<int>(item.interpolation));
+		group->addAction(action);
+	}
+	connect(group, &QActionGroup::triggered, this, [this](QAction* action) {
+		setProfileInterpolation(static_cast<LineProfile::Interpolation>(action->data().toInt()));
+	});
+
+	menu->addSeparator();
+	connect(menu->addAction(tr("Band Width...")), &QAction::triggered, this, [this]() {
+		bool ok = false;
+		const int lines = QInputDialog::getInt(this, tr("Profile Band Width"), tr("Lines averaged (odd):"),
+			m_profileBand, 1, 101, 2, &ok);
+		if (ok) setProfileBandWidth(lines);
+	});
+
+	// The path tool turns the profile tool off, so the check is read back on every show
+	connect(menu, &QMenu::aboutToShow, this, [this, tool, group]() {
+		tool->setChecked(m_profileTool);
+		for (QAction* action : group->actions()) action->setChecked(action->data().toInt() == m_profileInterpolation);
+	});
+}
+
+void SliceView::createPathMenu()
+{
+	QMenu* menu = addViewMenu(tr("Curved Path"));
+	if (!menu) return;
+
+	QAction* tool = menu->addAction(tr("Path Tool"));
+	tool->setCheckable(true);
+	connect(tool, &QAction::triggered, this, &SliceView::setPathTool);
+
+	menu->addSeparator();
+	QAction* removeLast = menu->addAction(tr("Remove Last Point"));
+	connect(removeLast, &QAction::triggered, this, [this]() {
+		if (m_path.empty()) return;
+		std::vector<CurvedReformat::Point> points = m_path;
+		points.pop_back();
+		setPath(points);
+		emit pathEdited(m_path);
+	});
+	QAction* clear = menu->addAction(tr("Clear Path"));
+	connect(clear, &QAction::triggered, this, [this]() {
+		setPath({});
+		emit pathEdited(m_path);
+	});
+
+	// The profile tool turns the path tool off; edits need a path
+	connect(menu, &QMenu::aboutToShow, this, [this, tool, removeLast, clear]() {
+		tool->setChecked(m_pathTool);
+		removeLast->setEnabled(!m_path.empty());
+		clear->setEnabled(!m_path.empty());
+	});
 }
 
 SliceView::~SliceView()
@@ -211,22 +593,227 @@ void SliceView::setInterpolation(Interpolation newInterpolation)
 {
 	if (newInterpolation != m_interpolation) {
 		m_interpolation = newInterpolation;
-		switch (m_interpolation) {
-			case Nearest:
-			imageProperty->SetInterpolationTypeToNearest();
-			break;
-			case Linear:
-			imageProperty->SetInterpolationTypeToLinear();
-			break;
-			case Cubic:
-			imageProperty->SetInterpolationTypeToCubic();
-			break;
-		}
+		applyInterpolation();
 		render();
 		emit interpolationChanged(m_interpolation);
 	}
 }
 
+void SliceView::applyInterpolation()
+{
+	switch (effectiveInterpolation()) {
+		case Nearest:
+		imageProperty->SetInterpolationTypeToNearest();
+		break;
+		case Linear:
+		imageProperty->SetInterpolationTypeToLinear();
+		break;
+		case Cubic:
+		imageProperty->SetInterpolationTypeToCubic();
+		break;
+	}
+	if (m_reslice) setResliceInterpolation();
+}
+
+SliceView::Interpolation SliceView::effectiveInterpolation() const
+{
+	// The enum is ordered by cost
+	return m_lodActive ? std::min(m_interpolation, m_lodFiltering) : m_interpolation;
+}
+
+void SliceView::setInteractionLod(bool enabled, Interpolation filtering, int resolutionDivisor)
+{
+	m_lodEnabled = enabled;
+	m_lodFiltering = filtering;
+	m_lodDivisor = std::max(resolutionDivisor, 1);
+	if (!enabled && m_lodActive) {
+		m_refineTimer->stop();
+		m_lodActive = false;
+		applyInterpolation();
+		render();
+	}
+}
+
+void SliceView::setCpuCompositing(bool enabled)
+{
+	if (enabled == m_cpuCompositing) return;
+
+	if (enabled && !m_compositor) {
+		m_compositor = vtkSmartPointer<SliceCompositor>::New();
+		m_passThroughProperty = vtkSmartPointer<vtkImageProperty>::New();
+		m_passThroughProperty->SetColorWindow(255.0);
+		m_passThroughProperty->SetColorLevel(127.5);
+	}
+
+	// Move the current source across; SetInputData() sources come with a trivial producer
+	if (enabled) {
+		if (sliceMapper->GetNumberOfInputConnections(0) > 0) {
+			m_compositor->SetInputConnection(sliceMapper->GetInputConnection(0, 0));
+			sliceMapper->SetInputConnection(m_compositor->GetOutputPort());
+		}
+		m_cpuCompositing = true;
+	}
+	else {
+		m_cpuCompositing = false;
+		if (m_compositor->GetNumberOfInputConnections(0) > 0) {
+			sliceMapper->SetInputConnection(m_compositor->GetInputConnection(0, 0));
+		}
+		m_compositor->RemoveAllInputConnections(0);
+	}
+	attachSliceProperty();
+	updateInteractorWindowLevelBaseline();
+	syncCompositor();
+	render();
+}
+
+void SliceView::setColormap(Colormap::Preset preset)
+{
+	if (preset == m_colormap) return;
+	m_colormap = preset;
+	applyColormap();
+	render();
+}
+
+void SliceView::applyColormap()
+{
+	// The property spreads the table across the window; the compositor indexes it by grey level
+	if (imageProperty) {
+		imageProperty->SetLookupTable(Colormap::lookupTable(m_colormap));
+		imageProperty->UseLookupTableScalarRangeOff();
+	}
+	m_colormapTable = Colormap::packedTable(m_colormap);
+}
+
+void SliceView::setEqualization(EqualizeMode mode)
+{
+	if (mode == m_equalization) return;
+	m_equalization = mode;
+	if (!m_imageData || !m_imageInitialized) return;
+	if (mode == EqualizeOff) {
+		m_equalizer.reset();
+		if (!m_oblique) connectSliceInput();
+	}
+	updateSlice();
+}
+
+void SliceView::setClaheParameters(int tiles, double clipLimit)
+{
+	m_claheTiles = std::max(tiles, 1);
+	m_claheClipLimit = std::max(clipLimit, 0.0);
+	if (m_equalization == EqualizeAdaptive && m_imageData && m_imageInitialized) updateSlice();
+}
+
+vtkImageData* SliceView::equalizedSlice(vtkImageData* source)
+{
+	if (!m_equalizer) m_equalizer = std::make_unique<SliceEqualizer>();
+
+	// Bin over the display range of the whole volume so every slice uses the same bins
+	m_equalizer->setRange((m_scalarRangeMin + m_scalarShift) * m_scalarScale,
+		(m_scalarRangeMax + m_scalarShift) * m_scalarScale);
+	SliceEqualizer::Parameters parameters;
+	if (m_equalization == EqualizeGlobal) {
+		parameters.tiles = 1;
+		parameters.clipLimit = 0.0;
+	}
+	else {
+		parameters.tiles = m_claheTiles;
+		parameters.clipLimit = m_claheClipLimit;
+	}
+	m_equalizer->setParameters(parameters);
+
+	const int axis = m_viewOrientation;
+	const int variant = m_slabThickness > 1 ? m_slabThickness * 4 + m_slabMode + 1 : 0;
+	if (vtkImageData* cached = m_equalizer->find(axis, m_currentSlice, variant)) return cached;
+
+	// Plain images are sliced only on a cache miss
+	vtkSmartPointer<vtkImageData> slice = source;
+	if (!slice) {
+		slice = vtkSmartPointer<vtkImageData>::New();
+		if (!ImageSliceProvider(displayImage()).extractSlice(axis, m_currentSlice, slice)) return nullptr;
+	}
+	return m_equalizer->equalize(axis, m_currentSlice, variant, slice);
+}
+
+void SliceView::setSliceSource(vtkImageData* image)
+{
+	if (!m_cpuCompositing) {
+		sliceMapper->SetInputData(image);
+		return;
+	}
+	m_compositor->SetInputData(image);
+	if (sliceMapper->GetInputConnection(0, 0) != m_compositor->GetOutputPort()) {
+		sliceMapper->SetInputConnection(m_compositor->GetOutputPort());
+	}
+}
+
+void SliceView::setSliceSource(vtkAlgorithmOutput* port)
+{
+	if (!m_cpuCompositing) {
+		sliceMapper->SetInputConnection(port);
+		return;
+	}
+	m_compositor->SetInputConnection(port);
+	if (sliceMapper->GetInputConnection(0, 0) != m_compositor->GetOutputPort()) {
+		sliceMapper->SetInputConnection(m_compositor->GetOutputPort());
+	}
+}
+
+void SliceView::attachSliceProperty()
+{
+	imageSlice->SetProperty(m_cpuCompositing ? m_passThroughProperty.Get() : imageProperty.Get());
+}
+
+void SliceView::syncCompositor()
+{
+	if (!m_cpuCompositing || !imageProperty) return;
+	// The setters only mark the compositor modified on a change, so an unchanged WL does not
+	// re-execute it
+	m_compositor->SetWindow(imageProperty->GetColorWindow());
+	m_compositor->SetLevel(imageProperty->GetColorLevel());
+	m_compositor->setColorTable(m_colormapTable);
+	m_passThroughProperty->SetInterpolationType(imageProperty->GetInterpolationType());
+}
+
+void SliceView::noteInteraction()
+{
+	if (!m_lodEnabled) return;
+	if (!m_lodActive) {
+		m_lodActive = true;
+		applyInterpolation();
+	}
+	m_refineTimer->start();
+}
+
+bool SliceView::interactionInProgress() const
+{
+	return (interactorStyle && interactorStyle->GetState() != VTKIS_NONE) ||
+		ui->sliderSlicePosition->isSliderDown() || m_rotatingPlane || m_cine->isPlaying();
+}
+
+void SliceView::refineAfterInteraction()
+{
+	if (!m_lodActive) return;
+	// A drag that pauses is still a drag
+	if (interactionInProgress()) {
+		m_refineTimer->start();
+		return;
+	}
+	m_lodActive = false;
+	applyInterpolation();
+	render();
+}
+
+void SliceView::onInteractionStart(vtkObject*)
+{
+	noteInteraction();
+}
+
+void SliceView::onInteractionEnd(vtkObject*)
+{
+	// Refine after the idle delay, not on release: a burst of wheel steps is one interaction
+	if (m_lodActive) m_refineTimer->start();
+}
+
 void SliceView::buildSliderBar(QWidget* rootContent)
 {
 	// Find the original parent layout and index BEFORE reparenting the slider
@@ -264,12 +851,18 @@ void SliceView::buildSliderBar(QWidget* rootContent)
 		}
 	}
 
-	// Build the replacement bar: [minLabel] [slider] [maxLabel] [lineEdit]
+	// Build the replacement bar: [play] [minLabel] [slider] [maxLabel] [lineEdit]
 	QWidget* bar = new QWidget(rootContent);
 	auto* hl = new QHBoxLayout(bar);
 	hl->setContentsMargins(6, 2, 6, 2);
 	hl->setSpacing(6);
 
+	m_playButton = new QToolButton(bar);
+	m_playButton->setAutoRaise(true);
+	m_playButton->setFocusPolicy(Qt::NoFocus);
+	m_playButton->setIcon(style()->standardIcon(QStyle::SP_MediaPlay));
+	m_playButton->setToolTip(tr("Play"));
+
 	// Bracketing labels
 	m_labelMinSlice = new QLabel(QStringLiteral("0"), bar);
 	m_labelMaxSlice = new QLabel(QStringLiteral("0"), bar);
@@ -296,6 +889,7 @@ void SliceView::buildSliderBar(QWidget* rootContent)
 	connect(m_editSliceIndex, &QLineEdit::returnPressed, this, &SliceView::onEditorReturnPressed);
 
 	// Compose (add slider directly, no QFrame wrapper)
+	hl->addWidget(m_playButton, 0, Qt::AlignVCenter);
 	hl->addWidget(m_labelMinSlice, 0, Qt::AlignVCenter);
 	hl->addWidget(ui->sliderSlicePosition, 1);
 	hl->addWidget(m_labelMaxSlice, 0, Qt::AlignVCenter);
@@ -343,6 +937,9 @@ void SliceView::resetCamera()
 		return;
 	}
 
+	// Back to the orthogonal plane
+	endOblique();
+
 	// Remember current slice so we don't jump after re-orthogonalizing
 	const int keepSlice = m_currentSlice;
 
@@ -389,10 +986,31 @@ void SliceView::setImageData(vtkImageData* image) {
 	if (!image) return;
 
 	m_imageData = image;
-
-	// Compute mapping and connect the shared filter
+	m_cine->stop();
+	endOblique();
+	m_slab.reset();
+	m_equalizer.reset();
+	m_profile.reset();
+	m_profileValid = false;
+	m_profileDragEnd = -1;
+	m_path.clear();
+	m_pathDragPoint = -1;
+
+	// Compute mapping and connect the mapper to the display input (mapped copy or native image)
 	computeShiftScaleFromInput();
 	cacheImageGeometry();
+	if (m_sliceProvider) {
+		// Full-resolution geometry comes from the provider; the image is only a preview
+		m_sliceProvider->getExtent(m_extent);
+		m_sliceProvider->getSpacing(m_spacing);
+		m_sliceProvider->getOrigin(m_origin);
+		const int axis = m_viewOrientation;
+		m_sliceProvider->extractSlice(axis, midIndex(m_extent[2 * axis], m_extent[2 * axis + 1]), m_sliceImage);
+		setSliceSource(m_sliceImage);
+	}
+	else {
+		setSliceSource(displayOutputPort());
+	}
 
 	// Ensure mapper orientation matches current view as soon as input exists
 	switch (m_viewOrientation) {
@@ -403,16 +1021,15 @@ void SliceView::setImageData(vtkImageData* image) {
 	}
 
 	if (!m_imageInitialized) {
-		m_renderer->AddViewProp(imageSlice);
+		if (m_imageStack) m_renderer->AddViewProp(m_imageStack);
+		else m_renderer->AddViewProp(imageSlice);
 		imageSlice->PickableOn();
 		m_imageInitialized = true;
 	}
 
-	// Compute a native-domain baseline WL (trim 1% like VolumeView) and retain it	
-	const double diff = m_scalarRangeMax - m_scalarRangeMin;
-	const double lb = diff > 0.0 ? (m_scalarRangeMin + 0.01 * diff) : m_scalarRangeMin;
-	const double ub = diff > 0.0 ? (m_scalarRangeMax - 0.01 * diff) : m_scalarRangeMax;
-	const double baseWindowNative = std::max(ub - lb, 1.0);
+	// Compute a native-domain baseline WL from the histogram percentiles (same as VolumeView) and retain it
+	const auto [lb, ub] = autoWindowBounds();
+	const double baseWindowNative = std::max(ub - lb, minimumWindowNative());
 	const double baseLevelNative = 0.5 * (ub + lb);
 	setBaselineWindowLevel(baseWindowNative, baseLevelNative);
 
@@ -423,12 +1040,12 @@ void SliceView::setImageData(vtkImageData* image) {
 	m_originalBaselineWindowNative = baseWindowNative;
 	m_originalBaselineLevelNative = baseLevelNative;
 
-	// Map baseline to the post-shift/scale domain used by vtkImageProperty
+	// Map baseline to the domain used by vtkImageProperty (identity in DisplayNative)
 	const double lowerNative = baseLevelNative - 0.5 * baseWindowNative;
 	const double upperNative = baseLevelNative + 0.5 * baseWindowNative;
 	const double lowerMapped = (lowerNative + m_scalarShift) * m_scalarScale;
 	const double upperMapped = (upperNative + m_scalarShift) * m_scalarScale;
-	const double mappedWindow = std::max(upperMapped - lowerMapped, 1.0);
+	const double mappedWindow = std::max(upperMapped - lowerMapped, minimumWindowMapped());
 	const double mappedLevel = 0.5 * (upperMapped + lowerMapped);
 
 	imageProperty->SetColorWindow(mappedWindow);
@@ -461,9 +1078,59 @@ void SliceView::setImageData(vtkImageData* image) {
 	setSliceIndex(m_currentSlice);
 }
 
+void SliceView::setSliceProvider(std::shared_ptr<SliceProvider> provider)
+{
+	m_sliceProvider = std::move(provider);
+	m_sliceCache.reset();
+	m_slab.reset();
+	m_equalizer.reset();
+	m_profile.reset();
+	m_sliceInput = static_cast<bool>(m_sliceProvider);
+	if (m_sliceProvider && !m_sliceImage) {
+		m_sliceImage = vtkSmartPointer<vtkImageData>::New();
+	}
+	else if (!m_sliceProvider) {
+		m_sliceImage = nullptr;
+	}
+}
+
+void SliceView::replaceSliceProvider(std::shared_ptr<SliceProvider> provider, double window, double level)
+{
+	if (!m_imageData || !m_imageInitialized) {
+		setSliceProvider(std::move(provider));
+		return;
+	}
+
+	const bool wasNative = rendersNative();
+	setSliceProvider(std::move(provider));
+	if (rendersNative() != wasNative) {
+		computeShiftScaleFromInput();
+		if (m_oblique) m_reslice->SetInputConnection(displayOutputPort());
+	}
+	if (!m_oblique) connectSliceInput();
+	updateSlice();
+	setWindowLevelNative(window, level);
+}
+
+void SliceView::setSlicePrefetch(int depth)
+{
+	depth = std::max(depth, 0);
+	if (m_prefetchDepth == depth) return;
+	m_prefetchDepth = depth;
+	// Rebuilt with the new depth on the next slice change
+	m_sliceCache.reset();
+}
+
 void SliceView::updateData()
 {
-	m_shiftScaleFilter->Update();
+	updateDisplayInput();
+	// Scalars changed in place: drop slices prepared from the old values
+	m_sliceCache.reset();
+	m_slab.reset();
+	m_equalizer.reset();
+	m_profile.reset();
+	endOblique();
+	connectSliceInput();
 
 	imageSlice->Modified();
 	imageSlice->Update();
@@ -472,7 +1139,7 @@ void SliceView::updateData()
 
 	// Set camera and show a valid slice immediately (center)
 	updateCamera();
-	setSliceIndex((m_minSlice + m_maxSlice) / 2);
+	setSliceIndex(midIndex(m_minSlice, m_maxSlice));
 
 	render();
 }
@@ -522,8 +1189,8 @@ void SliceView::updateCamera() {
 	m_renderer->ResetCamera(bounds);
 	m_renderer->ResetCameraClippingRange(bounds);
 
-	// Move current slice to the start of the axis (will be centered later)
-	m_currentSlice = static_cast<int>((m_extent[2 * w] + m_extent[2 * w + 1]) / 2);
+	// Move current slice to the middle of the axis
+	m_currentSlice = midIndex(m_extent[2 * w], m_extent[2 * w + 1]);
 }
 
 void SliceView::setViewOrientation(ImageFrameWidget::ViewOrientation orientation)
@@ -533,6 +1200,8 @@ void SliceView::setViewOrientation(ImageFrameWidget::ViewOrientation orientation
 
 	// First update state
 	m_viewOrientation = orientation;
+	m_cine->stop();
+	endOblique();
 
 	// Now keep title and menu state in sync with the new orientation
 	setTitle(orientationLabel(m_viewOrientation));
@@ -543,19 +1212,15 @@ void SliceView::setViewOrientation(ImageFrameWidget::ViewOrientation orientation
 		return;
 	}
 
-	// Update mapper orientation for the selected plane
-	switch (m_viewOrientation) {
-		case VIEW_ORIENTATION_YZ: sliceMapper->SetOrientationToX(); break; // z-y plane x normal
-		case VIEW_ORIENTATION_XZ: sliceMapper->SetOrientationToY(); break; // x-z plane y normal
-		case VIEW_ORIENTATION_XY:
-		default: sliceMapper->SetOrientationToZ(); break; // x-y plane z normal
-	}
+	// Reconnect the slice input (a slab image covers the old orientation only) and update
+	// the mapper orientation for the selected plane
+	connectSliceInput();
 
 	// Recompute slice range and camera, then pick a visible slice (center)
 
 	updateCamera();
 	updateSliceRange();
-	setSliceIndex((m_minSlice + m_maxSlice) / 2); // also triggers render()
+	setSliceIndex(midIndex(m_minSlice, m_maxSlice)); // also triggers render()
 
 	notifyViewOrientationChanged(); // base helper
 }
@@ -565,14 +1230,22 @@ void SliceView::updateSliceRange() {
 	if (!sliceMapper || sliceMapper->GetNumberOfInputConnections(0) == 0)
 		return;
 
-	// Make sure information is current so min/max are valid
-	sliceMapper->Update();
+	if (m_sliceProvider) {
+		// The mapper only ever holds one slice; the range is the provider's extent
+		m_minSlice = m_extent[2 * m_viewOrientation];
+		m_maxSlice = m_extent[2 * m_viewOrientation + 1];
+	}
+	else {
+		// Make sure information is current so min/max are valid
+		sliceMapper->Update();
 
-	m_minSlice = sliceMapper->GetSliceNumberMinValue();
-	m_maxSlice = sliceMapper->GetSliceNumberMaxValue();
+		m_minSlice = sliceMapper->GetSliceNumberMinValue();
+		m_maxSlice = sliceMapper->GetSliceNumberMaxValue();
+	}
 
 	ui->sliderSlicePosition->setMinimum(m_minSlice);
 	ui->sliderSlicePosition->setMaximum(m_maxSlice);
+	m_cine->setRange(m_minSlice, m_maxSlice);
 
 	// NEW: keep bracket labels in sync with the computed range
 	if (m_labelMinSlice) {
@@ -598,7 +1271,51 @@ void SliceView::updateSliceRange() {
 void SliceView::updateSlice() {
 	if (!m_imageData) return;
 
+	if (m_oblique) {
+		// The slice index moves the plane along its normal; the camera stays in plane coordinates
+		updateObliquePlane();
+		render();
+		return;
+	}
+
+	// Image the mapper is fed for this slice; null when it slices displayOutputPort() itself
+	vtkSmartPointer<vtkImageData> source;
+	if (m_slabThickness > 1) {
+		if (!m_slab || m_slab->axis() != m_viewOrientation) {
+			// Provider slices are native; otherwise project the display scalars the mapper would show
+			std::shared_ptr<SliceProvider> provider = m_sliceProvider;
+			if (!provider) provider = std::make_shared<ImageSliceProvider>(displayImage());
+			m_slab = std::make_unique<SlabProjector>(provider, m_viewOrientation);
+			m_slab->setMode(static_cast<SlabProjector::Mode>(m_slabMode));
+			m_slab->setThickness(m_slabThickness);
+		}
+		source = m_slab->project(m_currentSlice);
+		if (source) setSliceSource(source);
+	}
+	else if (m_sliceProvider && readAheadDepth() > 0) {
+		// A deeper cache (e.g. left over from playback) still serves a shallower read-ahead
+		const int depth = readAheadDepth();
+		if (!m_sliceCache || m_sliceCache->axis() != m_viewOrientation || m_sliceCache->depth() < depth) {
+			m_sliceCache = std::make_unique<SliceCache>(m_sliceProvider, m_viewOrientation, depth);
+		}
+		source = m_sliceCache->slice(m_currentSlice);
+		if (source) setSliceSource(source);
+		const int direction = (m_currentSlice > m_lastSlice) - (m_currentSlice < m_lastSlice);
+		m_sliceCache->prefetch(m_currentSlice, direction);
+	}
+	else if (m_sliceProvider) {
+		m_sliceProvider->extractSlice(m_viewOrientation, m_currentSlice, m_sliceImage);
+		source = m_sliceImage;
+	}
+	if (m_equalization != EqualizeOff) {
+		// Fall back to the plain slice rather than leave the previous result on screen
+		if (vtkImageData* equalized = equalizedSlice(source)) setSliceSource(equalized);
+		else if (source) setSliceSource(source);
+		else setSliceSource(displayOutputPort());
+	}
+	m_lastSlice = m_currentSlice;
 	sliceMapper->SetSliceNumber(m_currentSlice);
+	syncCompositor();
 	sliceMapper->Update();
 
 	int u = 0, v = 1, w = m_viewOrientation;
@@ -627,8 +1344,490 @@ void SliceView::updateSlice() {
 		cam->SetPosition(pos);
 	}
 
+	updateCrosshair();
+	updateLabelOverlay();
+	updateProfileLine();
+	updatePathLine();
 	m_renderer->ResetCameraClippingRange(); // ensure slice is not clipped
 	render();                    // let SceneFrameWidget coalesce
+
+	// The profile follows the slice; resampling only repaints the plot
+	if (m_profileTool) m_profileThrottle->request();
+}
+
+void SliceView::setCursorPosition(int x, int y, int z)
+{
+	const int p[3] = { x, y, z };
+	// The own axis is the slice index; only the in-plane coordinates move the crosshair
+	const int w = m_viewOrientation;
+	bool moved = false;
+	for (int a = 0; a < 3; ++a) {
+		if (m_cursor[a] == p[a]) continue;
+		m_cursor[a] = p[a];
+		moved = moved || a != w;
+	}
+	if (!moved || !m_crosshairVisible) return;
+	updateCrosshair();
+	render();
+}
+
+void SliceView::setCrosshairVisible(bool visible)
+{
+	if (m_crosshairVisible == visible) return;
+	m_crosshairVisible = visible;
+	updateCrosshair();
+	render();
+}
+
+void SliceView::updateCrosshair()
+{
+	if (!m_crosshairVisible || !m_imageData || m_oblique) {
+		m_crosshairActor->VisibilityOff();
+		return;
+	}
+
+	const int w = m_viewOrientation;
+	const int u = (w == 0) ? 1 : 0;
+	const int v = (w == 2) ? 1 : 2;
+
+	// Slightly in front of the slice (towards the camera) so the lines are not hidden by it
+	double vpn[3] = { 0.0, 0.0, 1.0 };
+	if (auto* cam = m_renderer->GetActiveCamera()) cam->GetViewPlaneNormal(vpn);
+	const double depth = m_origin[w] + m_spacing[w] * (m_currentSlice + (vpn[w] < 0.0 ? -0.1 : 0.1));
+
+	double a[3], b[3];
+	a[w] = b[w] = depth;
+	vtkPoints* points = m_crosshairPoly->GetPoints();
+
+	// Line along u through the cursor's v, then along v through its u
+	a[u] = m_origin[u] + m_spacing[u] * m_extent[2 * u];
+	b[u] = m_origin[u] + m_spacing[u] * m_extent[2 * u + 1];
+	a[v] = b[v] = m_origin[v] + m_spacing[v] * m_cursor[v];
+	points->SetPoint(0, a);
+	points->SetPoint(1, b);
+
+	a[v] = m_origin[v] + m_spacing[v] * m_extent[2 * v];
+	b[v] = m_origin[v] + m_spacing[v] * m_extent[2 * v + 1];
+	a[u] = b[u] = m_origin[u] + m_spacing[u] * m_cursor[u];
+	points->SetPoint(2, a);
+	points->SetPoint(3, b);
+
+	points->Modified();
+	m_crosshairActor->VisibilityOn();
+}
+
+void SliceView::setLabelOverlay(vtkImageData* labels, vtkLookupTable* colors)
+{
+	if (!labels) {
+		if (hasLabelOverlay()) {
+			m_labelMapper->RemoveAllInputConnections(0);
+			m_imageStack->RemoveImage(m_labelSlice);
+			render();
+		}
+		return;
+	}
+
+	if (!m_labelMapper) {
+		m_labelMapper = vtkSmartPointer<vtkImageSliceMapper>::New();
+		m_labelMapper->StreamingOn();
+		m_labelMapper->SliceFacesCameraOff();
+		m_labelMapper->SliceAtFocalPointOff();
+
+		m_labelSlice = vtkSmartPointer<vtkImageSlice>::New();
+		m_labelSlice->SetMapper(m_labelMapper);
+		m_labelSlice->PickableOff();
+		vtkImageProperty* prop = m_labelSlice->GetProperty();
+		prop->SetInterpolationTypeToNearest();
+		prop->UseLookupTableScalarRangeOn();
+		prop->SetLayerNumber(1);
+
+		// Coplanar slices only draw in a defined order inside a stack; the grey values
+		// stay the active layer, so window/level interaction still targets them
+		m_imageStack = vtkSmartPointer<vtkImageStack>::New();
+		m_imageStack->AddImage(imageSlice);
+		m_imageStack->SetActiveLayer(0);
+		if (m_imageInitialized) {
+			m_renderer->RemoveViewProp(imageSlice);
+			m_renderer->AddViewProp(m_imageStack);
+			updateInteractorWindowLevelBaseline();
+		}
+	}
+
+	m_labelSlice->GetProperty()->SetLookupTable(colors);
+	m_labelMapper->SetInputData(labels);
+	if (!m_imageStack->HasImage(m_labelSlice)) m_imageStack->AddImage(m_labelSlice);
+	updateLabelOverlay();
+	render();
+}
+
+void SliceView::updateLabelOverlay()
+{
+	if (!hasLabelOverlay()) return;
+	switch (m_viewOrientation) {
+		case VIEW_ORIENTATION_YZ: m_labelMapper->SetOrientationToX(); break;
+		case VIEW_ORIENTATION_XZ: m_labelMapper->SetOrientationToY(); break;
+		case VIEW_ORIENTATION_XY:
+		default:                  m_labelMapper->SetOrientationToZ(); break;
+	}
+	// Only the displayed slice is streamed and mapped through the table
+	m_labelMapper->SetSliceNumber(m_currentSlice);
+	m_labelSlice->SetVisibility(!m_oblique);
+}
+
+void SliceView::setProfileTool(bool enabled)
+{
+	if (m_profileTool == enabled) return;
+	if (enabled) setPathTool(false);
+	m_profileTool = enabled;
+	m_profileDragEnd = -1;
+	if (enabled && !m_profilePlot) {
+		// A tool window of this view; closing it turns the tool off
+		m_profilePlot = new ProfilePlot(this);
+		m_profilePlot->setWindowFlag(Qt::Tool);
+		m_profilePlot->setWindowTitle(tr("Line Profile"));
+		connect(m_profilePlot, &ProfilePlot::closed, this, [this]() { setProfileTool(false); });
+	}
+	if (m_profilePlot) m_profilePlot->setVisible(enabled);
+	updateProfile();
+	updateProfileLine();
+	render();
+}
+
+void SliceView::setProfileInterpolation(LineProfile::Interpolation interpolation)
+{
+	if (m_profileInterpolation == interpolation) return;
+	m_profileInterpolation = interpolation;
+	updateProfile();
+}
+
+void SliceView::setProfileBandWidth(int lines)
+{
+	lines = std::max(1, lines | 1);
+	if (m_profileBand == lines) return;
+	m_profileBand = lines;
+	updateProfile();
+}
+
+bool SliceView::profilePoint(const QPoint& pos, double index[3]) const
+{
+	if (!displayToIndex(pos, index)) return false;
+	for (int a = 0; a < 3; ++a) {
+		index[a] = std::clamp(index[a], static_cast<double>(m_extent[2 * a]), static_cast<double>(m_extent[2 * a + 1]));
+	}
+	return true;
+}
+
+double SliceView::grabRadius() const
+{
+	// Pixel size as in displayToIndex()
+	auto* cam = m_renderer->GetActiveCamera();
+	const int* size = m_renderer->GetSize();
+	if (!cam || size[1] <= 0) return 0.0;
+	return kGrabPixels * ui->renderArea->devicePixelRatioF() * 2.0 * cam->GetParallelScale() / size[1];
+}
+
+int SliceView::profileEndNear(const double index[3]) const
+{
+	if (!m_profileValid || m_profileAxis != m_viewOrientation) return -1;
+
+	const double radius = grabRadius();
+	int nearest = -1;
+	double best = radius * radius;
+	for (int e = 0; e < 2; ++e) {
+		double distance = 0.0;
+		for (int a = 0; a < 3; ++a) {
+			if (a == m_viewOrientation) continue;
+			const double d = (index[a] - m_profileEnds[e][a]) * m_spacing[a];
+			distance += d * d;
+		}
+		if (distance <= best) {
+			best = distance;
+			nearest = e;
+		}
+	}
+	return nearest;
+}
+
+void SliceView::updateProfileLine()
+{
+	if (!m_profileTool || !m_profileValid || m_oblique || !m_imageData || m_profileAxis != m_viewOrientation) {
+		if (m_profileActor) m_profileActor->VisibilityOff();
+		return;
+	}
+
+	if (!m_profileActor) {
+		// The segment and a dot on each end
+		auto points = vtkSmartPointer<vtkPoints>::New();
+		points->SetNumberOfPoints(2);
+		auto lines = vtkSmartPointer<vtkCellArray>::New();
+		const vtkIdType segment[2] = { 0, 1 };
+		lines->InsertNextCell(2, segment);
+		auto verts = vtkSmartPointer<vtkCellArray>::New();
+		for (vtkIdType end = 0; end < 2; ++end) verts->InsertNextCell(1, &end);
+		m_profilePoly = vtkSmartPointer<vtkPolyData>::New();
+		m_profilePoly->SetPoints(points);
+		m_profilePoly->SetLines(lines);
+		m_profilePoly->SetVerts(verts);
+
+		auto mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+		mapper->SetInputData(m_profilePoly);
+		m_profileActor = vtkSmartPointer<vtkActor>::New();
+		m_profileActor->SetMapper(mapper);
+		m_profileActor->GetProperty()->SetColor(0.0, 0.9, 1.0);
+		m_profileActor->GetProperty()->SetLineWidth(1.5);
+		m_profileActor->GetProperty()->SetPointSize(6.0);
+		m_profileActor->GetProperty()->SetLighting(false);
+		m_profileActor->PickableOff();
+		m_renderer->AddViewProp(m_profileActor);
+	}
+
+	// In front of the slice, like the crosshair
+	const int w = m_viewOrientation;
+	double vpn[3] = { 0.0, 0.0, 1.0 };
+	if (auto* cam = m_renderer->GetActiveCamera()) cam->GetViewPlaneNormal(vpn);
+	const double depth = m_origin[w] + m_spacing[w] * (m_currentSlice + (vpn[w] < 0.0 ? -0.1 : 0.1));
+
+	vtkPoints* points = m_profilePoly->GetPoints();
+	for (int e = 0; e < 2; ++e) {
+		double p[3];
+		for (int a = 0; a < 3; ++a) p[a] = m_origin[a] + m_spacing[a] * m_profileEnds[e][a];
+		p[w] = depth;
+		points->SetPoint(e, p);
+	}
+	points->Modified();
+	m_profileActor->VisibilityOn();
+}
+
+void SliceView::updateProfile()
+{
+	if (!m_profileTool || !m_profilePlot) return;
+	if (!m_profileValid || m_oblique || !m_imageData || m_profileAxis != m_viewOrientation) {
+		m_profilePlot->clear();
+		return;
+	}
+
+	if (!m_profile) {
+		// Provider slices are native and full resolution; otherwise slice the native image
+		std::shared_ptr<SliceProvider> provider = m_sliceProvider;
+		if (!provider) provider = std::make_shared<ImageSliceProvider>(m_imageData);
+		m_profile = std::make_unique<LineProfile>(provider);
+	}
+	m_profile->setInterpolation(m_profileInterpolation);
+	m_profile->setBandWidth(m_profileBand);
+
+	double p0[3], p1[3];
+	std::copy(m_profileEnds[0], m_profileEnds[0] + 3, p0);
+	std::copy(m_profileEnds[1], m_profileEnds[1] + 3, p1);
+	p0[m_viewOrientation] = p1[m_viewOrientation] = m_currentSlice;
+	LineProfile::Result result = m_profile->sample(m_viewOrientation, p0, p1);
+	m_profilePlot->setProfile(std::move(result.values), result.step);
+}
+
+void SliceView::setPathTool(bool enabled)
+{
+	if (m_pathTool == enabled) return;
+	if (enabled) setProfileTool(false);
+	m_pathTool = enabled;
+	m_pathDragPoint = -1;
+	updatePathLine();
+	render();
+}
+
+void SliceView::setPath(const std::vector<CurvedReformat::Point>& points)
+{
+	if (points == m_path) return;
+	m_path = points;
+	m_pathDragPoint = std::min(m_pathDragPoint, static_cast<int>(m_path.size()) - 1);
+	updatePathLine();
+	render();
+}
+
+int SliceView::pathPointNear(const double index[3]) const
+{
+	const double radius = grabRadius();
+	int nearest = -1;
+	double best = radius * radius;
+	for (int i = 0; i < static_cast<int>(m_path.size()); ++i) {
+		double distance = 0.0;
+		for (int a = 0; a < 3; ++a) {
+			if (a == m_viewOrientation) continue;
+			const double d = (index[a] - m_path[i][a]) * m_spacing[a];
+			distance += d * d;
+		}
+		if (distance <= best) {
+			best = distance;
+			nearest = i;
+		}
+	}
+	return nearest;
+}
+
+void SliceView::updatePathLine()
+{
+	if (!m_pathTool || m_path.empty() || m_oblique || !m_imageData) {
+		if (m_pathActor) m_pathActor->VisibilityOff();
+		return;
+	}
+
+	if (!m_pathActor) {
+		m_pathPoly = vtkSmartPointer<vtkPolyData>::New();
+		m_pathPoly->SetPoints(vtkSmartPointer<vtkPoints>::New());
+		m_pathPoly->SetLines(vtkSmartPointer<vtkCellArray>::New());
+		m_pathPoly->SetVerts(vtkSmartPointer<vtkCellArray>::New());
+
+		auto mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+		mapper->SetInputData(m_pathPoly);
+		m_pathActor = vtkSmartPointer<vtkActor>::New();
+		m_pathActor->SetMapper(mapper);
+		m_pathActor->GetProperty()->SetColor(1.0, 0.3, 1.0);
+		m_pathActor->GetProperty()->SetLineWidth(1.5);
+		m_pathActor->GetProperty()->SetPointSize(6.0);
+		m_pathActor->GetProperty()->SetLighting(false);
+		m_pathActor->PickableOff();
+		m_renderer->AddViewProp(m_pathActor);
+	}
+
+	// The spline and its control points, flattened just in front of the slice like the crosshair
+	const int w = m_viewOrientation;
+	double vpn[3] = { 0.0, 0.0, 1.0 };
+	if (auto* cam = m_renderer->GetActiveCamera()) cam->GetViewPlaneNormal(vpn);
+	const double depth = m_origin[w] + m_spacing[w] * (m_currentSlice + (vpn[w] < 0.0 ? -0.1 : 0.1));
+
+	const std::vector<CurvedReformat::Point> curve = CurvedReformat::sampleCurve(m_path, kPathChordsPerSegment);
+	const vtkIdType controls = static_cast<vtkIdType>(m_path.size());
+	const vtkIdType chords = static_cast<vtkIdType>(curve.size());
+	vtkPoints* points = m_pathPoly->GetPoints();
+	points->SetNumberOfPoints(controls + chords);
+	auto place = [&](vtkIdType id, const CurvedReformat::Point& index) {
+		double p[3];
+		for (int a = 0; a < 3; ++a) p[a] = m_origin[a] + m_spacing[a] * index[a];
+		p[w] = depth;
+		points->SetPoint(id, p);
+	};
+	for (vtkIdType i = 0; i < controls; ++i) place(i, m_path[i]);
+	for (vtkIdType i = 0; i < chords; ++i) place(controls + i, curve[i]);
+
+	vtkCellArray* verts = m_pathPoly->GetVerts();
+	verts->Reset();
+	for (vtkIdType i = 0; i < controls; ++i) verts->InsertNextCell(1, &i);
+	vtkCellArray* lines = m_pathPoly->GetLines();
+	lines->Reset();
+	if (chords > 1) {
+		std::vector<vtkIdType> ids(static_cast<std::size_t>(chords));
+		for (vtkIdType i = 0; i < chords; ++i) ids[i] = controls + i;
+		lines->InsertNextCell(chords, ids.data());
+	}
+	points->Modified();
+	m_pathPoly->Modified();
+	m_pathActor->VisibilityOn();
+}
+
+bool SliceView::displayToIndex(const QPoint& pos, double index[3]) const
+{
+	if (!m_imageData || m_oblique) return false;
+	auto* cam = m_renderer->GetActiveCamera();
+	const int* size = m_renderer->GetSize();
+	const int* origin = m_renderer->GetOrigin();
+	const int* windowSize = m_renderWindow->GetSize();
+	if (!cam || !cam->GetParallelProjection() || size[0] <= 0 || size[1] <= 0 || !windowSize) return false;
+
+	// The viewport centre shows the focal point and a pixel spans 2 * ParallelScale / height
+	// world units along the camera's right and up axes. Qt positions are in
+	// device-independent pixels, VTK's display coordinates are physical.
+	const double ratio = ui->renderArea->devicePixelRatioF();
+	const double pixel = 2.0 * cam->GetParallelScale() / size[1];
+	const double dx = (pos.x() * ratio - origin[0] - 0.5 * size[0]) * pixel;
+	const double dy = (windowSize[1] - 1 - pos.y() * ratio - origin[1] - 0.5 * size[1]) * pixel;
+
+	double f[3], up[3], n[3], right[3];
+	cam->GetFocalPoint(f);
+	cam->GetViewUp(up);
+	cam->GetViewPlaneNormal(n);
+	const double along = vtkMath::Dot(up, n);
+	for (int a = 0; a < 3; ++a) up[a] -= along * n[a];
+	vtkMath::Normalize(up);
+	vtkMath::Cross(up, n, right);
+
+	const int w = m_viewOrientation;
+	for (int a = 0; a < 3; ++a) {
+		index[a] = a == w ? m_currentSlice : (f[a] + dx * right[a] + dy * up[a] - m_origin[a]) / m_spacing[a];
+	}
+	return true;
+}
+
+bool SliceView::voxelAt(const QPoint& pos, int voxel[3]) const
+{
+	double index[3];
+	if (!displayToIndex(pos, index)) return false;
+	for (int a = 0; a < 3; ++a) {
+		voxel[a] = std::clamp(static_cast<int>(std::lround(index[a])), m_extent[2 * a], m_extent[2 * a + 1]);
+	}
+	return true;
+}
+
+void SliceView::probe(const QPoint& pos)
+{
+	double index[3];
+	int voxel[3];
+	bool inside = displayToIndex(pos, index);
+	for (int a = 0; inside && a < 3; ++a) {
+		voxel[a] = static_cast<int>(std::lround(index[a]));
+		inside = voxel[a] >= m_extent[2 * a] && voxel[a] <= m_extent[2 * a + 1];
+	}
+	if (!inside) {
+		if (m_probeInside) {
+			m_probeInside = false;
+			emit probeLeft();
+		}
+		return;
+	}
+	m_probeInside = true;
+	emit voxelProbed(voxel[0], voxel[1], voxel[2], nativeValue(voxel));
+}
+
+double SliceView::nativeValue(const int voxel[3]) const
+{
+	// With a provider, m_imageData may only be a downsampled preview
+	if (m_sliceProvider) return m_sliceProvider->voxelValue(voxel[0], voxel[1], voxel[2]);
+
+	vtkDataArray* scalars = m_imageData->GetPointData()->GetScalars();
+	if (!scalars) return 0.0;
+	int ext[6];
+	m_imageData->GetExtent(ext);
+	vtkIdType inc[3];
+	m_imageData->GetIncrements(inc);
+	const vtkIdType offset = (voxel[0] - ext[0]) * inc[0] + (voxel[1] - ext[2]) * inc[1] + (voxel[2] - ext[4]) * inc[2];
+
+	// First component, straight from the native buffer
+	double value = 0.0;
+	VolumeKernels::dispatch(scalars->GetDataType(), [&](auto tag) {
+		using T = VolumeKernels::ValueType<decltype(tag)>;
+		value = static_cast<double>(static_cast<const T*>(scalars->GetVoidPointer(0))[offset]);
+	});
+	return value;
+}
+
+void SliceView::setCinePlaying(bool playing)
+{
+	if (!playing) {
+		m_cine->stop();
+		return;
+	}
+	if (!m_imageData || m_maxSlice <= m_minSlice) return;
+	m_cine->setRange(m_minSlice, m_maxSlice);
+	m_cine->start(m_currentSlice);
+}
+
+bool SliceView::isCinePlaying() const
+{
+	return m_cine->isPlaying();
+}
+
+int SliceView::readAheadDepth() const
+{
+	if (!m_cine->isPlaying()) return m_prefetchDepth;
+	const int cine = static_cast<int>(std::ceil(m_cine->frameRate() * kCineReadAheadSeconds));
+	return std::max(m_prefetchDepth, std::clamp(cine, kCineMinReadAhead, kCineMaxReadAhead));
 }
 
 int SliceView::getMinSliceIndex() const {
@@ -644,6 +1843,7 @@ void SliceView::setSliceIndex(int index) {
 	int clampedIndex = std::clamp(index, m_minSlice, m_maxSlice);
 
 	m_currentSlice = clampedIndex;
+	m_pendingSliderValue = clampedIndex;
 
 	// Sync slider
 	{
@@ -656,6 +1856,8 @@ void SliceView::setSliceIndex(int index) {
 		m_editSliceIndex->setText(QString::number(m_currentSlice));
 	}
 
+	noteInteraction();
+
 	// updates the slice mapper
 	// updates the camera based on slice position
 	updateSlice();
@@ -710,6 +1912,125 @@ bool SliceView::eventFilter(QObject* watched, QEvent* event)
 		return false;
 	}
 
+	// Ctrl+left-drag tilts the plane (the interactor style ignores Ctrl+left, see trapSpin);
+	// Alt+left-drag moves the linked cursor; with the profile tool on, plain left-drag draws
+	if (watched == ui->renderArea && m_imageData) {
+		switch (event->type()) {
+			case QEvent::MouseButtonPress: {
+				auto* me = static_cast<QMouseEvent*>(event);
+				double index[3];
+				if (me->button() == Qt::LeftButton && m_profileTool && me->modifiers() == Qt::NoModifier &&
+					profilePoint(me->pos(), index)) {
+					m_profileDragEnd = profileEndNear(index);
+					if (m_profileDragEnd < 0) {
+						// Start a new segment at the press and drag its far end
+						std::copy(index, index + 3, m_profileEnds[0]);
+						std::copy(index, index + 3, m_profileEnds[1]);
+						m_profileAxis = m_viewOrientation;
+						m_profileValid = true;
+						m_profileDragEnd = 1;
+					}
+					m_profileMoved = true;
+					m_profileThrottle->request();
+					return true;
+				}
+				if (me->button() == Qt::LeftButton && m_pathTool && me->modifiers() == Qt::NoModifier &&
+					profilePoint(me->pos(), index)) {
+					m_pathDragPoint = pathPointNear(index);
+					if (m_pathDragPoint < 0) {
+						// Append on the current slice and keep dragging the new point
+						m_path.push_back({ index[0], index[1], index[2] });
+						m_pathDragPoint = static_cast<int>(m_path.size()) - 1;
+						m_pathThrottle->request();
+					}
+					return true;
+				}
+				if (me->button() == Qt::LeftButton && (me->modifiers() & Qt::AltModifier) && !m_oblique) {
+					m_pickingCursor = true;
+					m_pendingCursorPos = me->pos();
+					m_cursorThrottle->request();
+					return true;
+				}
+				if (me->button() == Qt::LeftButton && (me->modifiers() & Qt::ControlModifier)) {
+					beginOblique();
+					m_rotatingPlane = m_oblique;
+					m_rotateLastPos = me->pos();
+					return m_rotatingPlane;
+				}
+				break;
+			}
+			case QEvent::MouseMove: {
+				// Analytic and O(1); only a status readout, never a render
+				probe(static_cast<QMouseEvent*>(event)->pos());
+				if (m_profileDragEnd >= 0) {
+					double index[3];
+					if (profilePoint(static_cast<QMouseEvent*>(event)->pos(), index)) {
+						std::copy(index, index + 3, m_profileEnds[m_profileDragEnd]);
+						m_profileMoved = true;
+						m_profileThrottle->request();
+					}
+					return true;
+				}
+				if (m_pathDragPoint >= 0) {
+					double index[3];
+					if (profilePoint(static_cast<QMouseEvent*>(event)->pos(), index)) {
+						// In-plane move; the point keeps the slice it was placed on
+						CurvedReformat::Point& point = m_path[m_pathDragPoint];
+						for (int a = 0; a < 3; ++a) {
+							if (a != m_viewOrientation) point[a] = index[a];
+						}
+						m_pathThrottle->request();
+					}
+					return true;
+				}
+				if (m_pickingCursor) {
+					m_pendingCursorPos = static_cast<QMouseEvent*>(event)->pos();
+					m_cursorThrottle->request();
+					return true;
+				}
+				if (!m_rotatingPlane) break;
+				auto* me = static_cast<QMouseEvent*>(event);
+				const QPoint delta = me->pos() - m_rotateLastPos;
+				m_rotateLastPos = me->pos();
+				m_pendingRotation[0] += delta.x() * kObliqueDegreesPerPixel;
+				m_pendingRotation[1] += delta.y() * kObliqueDegreesPerPixel;
+				m_rotateThrottle->request();
+				return true;
+			}
+			case QEvent::Leave: {
+				if (m_probeInside) {
+					m_probeInside = false;
+					emit probeLeft();
+				}
+				break;
+			}
+			case QEvent::MouseButtonRelease: {
+				auto* me = static_cast<QMouseEvent*>(event);
+				if (m_profileDragEnd >= 0 && me->button() == Qt::LeftButton) {
+					m_profileDragEnd = -1;
+					m_profileThrottle->flush();
+					return true;
+				}
+				if (m_pathDragPoint >= 0 && me->button() == Qt::LeftButton) {
+					m_pathDragPoint = -1;
+					m_pathThrottle->flush();
+					return true;
+				}
+				if (m_pickingCursor && me->button() == Qt::LeftButton) {
+					m_pickingCursor = false;
+					m_cursorThrottle->flush();
+					return true;
+				}
+				if (!m_rotatingPlane || me->button() != Qt::LeftButton) break;
+				m_rotatingPlane = false;
+				m_rotateThrottle->flush();
+				return true;
+			}
+			default:
+			break;
+		}
+	}
+
 	if (watched == ui->renderArea && event->type() == QEvent::ShortcutOverride) {
 		// Allow VTK keys to be handled when either:
 		// - interaction is not restricted to selection, or
@@ -737,6 +2058,184 @@ bool SliceView::eventFilter(QObject* watched, QEvent* event)
 	return SelectionFrameWidget::eventFilter(watched, event);
 }
 
+void SliceView::beginOblique()
+{
+	if (m_oblique || !m_imageData || !m_renderer) return;
+	auto* cam = m_renderer->GetActiveCamera();
+	if (!cam) return;
+
+	// Start from the orthogonal plane as seen on screen: u = right, v = up, n = towards the viewer
+	cam->OrthogonalizeViewUp();
+	cam->GetViewUp(m_planeV);
+	cam->GetViewPlaneNormal(m_planeN);
+	vtkMath::Cross(m_planeV, m_planeN, m_planeU);
+	vtkMath::Normalize(m_planeU);
+
+	if (!m_reslice) m_reslice = vtkSmartPointer<ImageResliceHelper>::New();
+	m_reslice->SetInputConnection(displayOutputPort());
+	setResliceInterpolation();
+
+	m_oblique = true;
+	updateObliquePlane();
+
+	// Keep the current pan and zoom: express the focal point in plane coordinates
+	double center[3];
+	obliquePlaneCenter(center);
+	double fpt[3];
+	cam->GetFocalPoint(fpt);
+	double rel[3];
+	vtkMath::Subtract(fpt, center, rel);
+	const double fx = vtkMath::Dot(rel, m_planeU);
+	const double fy = vtkMath::Dot(rel, m_planeV);
+	const double distance = cam->GetDistance();
+
+	setSliceSource(m_reslice->GetOutputPort());
+	sliceMapper->SetOrientationToZ();
+	sliceMapper->SetSliceNumber(0);
+
+	cam->SetFocalPoint(fx, fy, 0.0);
+	cam->SetPosition(fx, fy, distance);
+	cam->SetViewUp(0.0, 1.0, 0.0);
+	updateObliqueRegion();
+	updateCrosshair();
+	updateLabelOverlay();
+	updateProfileLine();
+	updateProfile();
+	updatePathLine();
+	m_renderer->ResetCameraClippingRange();
+}
+
+void SliceView::endOblique()
+{
+	if (!m_oblique) return;
+	m_oblique = false;
+	m_rotatingPlane = false;
+	m_pendingRotation[0] = m_pendingRotation[1] = 0.0;
+
+	// Callers re-run updateCamera() and updateSlice(), which refill the provider slice
+	connectSliceInput();
+	if (m_reslice) m_reslice->RemoveAllInputs();
+}
+
+void SliceView::connectSliceInput()
+{
+	if (m_sliceProvider) setSliceSource(m_sliceImage);
+	else setSliceSource(displayOutputPort());
+	switch (m_viewOrientation) {
+		case VIEW_ORIENTATION_YZ: sliceMapper->SetOrientationToX(); break;
+		case VIEW_ORIENTATION_XZ: sliceMapper->SetOrientationToY(); break;
+		case VIEW_ORIENTATION_XY:
+		default:                  sliceMapper->SetOrientationToZ(); break;
+	}
+}
+
+void SliceView::setSlab(SlabMode mode, int thickness)
+{
+	thickness = std::max(thickness, 1);
+	if (m_slabMode == mode && m_slabThickness == thickness) return;
+	const bool wasSlab = m_slabThickness > 1;
+	m_slabMode = mode;
+	m_slabThickness = thickness;
+
+	if (m_slab) {
+		m_slab->setMode(static_cast<SlabProjector::Mode>(mode));
+		m_slab->setThickness(thickness);
+	}
+	if (!m_imageData || !m_imageInitialized) return;
+
+	// Back to the regular slice input when leaving slab mode
+	if (wasSlab && thickness == 1) {
+		m_slab.reset();
+		if (!m_oblique) connectSliceInput();
+	}
+	updateSlice();
+}
+
+void SliceView::rotatePlane(double degreesAboutV, double degreesAboutU)
+{
+	if (!m_oblique) return;
+
+	// Horizontal drag turns the plane about its vertical axis, vertical drag about its horizontal axis
+	if (degreesAboutV != 0.0) {
+		rotateAbout(m_planeU, m_planeV, degreesAboutV);
+		rotateAbout(m_planeN, m_planeV, degreesAboutV);
+	}
+	if (degreesAboutU != 0.0) {
+		rotateAbout(m_planeV, m_planeU, degreesAboutU);
+		rotateAbout(m_planeN, m_planeU, degreesAboutU);
+	}
+
+	// Re-orthonormalize against accumulated rounding
+	vtkMath::Normalize(m_planeU);
+	vtkMath::Cross(m_planeU, m_planeV, m_planeN);
+	vtkMath::Normalize(m_planeN);
+	vtkMath::Cross(m_planeN, m_planeU, m_planeV);
+
+	noteInteraction();
+	updateObliquePlane();
+	render();
+}
+
+void SliceView::obliquePlaneCenter(double center[3]) const
+{
+	// Rotation center is the middle voxel; the slice index offsets the plane along its normal
+	for (int a = 0; a < 3; ++a) {
+		center[a] = m_origin[a] + m_spacing[a] * midIndex(m_extent[2 * a], m_extent[2 * a + 1]);
+	}
+	const int w = m_viewOrientation;
+	const double offset = (m_currentSlice - midIndex(m_extent[2 * w], m_extent[2 * w + 1])) * m_spacing[w];
+	for (int a = 0; a < 3; ++a) center[a] += offset * m_planeN[a];
+}
+
+void SliceView::updateObliquePlane()
+{
+	if (!m_reslice) return;
+	double center[3];
+	obliquePlaneCenter(center);
+	m_reslice->SetPlane(center, m_planeU, m_planeV);
+}
+
+void SliceView::updateObliqueRegion()
+{
+	if (!m_oblique || !m_reslice || !m_renderer) return;
+	auto* cam = m_renderer->GetActiveCamera();
+	const int* size = m_renderer->GetSize();
+	if (!cam || size[0] <= 0 || size[1] <= 0) return;
+
+	// Visible rectangle in plane coordinates (axis-aligned bounds if the view is rolled),
+	// sampled at one sample per screen pixel (coarser during interaction LOD)
+	const double halfHeight = cam->GetParallelScale();
+	const double halfWidth = halfHeight * size[0] / size[1];
+	const double pixel = 2.0 * halfHeight / size[1] * (m_lodActive ? m_lodDivisor : 1);
+	double up[3];
+	cam->GetViewUp(up);
+	const double right[2] = { up[1], -up[0] };
+	const double ex = std::abs(right[0]) * halfWidth + std::abs(up[0]) * halfHeight + pixel;
+	const double ey = std::abs(right[1]) * halfWidth + std::abs(up[1]) * halfHeight + pixel;
+	double f[3];
+	cam->GetFocalPoint(f);
+
+	m_reslice->SetRegion(f[0] - ex, f[1] - ey, f[0] + ex, f[1] + ey, pixel);
+	m_reslice->Update();
+}
+
+void SliceView::setResliceInterpolation()
+{
+	switch (effectiveInterpolation()) {
+		case Nearest: m_reslice->SetInterpolationModeToNearestNeighbor(); break;
+		case Cubic:   m_reslice->SetInterpolationModeToCubic(); break;
+		case Linear:
+		default:      m_reslice->SetInterpolationModeToLinear(); break;
+	}
+}
+
+void SliceView::onRendererStart(vtkObject*)
+{
+	// Pan and zoom change the visible region; unchanged regions do not re-execute
+	updateObliqueRegion();
+	syncCompositor();
+}
+
 void SliceView::setWindowLevelNative(double window, double level)
 {
 	if (!m_imageData) return;
@@ -746,7 +2245,7 @@ void SliceView::setWindowLevelNative(double window, double level)
 	const double upperNative = level + 0.5 * std::fabs(window);
 	const double lowerMapped = (lowerNative + m_scalarShift) * m_scalarScale;
 	const double upperMapped = (upperNative + m_scalarShift) * m_scalarScale;
-	const double mappedWindow = std::max(upperMapped - lowerMapped, 1.0);
+	const double mappedWindow = std::max(upperMapped - lowerMapped, minimumWindowMapped());
 	const double mappedLevel = 0.5 * (upperMapped + lowerMapped);
 
 	if (imageProperty) {
@@ -768,6 +2267,18 @@ void SliceView::setWindowLevelNative(double window, double level)
 	emit windowLevelChanged(window, level);
 }
 
+void SliceView::windowLevelNative(double& window, double& level) const
+{
+	const double mappedWindow = imageProperty ? imageProperty->GetColorWindow() : 1.0;
+	const double mappedLevel = imageProperty ? imageProperty->GetColorLevel() : 0.5;
+	const double lowerMapped = mappedLevel - 0.5 * std::fabs(mappedWindow);
+	const double upperMapped = mappedLevel + 0.5 * std::fabs(mappedWindow);
+	const double lowerNative = (lowerMapped / m_scalarScale) - m_scalarShift;
+	const double upperNative = (upperMapped / m_scalarScale) - m_scalarShift;
+	window = std::max(upperNative - lowerNative, minimumWindowNative());
+	level = 0.5 * (upperNative + lowerNative);
+}
+
 void SliceView::resetWindowLevel()
 {
 	// Apply retained baseline: convert native baseline -> mapped domain in base class
@@ -799,9 +2310,10 @@ void SliceView::onInteractorWindowLevel(vtkObject* caller)
 	auto* style = vtkInteractorStyleImage::SafeDownCast(caller);
 	if (!style) return;
 
-	// Need interactor and current image property
+	// Need interactor and the WL property (the style's current property is the pass-through
+	// one while compositing on the CPU)
 	auto* iren = style->GetInteractor();
-	vtkImageProperty* prop = style->GetCurrentImageProperty();
+	vtkImageProperty* prop = imageProperty;
 	if (!iren || !prop || !m_imageData) return;
 
 	// Get viewport size (use render window size as a robust fallback)
@@ -824,23 +2336,25 @@ void SliceView::onInteractorWindowLevel(vtkObject* caller)
 	double dy =
 		(m_windowLevelStartPosition[1] - m_windowLevelCurrentPosition[1]) * 4.0 / size[1];
 
-	// Scale by current values
+	// Scale by current values. The 0.01 floor of vtkInteractorStyleImage is too coarse for
+	// float data in physical units, so it shrinks with the scalar range there.
+	const double eps = std::min(0.01, minimumWindowMapped());
 
-	if (fabs(window) > 0.01)
+	if (fabs(window) > eps)
 	{
 		dx = dx * window;
 	}
 	else
 	{
-		dx = dx * (window < 0 ? -0.01 : 0.01);
+		dx = dx * (window < 0 ? -eps : eps);
 	}
-	if (fabs(level) > 0.01)
+	if (fabs(level) > eps)
 	{
 		dy = dy * level;
 	}
 	else
 	{
-		dy = dy * (level < 0 ? -0.01 : 0.01);
+		dy = dy * (level < 0 ? -eps : eps);
 	}
 
 	// Abs so that direction does not flip
@@ -859,9 +2373,9 @@ void SliceView::onInteractorWindowLevel(vtkObject* caller)
 	double newWindow = dx + window;
 	double newLevel = level - dy;
 
-	if (newWindow < 0.01)
+	if (newWindow < eps)
 	{
-		newWindow = 0.01;
+		newWindow = eps;
 	}
 
 	// Apply mapped-domain change to the image property (we must do this because style did not)
@@ -874,7 +2388,7 @@ void SliceView::onInteractorWindowLevel(vtkObject* caller)
 	const double upperMapped = newLevel + 0.5 * std::fabs(newWindow);
 	const double lowerNative = (lowerMapped / m_scalarScale) - m_scalarShift;
 	const double upperNative = (upperMapped / m_scalarScale) - m_scalarShift;
-	const double nativeWindow = std::max(upperNative - lowerNative, 1.0);
+	const double nativeWindow = std::max(upperNative - lowerNative, minimumWindowNative());
 	const double nativeLevel = 0.5 * (upperNative + lowerNative);
 
 	// Emit native-domain signal for bridge-controller
@@ -887,7 +2401,7 @@ void SliceView::onInteractorStartWindowLevel(vtkObject* caller)
 	auto* style = vtkInteractorStyleImage::SafeDownCast(caller);
 	if (!style) return;
 
-	vtkImageProperty* prop = style->GetCurrentImageProperty();
+	vtkImageProperty* prop = imageProperty;
 	if (!prop || !m_imageData) return;
 
 	m_windowLevelInitial[0] = prop->GetColorWindow();
@@ -903,18 +2417,11 @@ void SliceView::onInteractorEndWindowLevel(vtkObject* caller)
 	auto* style = vtkInteractorStyleImage::SafeDownCast(caller);
 	if (!style) return;
 
-	vtkImageProperty* prop = style->GetCurrentImageProperty();
+	vtkImageProperty* prop = imageProperty;
 	if (!prop || !m_imageData) return;
 
-	const double mappedWindow = prop->GetColorWindow();
-	const double mappedLevel = prop->GetColorLevel();
-
-	const double lowerMapped = mappedLevel - 0.5 * std::fabs(mappedWindow);
-	const double upperMapped = mappedLevel + 0.5 * std::fabs(mappedWindow);
-	const double lowerNative = (lowerMapped / m_scalarScale) - m_scalarShift;
-	const double upperNative = (upperMapped / m_scalarScale) - m_scalarShift;
-	const double nativeWindow = std::max(upperNative - lowerNative, 1.0);
-	const double nativeLevel = 0.5 * (upperNative + lowerNative);
+	double nativeWindow = 0.0, nativeLevel = 0.0;
+	windowLevelNative(nativeWindow, nativeLevel);
 
 	// DO NOT overwrite the original baseline here.
 	// We still emit the interactive result so controllers/bridges can react,
@@ -955,8 +2462,8 @@ void SliceView::setSharedImageProperty(vtkImageProperty* sharedProp)
 	if (!sharedProp || !imageSlice) return;
 
 	// Replace our local imageProperty pointer with the shared one
-	imageSlice->SetProperty(sharedProp);
 	imageProperty = vtkImageProperty::SafeDownCast(sharedProp);
+	attachSliceProperty();
 
 	// Ensure interactor style baseline picks up the new property values
 	updateInteractorWindowLevelBaseline();
@@ -975,9 +2482,11 @@ void SliceView::clearSharedImageProperty()
 		newProp->SetColorLevel(imageProperty->GetColorLevel());
 		newProp->SetInterpolationType(imageProperty->GetInterpolationType());
 	}
+	newProp->SetLookupTable(Colormap::lookupTable(m_colormap));
+	newProp->UseLookupTableScalarRangeOff();
 	// Apply the new property to our slice
-	imageSlice->SetProperty(newProp);
 	imageProperty = newProp;
+	attachSliceProperty();
 
 	// Update baseline in interactor style so 'r' restores to this new property
 	updateInteractorWindowLevelBaseline();
@@ -2,8 +2,15 @@
 #define SLICEVIEW_H
 
 #include "ImageFrameWidget.h"
+#include "Colormap.h"
+#include "LineProfile.h"
+#include "CurvedReformat.h"
 
 #include <QFrame>
+#include <QPoint>
+
+#include <memory>
+#include <vector>
 
 #include <vtkSmartPointer.h>
 #include <vtkImageData.h>
@@ -15,10 +22,27 @@
 #include <vtkImageSliceMapper.h>
 #include <vtkImageProperty.h>
 
+class CinePlayer;
+class FrameThrottle;
+class ImageResliceHelper;
+class ProfilePlot;
+class SliceCache;
+class SliceCompositor;
+class SliceEqualizer;
+class SlabProjector;
+class SliceProvider;
+class vtkActor;
+class vtkAlgorithmOutput;
 class vtkEventQtSlotConnect;
+class vtkImageStack;
+class vtkLookupTable;
+class vtkPolyData;
 class vtkObject; // forward declare for slot
 class QLineEdit;
 class QLabel;    // added
+class QMenu;
+class QToolButton;
+class QTimer;
 
 namespace Ui { class SliceView; }
 
@@ -27,16 +51,115 @@ class SliceView : public ImageFrameWidget
 	Q_OBJECT
 
 public:
+	// Thick-slab projection operators
+	enum SlabMode { SlabMaximum, SlabMinimum, SlabMean };
+	Q_ENUM(SlabMode)
+	// Contrast enhancement of orthogonal slices
+	enum EqualizeMode { EqualizeOff, EqualizeAdaptive, EqualizeGlobal };
+	Q_ENUM(EqualizeMode)
+
 	explicit SliceView(QWidget* parent = nullptr, ViewOrientation orientation = VIEW_ORIENTATION_XY);
 	~SliceView();
 
 	void setImageData(vtkImageData* image) override;
+
+	// Read slices from `provider` at full resolution instead of from the image; the image
+	// passed to setImageData() then only supplies statistics (it may be a downsampled
+	// preview). Set before setImageData(); nullptr returns to slicing the image itself.
+	void setSliceProvider(std::shared_ptr<SliceProvider> provider);
+	// Swap the provider of the image already shown for one with the same geometry (e.g.
+	// direct slicing <-> a bricked copy); nothing is reloaded and the cursor, path and
+	// camera stay. Provider slices render native, so the mapped domain may change: pass
+	// the native Window/Level to keep (read before any view sharing the property swaps).
+	void replaceSliceProvider(std::shared_ptr<SliceProvider> provider, double window, double level);
+	// Keep `depth` slices ahead of the current one (in the direction of motion) extracted
+	// on a worker thread; 0 disables. Only applies with a slice provider.
+	void setSlicePrefetch(int depth);
+	int slicePrefetch() const { return m_prefetchDepth; }
 	void setSliceIndex(int index);
 	int getSliceIndex() const;
 
 	void setInterpolation(Interpolation newInterpolation) override;
 	void setViewOrientation(ViewOrientation orient) override;
 
+	// Interaction level of detail: while panning, zooming, adjusting window/level, stepping
+	// slices or playing cine, render with `filtering` (when cheaper than the chosen
+	// interpolation) and sample oblique planes at 1/`resolutionDivisor` resolution; the
+	// chosen quality is restored once the view has been idle briefly. Off by default.
+	void setInteractionLod(bool enabled, Interpolation filtering = Nearest, int resolutionDivisor = 2);
+	bool interactionLod() const { return m_lodEnabled; }
+
+	// Apply window/level to the displayed slice on the CPU (SIMD, all cores) and hand the
+	// mapper a ready 8-bit RGBA image, instead of uploading scalars for the GPU to window.
+	// Faster on software OpenGL (e.g. llvmpipe); off by default.
+	void setCpuCompositing(bool enabled);
+	bool cpuCompositing() const { return m_cpuCompositing; }
+
+	// Oblique reslicing: Ctrl+left-drag tilts the plane about the middle of the volume
+	// (horizontal drag about the screen's vertical axis, vertical drag about the horizontal
+	// one) and the slice index then moves it along its normal. Only the visible region is
+	// sampled, at screen resolution. Reset Camera returns to the orthogonal plane.
+	bool isOblique() const { return m_oblique; }
+
+	// Show the projection of `thickness` slices centered on the current one (1 = single
+	// slice). Applies to orthogonal planes; an oblique plane is always a single slice.
+	void setSlab(SlabMode mode, int thickness);
+	SlabMode slabMode() const { return m_slabMode; }
+	int slabThickness() const { return m_slabThickness; }
+
+	// Colour map spread across the window (Grayscale is the plain ramp)
+	void setColormap(Colormap::Preset preset);
+	Colormap::Preset colormap() const { return m_colormap; }
+
+	// Show each orthogonal slice (or slab) histogram-equalized: adaptively over
+	// tiles x tiles tiles with the given clip limit (CLAHE), or globally. Results are
+	// computed when a slice is first shown and cached, so panning, zooming and scrolling
+	// back are free; window/level and the colour map still apply.
+	void setEqualization(EqualizeMode mode);
+	EqualizeMode equalization() const { return m_equalization; }
+	void setClaheParameters(int tiles, double clipLimit);
+
+	// Cine playback through the slice range at the player's frame rate and mode. While
+	// playing, provider slices are read ahead on the prefetch workers (at least half a
+	// second of frames) so they are extracted before they are due.
+	void setCinePlaying(bool playing);
+	bool isCinePlaying() const;
+	CinePlayer* cinePlayer() const { return m_cine; }
+
+	// Linked cursor: Alt+left-click (or drag) picks the voxel under the mouse and emits
+	// cursorPicked(); setCursorPosition() moves the crosshair drawn through the cursor's
+	// in-plane coordinates. Orthogonal planes only.
+	void setCursorPosition(int x, int y, int z);
+	void setCrosshairVisible(bool visible);
+	bool crosshairVisible() const { return m_crosshairVisible; }
+
+	// Label overlay: draw the visible slice of `labels` (uint8, the geometry of the slices)
+	// over the grey values through `colors`, indexed by label. Recolouring only modifies
+	// the table. nullptr removes the layer. Orthogonal planes only.
+	void setLabelOverlay(vtkImageData* labels, vtkLookupTable* colors);
+	bool hasLabelOverlay() const { return m_labelMapper && m_labelMapper->GetNumberOfInputConnections(0) > 0; }
+
+	// Line profile: while the tool is on, left-drag draws a segment on the current slice
+	// (dragging near an end moves that end) and a plot window shows the native values
+	// sampled along it, updated live during the drag and when the slice changes. Samples
+	// are `step` voxels apart, averaged over `band` parallel lines. Orthogonal planes only.
+	void setProfileTool(bool enabled);
+	bool profileTool() const { return m_profileTool; }
+	void setProfileInterpolation(LineProfile::Interpolation interpolation);
+	LineProfile::Interpolation profileInterpolation() const { return m_profileInterpolation; }
+	void setProfileBandWidth(int lines);
+	int profileBandWidth() const { return m_profileBand; }
+
+	// Curved path for curved planar reformation: while the tool is on, left-clicks append
+	// control points on the current slice (step through slices between clicks to follow
+	// a structure) and dragging a point moves it within its own slice; every edit emits
+	// pathEdited(). setPath() shows a path edited elsewhere, projected onto the slice.
+	// Points are continuous voxel indices. The path and profile tools exclude each other.
+	void setPathTool(bool enabled);
+	bool pathTool() const { return m_pathTool; }
+	void setPath(const std::vector<CurvedReformat::Point>& points);
+	const std::vector<CurvedReformat::Point>& path() const { return m_path; }
+
 	int getMaxSliceIndex() const;
 	int getMinSliceIndex() const;
 
@@ -44,6 +167,8 @@ public:
 	// This method maps to the vtkImageProperty domain using the view's m_scalarShift/m_scalarScale
 	// and updates the interactor style baseline so plain 'r' will restore it.
 	void setWindowLevelNative(double window, double level);
+	// Current Window/Level in the native scalar domain
+	void windowLevelNative(double& window, double& level) const;
 
 	// install a shared vtkImageProperty (sharedProp may be the same instance across views)
 	void setSharedImageProperty(vtkImageProperty* sharedProp);
@@ -59,6 +184,12 @@ public slots:
 
 signals:
 	void sliceChanged(int);
+	void cursorPicked(int x, int y, int z);
+	// Voxel under the mouse (full-resolution indices) and its native value; probeLeft()
+	// when the mouse leaves the volume or the view
+	void voxelProbed(int x, int y, int z, double value);
+	void probeLeft();
+	void pathEdited(const std::vector<CurvedReformat::Point>& points);
 	void interpolationChanged(Interpolation);
 
 protected:
@@ -73,10 +204,61 @@ protected:
 	void createMenuAndActions();
 
 private:
+	// Title-menu submenu placed after the orientation and camera items (and before the
+	// frame's own rename/close actions)
+	QMenu* addViewMenu(const QString& title);
+	void createSlabMenu();
+	void createCineMenu();
+	void createColorMenus();
+	void createProfileMenu();
+	void createPathMenu();
 	void updateCamera();
 	void updateSlice();
 	void updateSliceRange();
 
+	void beginOblique();
+	void endOblique();
+	void rotatePlane(double degreesAboutV, double degreesAboutU);
+	void obliquePlaneCenter(double center[3]) const;
+	void updateObliquePlane();
+	// Fit the resampled region to the camera's view of the plane
+	void updateObliqueRegion();
+	void setResliceInterpolation();
+	// Point the mapper at the orthogonal slice input (provider slice or display port)
+	void connectSliceInput();
+	// Slices to keep extracted ahead: the prefetch depth, raised for cine playback
+	int readAheadDepth() const;
+
+	// Continuous voxel index under a widget position, from the parallel camera alone
+	bool displayToIndex(const QPoint& pos, double index[3]) const;
+	// Voxel under widget position `pos` on the current orthogonal slice
+	bool voxelAt(const QPoint& pos, int voxel[3]) const;
+	// Voxel probe: report the voxel under the mouse and its native value
+	void probe(const QPoint& pos);
+	double nativeValue(const int voxel[3]) const;
+	bool m_probeInside = false;
+	void updateCrosshair();
+
+	// Enter the interaction LOD (if enabled) and restart the refine timer
+	void noteInteraction();
+	void refineAfterInteraction();
+	bool interactionInProgress() const;
+	// m_interpolation, or the LOD filtering while interacting
+	Interpolation effectiveInterpolation() const;
+	void applyInterpolation();
+
+	// Feed the slice to the mapper, or to the compositor in front of it
+	void setSliceSource(vtkImageData* image);
+	void setSliceSource(vtkAlgorithmOutput* port);
+	// Put the WL property (or the compositor's pass-through one) on the image slice
+	void attachSliceProperty();
+	// Copy imageProperty's window/level and interpolation to the compositor stage
+	void syncCompositor();
+	void applyColormap();
+	// Equalized version of the current slice (`source`, or sliced from the display image
+	// when null); nullptr if it cannot be equalized
+	vtkImageData* equalizedSlice(vtkImageData* source);
+
 	Ui::SliceView* ui = nullptr;
 	int m_currentSlice = 0;
 	int m_minSlice = 0;
@@ -88,11 +270,116 @@ private:
 	vtkSmartPointer<vtkImageProperty> imageProperty;
 	vtkSmartPointer<vtkEventQtSlotConnect> qvtkConnection;
 
+	// Provider mode: the mapper renders m_sliceImage, refilled on every slice change
+	std::shared_ptr<SliceProvider> m_sliceProvider;
+	vtkSmartPointer<vtkImageData> m_sliceImage;
+	// Provider mode with prefetch: the mapper renders the cache's image for the current slice
+	std::unique_ptr<SliceCache> m_sliceCache;
+	int m_prefetchDepth = 0;
+	int m_lastSlice = 0;
+
+	// Frame-paced slider input: latest value wins
+	FrameThrottle* m_sliderThrottle = nullptr;
+	int m_pendingSliderValue = 0;
+
+	// Slab mode: the mapper renders the projector's image for the current slice
+	std::unique_ptr<SlabProjector> m_slab;
+	SlabMode m_slabMode = SlabMaximum;
+	int m_slabThickness = 1;
+
+	Colormap::Preset m_colormap = Colormap::Grayscale;
+	std::vector<std::uint32_t> m_colormapTable; // for the compositor; empty for Grayscale
+	EqualizeMode m_equalization = EqualizeOff;
+	int m_claheTiles = 8;
+	double m_claheClipLimit = 2.0;
+	std::unique_ptr<SliceEqualizer> m_equalizer;
+
+	// Oblique plane: orthonormal axes in world coordinates; the mapper then renders
+	// m_reslice's output in plane coordinates (x = u, y = v)
+	vtkSmartPointer<ImageResliceHelper> m_reslice;
+	bool m_oblique = false;
+	double m_planeU[3] = { 1.0, 0.0, 0.0 };
+	double m_planeV[3] = { 0.0, 1.0, 0.0 };
+	double m_planeN[3] = { 0.0, 0.0, 1.0 };
+	bool m_rotatingPlane = false;
+	QPoint m_rotateLastPos;
+	double m_pendingRotation[2] = { 0.0, 0.0 };
+	FrameThrottle* m_rotateThrottle = nullptr;
+
+	// Linked cursor and its crosshair (two lines through the cursor, just above the slice)
+	int m_cursor[3] = { 0, 0, 0 };
+	bool m_crosshairVisible = false;
+	vtkSmartPointer<vtkPolyData> m_crosshairPoly;
+	vtkSmartPointer<vtkActor> m_crosshairActor;
+	bool m_pickingCursor = false;
+	QPoint m_pendingCursorPos;
+	FrameThrottle* m_cursorThrottle = nullptr;
+
+	// Label overlay: layer 1 of m_imageStack above imageSlice; created on first use
+	vtkSmartPointer<vtkImageStack> m_imageStack;
+	vtkSmartPointer<vtkImageSliceMapper> m_labelMapper;
+	vtkSmartPointer<vtkImageSlice> m_labelSlice;
+	void updateLabelOverlay();
+
+	// Line profile: segment ends in continuous voxel indices on m_profileAxis
+	bool m_profileTool = false;
+	bool m_profileValid = false;
+	int m_profileAxis = 0;
+	double m_profileEnds[2][3] = {};
+	int m_profileDragEnd = -1; // end being dragged, -1 when idle
+	LineProfile::Interpolation m_profileInterpolation = LineProfile::Linear;
+	int m_profileBand = 1;
+	std::unique_ptr<LineProfile> m_profile;
+	ProfilePlot* m_profilePlot = nullptr;
+	vtkSmartPointer<vtkPolyData> m_profilePoly;
+	vtkSmartPointer<vtkActor> m_profileActor;
+	FrameThrottle* m_profileThrottle = nullptr;
+	bool m_profileMoved = false; // the segment moved since the last render
+	// Index under `pos`, clamped to the slice; false off the orthogonal plane
+	bool profilePoint(const QPoint& pos, double index[3]) const;
+	// End of the segment within the grab radius of `index`, or -1
+	int profileEndNear(const double index[3]) const;
+	// World distance within which a press picks up a point drawn in the view
+	double grabRadius() const;
+	// Position (or hide) the drawn segment on the current slice
+	void updateProfileLine();
+	// Resample and replot; the plot is a plain widget, so no render is needed
+	void updateProfile();
+
+	// Curved path and the point being dragged (-1 when idle)
+	bool m_pathTool = false;
+	std::vector<CurvedReformat::Point> m_path;
+	int m_pathDragPoint = -1;
+	vtkSmartPointer<vtkPolyData> m_pathPoly;
+	vtkSmartPointer<vtkActor> m_pathActor;
+	// Emits pathEdited() at most once per frame while dragging
+	FrameThrottle* m_pathThrottle = nullptr;
+	// Control point within the grab radius of `index` in the view plane, or -1
+	int pathPointNear(const double index[3]) const;
+	// Spline through the path, flattened onto the current slice (or hidden)
+	void updatePathLine();
+
+	// Interaction LOD
+	bool m_lodEnabled = false;
+	bool m_lodActive = false;
+	Interpolation m_lodFiltering = Nearest;
+	int m_lodDivisor = 2;
+	QTimer* m_refineTimer = nullptr;
+
+	// CPU compositing: source -> m_compositor -> mapper. imageProperty keeps the
+	// window/level and the slice renders with m_passThroughProperty (window 255, level 127.5)
+	bool m_cpuCompositing = false;
+	vtkSmartPointer<SliceCompositor> m_compositor;
+	vtkSmartPointer<vtkImageProperty> m_passThroughProperty;
+
+	CinePlayer* m_cine = nullptr;
+	QToolButton* m_playButton = nullptr;
+
 	QLineEdit* m_editSliceIndex = nullptr;
 	QLabel* m_labelMinSlice = nullptr;
 	QLabel* m_labelMaxSlice = nullptr;
 
-	// Build a bottom bar: [minLabel] [slider] [maxLabel] [lineEdit]
+	// Build a bottom bar: [play] [minLabel] [slider] [maxLabel] [lineEdit]
 	void buildSliderBar(QWidget* rootContent);
 
 	double m_windowLevelInitial[2];
@@ -111,6 +398,9 @@ private:
 private slots:
 	// Must be a Qt slot for vtkEventQtSlotConnect
 	void trapSpin(vtkObject*);
+	void onRendererStart(vtkObject*);
+	void onInteractionStart(vtkObject*);
+	void onInteractionEnd(vtkObject*);
 
 	// Handle ResetWindowLevelEvent from vtkInteractorStyleImage
 	void onResetWindowLevel(vtkObject* obj);
@@ -0,0 +1,191 @@
+#include "VolumeAllocator.h"
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#include <fstream>
+#include <limits>
+#include <string>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+	std::atomic<bool> g_enabled{ false };
+
+	// Small page size; touching one byte per page maps it
+	constexpr std::size_t kPageSize = 4096;
+
+	std::size_t alignmentFor(std::size_t bytes)
+	{
+		return bytes >= VolumeAllocator::HugePageSize ? VolumeAllocator::HugePageSize : VolumeAllocator::Alignment;
+	}
+
+	// Run f(begin, end) over [0, bytes) in huge-page chunks on the SMP backend. One chunk
+	// per task keeps the chunk-to-thread assignment fine-grained enough to interleave nodes.
+	template <typename F>
+	void forEachChunk(std::size_t bytes, F&& f)
+	{
+		const std::size_t chunk = VolumeAllocator::HugePageSize;
+		const vtkIdType chunks = static_cast<vtkIdType>((bytes + chunk - 1) / chunk);
+		vtkSMPTools::For(0, chunks, 1, [&](vtkIdType first, vtkIdType last) {
+			for (vtkIdType c = first; c < last; ++c) {
+				const std::size_t begin = static_cast<std::size_t>(c) * chunk;
+				f(begin, std::min(begin + chunk, bytes));
+			}
+		});
+	}
+
+	// Physical memory that can be allocated without swapping; SIZE_MAX when unknown
+	std::size_t availablePhysicalBytes()
+	{
+#if defined(_WIN32)
+		MEMORYSTATUSEX status;
+		status.dwLength = sizeof(status);
+		if (GlobalMemoryStatusEx(&status))
+			return static_cast<std::size_t>(std::min<DWORDLONG>(status.ullAvailPhys, std::numeric_limits<std::size_t>::max()));
+#elif defined(__linux__)
+		// MemAvailable counts reclaimable page cache, which _SC_AVPHYS_PAGES leaves out
+		std::ifstream meminfo("/proc/meminfo");
+		std::string key;
+		unsigned long long kb = 0;
+		while (meminfo >> key >> kb) {
+			if (key == "MemAvailable:") return static_cast<std::size_t>(kb) * 1024;
+			meminfo.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+		}
+		const long pages = sysconf(_SC_AVPHYS_PAGES);
+		const long pageSize = sysconf(_SC_PAGESIZE);
+		if (pages > 0 && pageSize > 0) return static_cast<std::size_t>(pages) * static_cast<std::size_t>(pageSize);
+#endif
+		return std::numeric_limits<std::size_t>::max();
+	}
+
+	// Hand `buffer` to a new scalar array on `image`; the array frees it
+	void adoptBuffer(vtkImageData* image, void* buffer, int scalarType, int numComponents, vtkIdType values, const char* name)
+	{
+		auto array = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(scalarType));
+		array->SetNumberOfComponents(numComponents);
+		array->SetName(name);
+		array->SetVoidArray(buffer, values, 0, vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+		array->SetArrayFreeFunction(&VolumeAllocator::release);
+		image->GetPointData()->SetScalars(array);
+	}
+}
+
+void VolumeAllocator::setEnabled(bool enabled)
+{
+	g_enabled = enabled;
+}
+
+bool VolumeAllocator::isEnabled()
+{
+	return g_enabled;
+}
+
+void* VolumeAllocator::allocate(std::size_t bytes, bool firstTouch)
+{
+	if (bytes == 0) return nullptr;
+
+	const std::size_t align = alignmentFor(bytes);
+	const std::size_t size = (bytes + align - 1) / align * align;
+
+	void* buffer = nullptr;
+#if defined(_WIN32)
+	buffer = _aligned_malloc(size, align);
+#else
+	if (posix_memalign(&buffer, align, size) != 0) buffer = nullptr;
+#endif
+	if (!buffer) return nullptr;
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	// Advisory only: fails harmlessly when THP is disabled system-wide
+	if (size >= HugePageSize) madvise(buffer, size, MADV_HUGEPAGE);
+#endif
+
+	if (firstTouch) {
+		unsigned char* bytesPtr = static_cast<unsigned char*>(buffer);
+		forEachChunk(size, [bytesPtr](std::size_t begin, std::size_t end) {
+			for (std::size_t offset = begin; offset < end; offset += kPageSize) bytesPtr[offset] = 0;
+		});
+	}
+	return buffer;
+}
+
+void VolumeAllocator::release(void* buffer)
+{
+#if defined(_WIN32)
+	_aligned_free(buffer);
+#else
+	std::free(buffer);
+#endif
+}
+
+void VolumeAllocator::allocateScalars(vtkImageData* image, int scalarType, int numComponents, bool firstTouch)
+{
+	if (!image) return;
+
+	int ext[6];
+	image->GetExtent(ext);
+	const vtkIdType tuples = std::max<vtkIdType>(static_cast<vtkIdType>(ext[1]) - ext[0] + 1, 0) *
+		std::max<vtkIdType>(static_cast<vtkIdType>(ext[3]) - ext[2] + 1, 0) *
+		std::max<vtkIdType>(static_cast<vtkIdType>(ext[5]) - ext[4] + 1, 0);
+
+	// Same reuse rule as vtkImageData::AllocateScalars
+	vtkDataArray* current = image->GetPointData() ? image->GetPointData()->GetScalars() : nullptr;
+	if (current && current->GetDataType() == scalarType && current->GetNumberOfComponents() == numComponents &&
+		current->GetNumberOfTuples() == tuples) {
+		return;
+	}
+
+	const vtkIdType values = tuples * numComponents;
+	const std::size_t bytes = static_cast<std::size_t>(values) * static_cast<std::size_t>(vtkDataArray::GetDataTypeSize(scalarType));
+	void* buffer = (isEnabled() && bytes >= MinimumBytes) ? allocate(bytes, firstTouch) : nullptr;
+	if (!buffer) {
+		image->AllocateScalars(scalarType, numComponents);
+		return;
+	}
+	adoptBuffer(image, buffer, scalarType, numComponents, values, "ImageScalars");
+}
+
+bool VolumeAllocator::rehome(vtkImageData* image)
+{
+	if (!isEnabled() || !image || !image->GetPointData()) return false;
+
+	vtkDataArray* scalars = image->GetPointData()->GetScalars();
+	if (!scalars || !scalars->HasStandardMemoryLayout()) return false;
+
+	const vtkIdType values = scalars->GetNumberOfValues();
+	const std::size_t bytes = static_cast<std::size_t>(values) * static_cast<std::size_t>(scalars->GetDataTypeSize());
+	if (bytes < MinimumBytes) return false;
+	// Swapping the volume out to copy it costs far more than the placement gains
+	if (bytes > availablePhysicalBytes()) return false;
+
+	// The parallel copy is the first touch
+	void* buffer = allocate(bytes, false);
+	if (!buffer) return false;
+
+	unsigned char* dst = static_cast<unsigned char*>(buffer);
+	const unsigned char* src = static_cast<const unsigned char*>(scalars->GetVoidPointer(0));
+	forEachChunk(bytes, [dst, src](std::size_t begin, std::size_t end) {
+		std::memcpy(dst + begin, src + begin, end - begin);
+	});
+
+	adoptBuffer(image, buffer, scalars->GetDataType(), scalars->GetNumberOfComponents(), values, scalars->GetName());
+	return true;
+}
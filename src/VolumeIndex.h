@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vtkType.h>
+
+// 64-bit voxel index math for vtkImageData extents.
+//
+// Extents fit in int, but products of dimensions (voxel counts and linear offsets)
+// exceed 2^31 on large scans, so every term is promoted to vtkIdType before it is
+// multiplied. The layout is vtkImageData's: x fastest, then y, then z.
+namespace VolumeIndex
+{
+	// Number of samples along `axis`; zero or negative for empty extents
+	inline vtkIdType dimension(const int extent[6], int axis)
+	{
+		return static_cast<vtkIdType>(extent[2 * axis + 1]) - extent[2 * axis] + 1;
+	}
+
+	// Voxels in the extent; 0 when it is empty or inverted
+	inline vtkIdType voxelCount(const int extent[6])
+	{
+		const vtkIdType nx = dimension(extent, 0);
+		const vtkIdType ny = dimension(extent, 1);
+		const vtkIdType nz = dimension(extent, 2);
+		if (nx <= 0 || ny <= 0 || nz <= 0) return 0;
+		return nx * ny * nz;
+	}
+
+	// Linear offset (in tuples) of voxel (i, j, k)
+	inline vtkIdType voxelOffset(const int extent[6], int i, int j, int k)
+	{
+		const vtkIdType di = static_cast<vtkIdType>(i) - extent[0];
+		const vtkIdType dj = static_cast<vtkIdType>(j) - extent[2];
+		const vtkIdType dk = static_cast<vtkIdType>(k) - extent[4];
+		return di + dimension(extent, 0) * (dj + dimension(extent, 1) * dk);
+	}
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+#include <vtkType.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Shared building blocks for per-voxel algorithms (display conversion, statistics,
+// analysis tools).
+//
+// dispatch() switches on the VTK scalar type once per volume and hands the caller a
+// typed tag, so everything below it is compiled per type. The primitives take typed
+// pointers and run on the vtkSMPTools backend; their inner loops are branch-free over
+// contiguous chunks so the compiler vectorizes them, and conversions to unsigned short
+// go through the explicit SIMD kernels in ShiftScaleKernel.h.
+//
+// Typical use:
+//
+//   VolumeKernels::dispatch(scalars->GetDataType(), [&](auto tag) {
+//       using T = VolumeKernels::ValueType<decltype(tag)>;
+//       inside = VolumeKernels::threshold(static_cast<const T*>(ptr), n, stride, lower, upper);
+//   });
+namespace VolumeKernels
+{
+	// Values per SMP task; large enough to amortize scheduling, small enough to balance
+	constexpr vtkIdType Grain = vtkIdType(1) << 16;
+
+	// Call f with a null T* for the C++ type T of `scalarType`. False for types outside
+	// vtkTemplateMacro (f is not called).
+	template <typename F>
+	bool dispatch(int scalarType, F&& f)
+	{
+		switch (scalarType) {
+			vtkTemplateMacro(f(static_cast<VTK_TT*>(nullptr)));
+			default:
+			return false;
+		}
+		return true;
+	}
+
+	template <typename Tag>
+	using ValueType = std::remove_cv_t<std::remove_pointer_t<Tag>>;
+
+	template <typename T>
+	inline bool isFinite(T v)
+	{
+		if constexpr (std::is_floating_point_v<T>) return std::isfinite(v);
+		else return true;
+	}
+
+	// Parallel reduction over [0, n). fold(acc, begin, end) accumulates a range into a
+	// thread-local Acc that starts as a copy of `init`; merge(result, acc) combines the
+	// thread results into a copy of `init`, which is returned.
+	template <typename Acc, typename Fold, typename Merge>
+	Acc reduce(vtkIdType n, const Acc& init, Fold&& fold, Merge&& merge, vtkIdType grain = Grain)
+	{
+		struct Functor
+		{
+			const Acc& init;
+			Fold& fold;
+			vtkSMPThreadLocal<Acc> local;
+
+			void Initialize() { local.Local() = init; }
+			void operator()(vtkIdType begin, vtkIdType end) { fold(local.Local(), begin, end); }
+			void Reduce() {}
+		};
+
+		Functor functor{ init, fold, {} };
+		if (n > 0) vtkSMPTools::For(0, n, grain, functor);
+
+		Acc result = init;
+		for (const Acc& acc : functor.local) merge(result, acc);
+		return result;
+	}
+
+	// Histogram of n values into `bins` bins of `width` starting at `origin`. Values
+	// outside are clamped into the first/last bin; non-finite values are skipped.
+	template <typename T>
+	std::vector<std::uint64_t> histogram(const T* data, vtkIdType n, int stride,
+		double origin, double width, std::size_t bins)
+	{
+		using Bins = std::vector<std::uint64_t>;
+		const double invWidth = width > 0.0 ? 1.0 / width : 0.0;
+		return reduce(n, Bins(bins, 0),
+			[data, stride, origin, invWidth, bins](Bins& h, vtkIdType begin, vtkIdType end) {
+				std::uint64_t* counts = h.data();
+				const T* p = data + begin * stride;
+				for (vtkIdType i = begin; i < end; ++i, p += stride) {
+					const T v = *p;
+					if (!isFinite(v)) continue;
+					const double b = (static_cast<double>(v) - origin) * invWidth;
+					++counts[std::min(static_cast<std::size_t>(std::max(b, 0.0)), bins - 1)];
+				}
+			},
+			[](Bins& h, const Bins& o) {
+				for (std::size_t b = 0; b < h.size(); ++b) h[b] += o[b];
+			});
+	}
+
+	// out[i] = f(in[i]) for n contiguous values, in parallel
+	template <typename TIn, typename TOut, typename F>
+	void map(const TIn* in, TOut* out, vtkIdType n, F&& f, vtkIdType grain = Grain)
+	{
+		vtkSMPTools::For(0, n, grain, [in, out, &f](vtkIdType begin, vtkIdType end) {
+			for (vtkIdType i = begin; i < end; ++i) out[i] = f(in[i]);
+		});
+	}
+
+	// Count the values in [lower, upper]; when `mask` is given, also write 1 (inside) or
+	// 0 (outside) per value
+	template <typename T>
+	vtkIdType threshold(const T* data, vtkIdType n, int stride, double lower, double upper,
+		unsigned char* mask = nullptr)
+	{
+		return reduce(n, vtkIdType(0),
+			[data, stride, lower, upper, mask](vtkIdType& count, vtkIdType begin, vtkIdType end) {
+				vtkIdType local = 0;
+				const T* p = data + begin * stride;
+				for (vtkIdType i = begin; i < end; ++i, p += stride) {
+					const double v = static_cast<double>(*p);
+					const unsigned char inside = (v >= lower && v <= upper) ? 1 : 0;
+					if (mask) mask[i] = inside;
+					local += inside;
+				}
+				count += local;
+			},
+			[](vtkIdType& count, const vtkIdType& o) { count += o; });
+	}
+
+	// Call f(z0, z1) for slabs of whole z-slices of `extent`, in parallel. Slabs are
+	// `depth` slices thick (the last may be thinner).
+	template <typename F>
+	void forEachSlab(const int extent[6], F&& f, int depth = 1)
+	{
+		const int slices = extent[5] - extent[4] + 1;
+		if (slices <= 0 || depth <= 0) return;
+		const vtkIdType slabs = (slices + depth - 1) / depth;
+		const int z0 = extent[4];
+		const int z1 = extent[5];
+		vtkSMPTools::For(0, slabs, 1, [&f, z0, z1, depth](vtkIdType begin, vtkIdType end) {
+			for (vtkIdType s = begin; s < end; ++s) {
+				const int first = z0 + static_cast<int>(s) * depth;
+				f(first, std::min(first + depth - 1, z1));
+			}
+		});
+	}
+
+	// Slab depth giving each task about `grain` values of `extent`
+	inline int slabDepth(const int extent[6], vtkIdType grain = Grain)
+	{
+		const vtkIdType slice = vtkIdType(std::max(extent[1] - extent[0] + 1, 1)) * std::max(extent[3] - extent[2] + 1, 1);
+		return static_cast<int>(std::clamp<vtkIdType>(grain / slice, 1, std::max(extent[5] - extent[4] + 1, 1)));
+	}
+}
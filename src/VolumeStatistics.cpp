@@ -0,0 +1,322 @@
+#include "VolumeStatistics.h"
+#include "CompressedVolume.h"
+#include "VolumeIndex.h"
+#include "VolumeKernels.h"
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkWeakPointer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+
+namespace {
+	// Histogram resolution for types that cannot be binned exactly
+	constexpr std::size_t kWideBins = 65536;
+
+	template <typename T>
+	constexpr bool hasExactBins = std::is_integral_v<T> && sizeof(T) <= 2;
+
+	struct Moments
+	{
+		double min = std::numeric_limits<double>::infinity();
+		double max = -std::numeric_limits<double>::infinity();
+		double sum = 0.0;
+		double sumSq = 0.0;
+		vtkIdType count = 0;
+		vtkIdType nonFinite = 0;
+
+		void merge(const Moments& o)
+		{
+			min = std::min(min, o.min);
+			max = std::max(max, o.max);
+			sum += o.sum;
+			sumSq += o.sumSq;
+			count += o.count;
+			nonFinite += o.nonFinite;
+		}
+	};
+
+	// Pass 1 accumulator: moments for every type, plus the exact histogram for <= 16-bit integers
+	struct MomentsAcc
+	{
+		Moments moments;
+		std::vector<std::uint64_t> histogram;
+	};
+
+	template <typename T>
+	void accumulateMoments(const T* data, int stride, vtkIdType begin, vtkIdType end, MomentsAcc& acc)
+	{
+		Moments& m = acc.moments;
+		// Accumulate the chunk in locals so the loop stays in registers
+		T lo = std::numeric_limits<T>::max();
+		T hi = std::numeric_limits<T>::lowest();
+		double sum = 0.0;
+		double sumSq = 0.0;
+		vtkIdType count = 0;
+		vtkIdType nonFinite = 0;
+
+		const T* p = data + begin * stride;
+		if constexpr (hasExactBins<T>) {
+			std::uint64_t* hist = acc.histogram.data();
+			constexpr int offset = -static_cast<int>(std::numeric_limits<T>::min());
+			for (vtkIdType i = begin; i < end; ++i, p += stride) {
+				const T v = *p;
+				lo = std::min(lo, v);
+				hi = std::max(hi, v);
+				sum += v;
+				sumSq += double(v) * double(v);
+				++hist[static_cast<int>(v) + offset];
+			}
+			count = end - begin;
+		}
+		else {
+			for (vtkIdType i = begin; i < end; ++i, p += stride) {
+				const T v = *p;
+				if (!VolumeKernels::isFinite(v)) { ++nonFinite; continue; }
+				lo = std::min(lo, v);
+				hi = std::max(hi, v);
+				const double d = static_cast<double>(v);
+				sum += d;
+				sumSq += d * d;
+				++count;
+			}
+		}
+
+		if (count > 0) {
+			m.min = std::min(m.min, static_cast<double>(lo));
+			m.max = std::max(m.max, static_cast<double>(hi));
+		}
+		m.sum += sum;
+		m.sumSq += sumSq;
+		m.count += count;
+		m.nonFinite += nonFinite;
+	}
+
+	struct CacheEntry
+	{
+		vtkWeakPointer<vtkImageData> image;
+		vtkMTimeType mtime = 0;
+		std::shared_ptr<const VolumeStatistics> stats;
+	};
+
+	std::mutex& cacheMutex()
+	{
+		static std::mutex m;
+		return m;
+	}
+
+	std::vector<CacheEntry>& cache()
+	{
+		static std::vector<CacheEntry> c;
+		return c;
+	}
+
+	vtkDataArray* firstScalars(vtkImageData* image)
+	{
+		if (!image || !image->GetPointData()) return nullptr;
+		return image->GetPointData()->GetScalars();
+	}
+
+	vtkMTimeType scalarsMTime(vtkImageData* image, vtkDataArray* scalars)
+	{
+		return std::max(image->GetMTime(), scalars->GetMTime());
+	}
+}
+
+template <typename T>
+void VolumeStatistics::computeTyped(const T* data, vtkIdType numTuples, int numComponents)
+{
+	MomentsAcc init;
+	if constexpr (hasExactBins<T>) {
+		init.histogram.assign(std::size_t(1) << (8 * sizeof(T)), 0);
+	}
+	MomentsAcc pass1 = VolumeKernels::reduce(numTuples, init,
+		[data, numComponents](MomentsAcc& acc, vtkIdType begin, vtkIdType end) {
+			accumulateMoments(data, numComponents, begin, end, acc);
+		},
+		[](MomentsAcc& result, const MomentsAcc& acc) {
+			result.moments.merge(acc.moments);
+			for (std::size_t b = 0; b < result.histogram.size(); ++b) result.histogram[b] += acc.histogram[b];
+		});
+
+	const Moments& m = pass1.moments;
+	m_count = m.count;
+	m_nonFiniteCount = m.nonFinite;
+	if (m.count > 0) {
+		m_min = m.min;
+		m_max = m.max;
+		m_mean = m.sum / static_cast<double>(m.count);
+		const double var = m.sumSq / static_cast<double>(m.count) - m_mean * m_mean;
+		m_stdDev = std::sqrt(std::max(var, 0.0));
+	}
+
+	if constexpr (hasExactBins<T>) {
+		m_histogram = std::move(pass1.histogram);
+		m_binOrigin = static_cast<double>(std::numeric_limits<T>::min());
+		m_binWidth = 1.0;
+		m_exactBins = true;
+	}
+	else {
+		// Pass 2 (wide and floating-point types): fixed-count histogram over [min, max]
+		if (m.count == 0) return;
+		const double span = m_max - m_min;
+		m_binOrigin = m_min;
+		m_binWidth = span > 0.0 ? span / static_cast<double>(kWideBins) : 1.0;
+		m_exactBins = false;
+		m_histogram = VolumeKernels::histogram(data, numTuples, numComponents, m_binOrigin, m_binWidth, kWideBins);
+	}
+}
+
+std::shared_ptr<const VolumeStatistics> VolumeStatistics::compute(vtkImageData* image)
+{
+	vtkDataArray* scalars = firstScalars(image);
+	if (!scalars || scalars->GetNumberOfTuples() == 0) return nullptr;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	std::shared_ptr<VolumeStatistics> stats(new VolumeStatistics());
+	stats->m_scalarType = scalars->GetDataType();
+
+	const vtkIdType numTuples = scalars->GetNumberOfTuples();
+	const int numComponents = scalars->GetNumberOfComponents();
+	void* raw = scalars->GetVoidPointer(0);
+
+	const bool known = VolumeKernels::dispatch(scalars->GetDataType(), [&](auto tag) {
+		using T = VolumeKernels::ValueType<decltype(tag)>;
+		stats->computeTyped(static_cast<const T*>(raw), numTuples, numComponents);
+	});
+	if (!known) return nullptr;
+
+	stats->m_computeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return stats;
+}
+
+std::shared_ptr<const VolumeStatistics> VolumeStatistics::compute(const CompressedVolume& volume)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	std::shared_ptr<VolumeStatistics> stats(new VolumeStatistics());
+	stats->m_scalarType = volume.scalarType();
+
+	// Compressed volumes hold integers of up to 16 bits, so one pass gives everything
+	bool exact = false;
+	VolumeKernels::dispatch(volume.scalarType(), [&](auto tag) {
+		using T = VolumeKernels::ValueType<decltype(tag)>;
+		if constexpr (hasExactBins<T>) {
+			exact = true;
+			MomentsAcc init;
+			init.histogram.assign(std::size_t(1) << (8 * sizeof(T)), 0);
+			// A few bricks per task: each task decodes into its own buffer
+			MomentsAcc acc = VolumeKernels::reduce(volume.numberOfBricks(), init,
+				[&volume](MomentsAcc& a, vtkIdType begin, vtkIdType end) {
+					std::vector<T> buffer(volume.brickBytes() / sizeof(T));
+					for (vtkIdType b = begin; b < end; ++b) {
+						int extent[6];
+						volume.decodeBrick(b, buffer.data(), extent);
+						accumulateMoments(buffer.data(), 1, 0, VolumeIndex::voxelCount(extent), a);
+					}
+				},
+				[](MomentsAcc& result, const MomentsAcc& a) {
+					result.moments.merge(a.moments);
+					for (std::size_t b = 0; b < result.histogram.size(); ++b) result.histogram[b] += a.histogram[b];
+				}, 16);
+
+			const Moments& m = acc.moments;
+			stats->m_count = m.count;
+			if (m.count > 0) {
+				stats->m_min = m.min;
+				stats->m_max = m.max;
+				stats->m_mean = m.sum / static_cast<double>(m.count);
+				const double var = m.sumSq / static_cast<double>(m.count) - stats->m_mean * stats->m_mean;
+				stats->m_stdDev = std::sqrt(std::max(var, 0.0));
+			}
+			stats->m_histogram = std::move(acc.histogram);
+			stats->m_binOrigin = static_cast<double>(std::numeric_limits<T>::min());
+			stats->m_binWidth = 1.0;
+			stats->m_exactBins = true;
+		}
+	});
+	if (!exact) return nullptr;
+
+	stats->m_computeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return stats;
+}
+
+void VolumeStatistics::setForImage(vtkImageData* image, std::shared_ptr<const VolumeStatistics> stats)
+{
+	vtkDataArray* scalars = firstScalars(image);
+	if (!scalars || !stats) return;
+
+	std::lock_guard<std::mutex> lock(cacheMutex());
+	auto& entries = cache();
+	auto it = std::find_if(entries.begin(), entries.end(),
+		[image](const CacheEntry& e) { return e.image == image; });
+	if (it == entries.end()) {
+		entries.emplace_back();
+		it = std::prev(entries.end());
+		it->image = image;
+	}
+	it->mtime = scalarsMTime(image, scalars);
+	it->stats = std::move(stats);
+}
+
+std::shared_ptr<const VolumeStatistics> VolumeStatistics::forImage(vtkImageData* image)
+{
+	vtkDataArray* scalars = firstScalars(image);
+	if (!scalars) return nullptr;
+
+	const vtkMTimeType mtime = scalarsMTime(image, scalars);
+
+	std::lock_guard<std::mutex> lock(cacheMutex());
+	auto& entries = cache();
+
+	// Forget images that have been destroyed
+	entries.erase(std::remove_if(entries.begin(), entries.end(),
+		[](const CacheEntry& e) { return e.image == nullptr; }), entries.end());
+
+	auto it = std::find_if(entries.begin(), entries.end(),
+		[image](const CacheEntry& e) { return e.image == image; });
+	if (it != entries.end() && it->mtime == mtime && it->stats) {
+		return it->stats;
+	}
+
+	auto stats = compute(image);
+	if (it != entries.end()) {
+		it->mtime = mtime;
+		it->stats = stats;
+	}
+	else {
+		CacheEntry entry;
+		entry.image = image;
+		entry.mtime = mtime;
+		entry.stats = stats;
+		entries.push_back(entry);
+	}
+	return stats;
+}
+
+double VolumeStatistics::percentile(double percent) const
+{
+	if (m_count == 0 || m_histogram.empty()) return 0.0;
+
+	const double target = std::clamp(percent, 0.0, 100.0) / 100.0 * static_cast<double>(m_count);
+	std::uint64_t cumulative = 0;
+	for (std::size_t b = 0; b < m_histogram.size(); ++b) {
+		if (m_histogram[b] == 0) continue;
+		cumulative += m_histogram[b];
+		if (static_cast<double>(cumulative) >= target) {
+			const double value = m_exactBins
+				? m_binOrigin + static_cast<double>(b) * m_binWidth
+				: m_binOrigin + (static_cast<double>(b) + 0.5) * m_binWidth;
+			return std::clamp(value, m_min, m_max);
+		}
+	}
+	return m_max;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vtkType.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class CompressedVolume;
+class vtkImageData;
+
+// Summary statistics of an image's scalars (first component), computed once and shared
+// by every view and tool that looks at the same image.
+//
+// Min/max/mean/standard deviation and a histogram come from a parallel pass over the
+// scalars (vtkSMPTools, thread-local accumulators merged at the end). Integer types up
+// to 16 bits get one bin per representable value, so the histogram falls out of the same
+// pass and percentiles are exact. Wider integer and floating-point types need the range
+// first and are binned into 65536 bins by a second pass. Non-finite values (NaN, +/-Inf)
+// are counted separately and excluded from everything else.
+class VolumeStatistics
+{
+public:
+	// Statistics for `image`, computed on first use and cached until the image or its
+	// scalars are modified. Returns nullptr for images without point scalars.
+	static std::shared_ptr<const VolumeStatistics> forImage(vtkImageData* image);
+
+	// Compute without consulting or filling the cache
+	static std::shared_ptr<const VolumeStatistics> compute(vtkImageData* image);
+	// Full-resolution statistics of a compressed volume from one parallel pass over its
+	// bricks, decoded outside the brick cache
+	static std::shared_ptr<const VolumeStatistics> compute(const CompressedVolume& volume);
+
+	// Have forImage() return `stats` for `image` until the image is modified, for images
+	// that stand in for a larger volume (the downsampled preview of a compressed volume)
+	static void setForImage(vtkImageData* image, std::shared_ptr<const VolumeStatistics> stats);
+
+	int scalarType() const { return m_scalarType; }
+	vtkIdType count() const { return m_count; }                   // finite values
+	vtkIdType nonFiniteCount() const { return m_nonFiniteCount; }
+
+	double minimum() const { return m_min; }
+	double maximum() const { return m_max; }
+	double mean() const { return m_mean; }
+	double standardDeviation() const { return m_stdDev; }
+
+	// Histogram: bin i covers [binOrigin() + i * binWidth(), binOrigin() + (i + 1) * binWidth())
+	const std::vector<std::uint64_t>& histogram() const { return m_histogram; }
+	double binOrigin() const { return m_binOrigin; }
+	double binWidth() const { return m_binWidth; }
+	// True when every bin holds exactly one integer value
+	bool exactBins() const { return m_exactBins; }
+
+	// Value below which `percent` (0..100) of the finite values lie. Exact for integer
+	// types up to 16 bits, otherwise accurate to one bin.
+	double percentile(double percent) const;
+
+	// Wall time of the computation, for diagnostics
+	double computeSeconds() const { return m_computeSeconds; }
+
+private:
+	VolumeStatistics() = default;
+
+	template <typename T>
+	void computeTyped(const T* data, vtkIdType numTuples, int numComponents);
+
+	int       m_scalarType = -1;
+	vtkIdType m_count = 0;
+	vtkIdType m_nonFiniteCount = 0;
+	double    m_min = 0.0;
+	double    m_max = 0.0;
+	double    m_mean = 0.0;
+	double    m_stdDev = 0.0;
+
+	std::vector<std::uint64_t> m_histogram;
+	double m_binOrigin = 0.0;
+	double m_binWidth = 1.0;
+	bool   m_exactBins = false;
+
+	double m_computeSeconds = 0.0;
+};
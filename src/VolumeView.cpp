@@ -202,13 +202,14 @@ void VolumeView::setImageData(vtkImageData* image)
 	computeShiftScaleFromInput();
 	cacheImageGeometry();
 
-	// TODO: attach ImageResliceHelper here to route post-shift/scale -> reslice -> mapper when integrating reslice workflow.
-	//       e.g. helper->SetInputConnection(m_shiftScaleFilter->GetOutputPort()); mapper->SetInputConnection(helper->GetOutputPort());
-	//
-	// Feed orthogonal vtkImageSlice mappers from the post-shift/scale output so they can be shown in 3D mode.
-	m_sliceMapperYZ->SetInputConnection(m_shiftScaleFilter->GetOutputPort());
-	m_sliceMapperXZ->SetInputConnection(m_shiftScaleFilter->GetOutputPort());
-	m_sliceMapperXY->SetInputConnection(m_shiftScaleFilter->GetOutputPort());
+	// Feed the volume mapper and the orthogonal vtkImageSlice mappers from the display input
+	// (post-shift/scale copy, or the image itself in DisplayNative). Reconnected on every call
+	// because the port changes with the display mode. Oblique planes are resliced from the
+	// same port by each SliceView (ImageResliceHelper), only over its visible region.
+	m_mapper->SetInputConnection(displayOutputPort());
+	m_sliceMapperYZ->SetInputConnection(displayOutputPort());
+	m_sliceMapperXZ->SetInputConnection(displayOutputPort());
+	m_sliceMapperXY->SetInputConnection(displayOutputPort());
 
 	// Ensure mapper orientation matches canonical axes (X normal => YZ plane, etc.)
 	m_sliceMapperYZ->SetOrientationToX();
@@ -217,15 +218,13 @@ void VolumeView::setImageData(vtkImageData* image)
 	//
 	// Place slice actors / mappers to data bounds so rendering is robust.
 	double b[6] = { 0,0,0,0,0,0 };
-	m_shiftScaleFilter->GetOutput()->GetBounds(b);
+	m_imageData->GetBounds(b);
 
-	const int cx = (m_extent[0] + m_extent[1]) / 2;
-	const int cy = (m_extent[2] + m_extent[3]) / 2;
-	const int cz = (m_extent[4] + m_extent[5]) / 2;
+	const int cx = midIndex(m_extent[0], m_extent[1]);
+	const int cy = midIndex(m_extent[2], m_extent[3]);
+	const int cz = midIndex(m_extent[4], m_extent[5]);
 
 	if (!m_imageInitialized) {
-		m_mapper->SetInputConnection(m_shiftScaleFilter->GetOutputPort());
-
 		//
 		// Add slices to the scene but keep them invisible until slicePlanesVisible is true.
 		// Use AddViewProp so image slices render in the main renderer.
@@ -301,10 +300,8 @@ void VolumeView::setImageData(vtkImageData* image)
 		m_imageInitialized = true;
 	}
 
-	// Rebuild the ACTUAL color TF to span the native image range (not 0..65535)
-	const double diff = m_scalarRangeMax - m_scalarRangeMin;
-	const double lb = diff > 0.0 ? (m_scalarRangeMin + 0.01 * diff) : m_scalarRangeMin;
-	const double ub = diff > 0.0 ? (m_scalarRangeMax - 0.01 * diff) : m_scalarRangeMax;
+	// Rebuild the ACTUAL color TF to span the automatic (percentile) window of the native image range
+	const auto [lb, ub] = autoWindowBounds();
 
 	m_actualColorTF->RemoveAllPoints();
 	m_actualColorTF->AddRGBPoint(lb, 0.0, 0.0, 0.0);
@@ -319,7 +316,7 @@ void VolumeView::setImageData(vtkImageData* image)
 	m_volumeProperty->SetScalarOpacity(m_scalarOpacity);
 
 	// Initialize WL in native domain and retain as baseline
-	const double baseWindow = std::max(ub - lb, 1.0);
+	const double baseWindow = std::max(ub - lb, minimumWindowNative());
 	const double baseLevel = 0.5 * (ub + lb);
 	setBaselineWindowLevel(baseWindow, baseLevel);
 	setColorWindowLevel(baseWindow, baseLevel); // updates opacity+color and renders
@@ -335,6 +332,9 @@ void VolumeView::setImageData(vtkImageData* image)
 	if (m_sliceMapperYZ) { m_sliceMapperYZ->SetSliceNumber(cx); m_sliceMapperYZ->Update(); }
 	if (m_sliceMapperXZ) { m_sliceMapperXZ->SetSliceNumber(cy); m_sliceMapperXZ->Update(); }
 	if (m_sliceMapperXY) { m_sliceMapperXY->SetSliceNumber(cz); m_sliceMapperXY->Update(); }
+	m_slicePlaneIndex[0] = cx;
+	m_slicePlaneIndex[1] = cy;
+	m_slicePlaneIndex[2] = cz;
 
 	updateSliceOutlineXY(cz);
 	updateSliceOutlineXZ(cy);
@@ -358,7 +358,7 @@ void VolumeView::setImageData(vtkImageData* image)
 
 void VolumeView::updateData()
 {
-	m_shiftScaleFilter->Update();
+	updateDisplayInput();
 	m_mapper->Update();
 
 	double spacing[3] = { 1,1,1 };
@@ -368,9 +368,9 @@ void VolumeView::updateData()
 	double origin[3] = { 0,0,0 };
 	m_imageData->GetOrigin(origin);
 
-	const int cx = (extent[0] + extent[1]) / 2;
-	const int cy = (extent[2] + extent[3]) / 2;
-	const int cz = (extent[4] + extent[5]) / 2;
+	const int cx = midIndex(extent[0], extent[1]);
+	const int cy = midIndex(extent[2], extent[3]);
+	const int cz = midIndex(extent[4], extent[5]);
 	updateSliceOutlineXY(cz);
 	updateSliceOutlineXZ(cy);
 	updateSliceOutlineYZ(cx);
@@ -384,7 +384,9 @@ void VolumeView::updateData()
 	if (m_sliceMapperYZ) { m_sliceMapperYZ->SetSliceNumber(cx); m_sliceMapperYZ->Update(); }
 	if (m_sliceMapperXZ) { m_sliceMapperXZ->SetSliceNumber(cy); m_sliceMapperXZ->Update(); }
 	if (m_sliceMapperXY) { m_sliceMapperXY->SetSliceNumber(cz); m_sliceMapperXY->Update(); }
-
+	m_slicePlaneIndex[0] = cx;
+	m_slicePlaneIndex[1] = cy;
+	m_slicePlaneIndex[2] = cz;
 
 	// Reset cropping to full image extent to avoid applying stale/invalid crop planes
 	if (m_mapper) {
@@ -464,14 +466,26 @@ void VolumeView::updateSlicePlanes(int x, int y, int z)
 	const int cy = std::clamp(y, m_extent[2], m_extent[3]);
 	const int cz = std::clamp(z, m_extent[4], m_extent[5]);
 
-	// Move orthogonal imageSlice mappers to requested indices so the 3D view shows the same slices.
-	if (m_sliceMapperYZ) { m_sliceMapperYZ->SetSliceNumber(cx); m_sliceMapperYZ->Update(); }
-	if (m_sliceMapperXZ) { m_sliceMapperXZ->SetSliceNumber(cy); m_sliceMapperXZ->Update(); }
-	if (m_sliceMapperXY) { m_sliceMapperXY->SetSliceNumber(cz); m_sliceMapperXY->Update(); }
+	// Move only the planes whose index changed; re-extracting an unchanged slice costs as
+	// much as a new one on large volumes
+	const bool changed[3] = { cx != m_slicePlaneIndex[0], cy != m_slicePlaneIndex[1], cz != m_slicePlaneIndex[2] };
+	if (!changed[0] && !changed[1] && !changed[2]) return;
 
-	if (m_outlineActorXY) { updateSliceOutlineXY(cz); }
-	if (m_outlineActorXZ) { updateSliceOutlineXZ(cy); }
-	if (m_outlineActorYZ) { updateSliceOutlineYZ(cx); }
+	if (changed[0]) {
+		if (m_sliceMapperYZ) { m_sliceMapperYZ->SetSliceNumber(cx); m_sliceMapperYZ->Update(); }
+		if (m_outlineActorYZ) { updateSliceOutlineYZ(cx); }
+	}
+	if (changed[1]) {
+		if (m_sliceMapperXZ) { m_sliceMapperXZ->SetSliceNumber(cy); m_sliceMapperXZ->Update(); }
+		if (m_outlineActorXZ) { updateSliceOutlineXZ(cy); }
+	}
+	if (changed[2]) {
+		if (m_sliceMapperXY) { m_sliceMapperXY->SetSliceNumber(cz); m_sliceMapperXY->Update(); }
+		if (m_outlineActorXY) { updateSliceOutlineXY(cz); }
+	}
+	m_slicePlaneIndex[0] = cx;
+	m_slicePlaneIndex[1] = cy;
+	m_slicePlaneIndex[2] = cz;
 
 	render();
 }
@@ -960,7 +974,7 @@ void VolumeView::setSliceWindowLevelNative(double window, double level)
 	const double upperNative = level + 0.5 * std::fabs(window);
 	const double lowerMapped = (lowerNative + m_scalarShift) * m_scalarScale;
 	const double upperMapped = (upperNative + m_scalarShift) * m_scalarScale;
-	const double mappedWindow = std::max(upperMapped - lowerMapped, 1.0);
+	const double mappedWindow = std::max(upperMapped - lowerMapped, minimumWindowMapped());
 	const double mappedLevel = 0.5 * (upperMapped + lowerMapped);
 
 	// Apply to each orthogonal image slice actor's property (if present)
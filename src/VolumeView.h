@@ -47,6 +47,8 @@ public:
 	// (used when a SliceView changes WL so the 3D slice actors match the 2D slices).
 	void setSliceWindowLevelNative(double window, double level);
 
+	// Move the slice planes (and their outlines) to the given indices; axes whose index is
+	// unchanged are not touched
 	void updateSlicePlanes(int x, int y, int z);
 
 	bool slicePlanesVisible() const { return m_slicePlanesVisible; }
@@ -113,6 +115,9 @@ private:
 	vtkSmartPointer<vtkActor>            m_outlineActorXZ;
 	vtkSmartPointer<vtkActor>            m_outlineActorXY;
 
+	// Indices the slice planes currently show (x, y, z)
+	int m_slicePlaneIndex[3] = { 0, 0, 0 };
+
 	// Helpers to create / update per-slice outline geometry
 	void createSliceOutlineActors();
 	void updateSliceOutlineYZ(int cx);
@@ -8,6 +8,9 @@
 #include <QTimer>
 #include <QSignalBlocker>
 
+#include <algorithm>
+#include <cmath>
+
 WindowLevelController::WindowLevelController(QWidget* parent)
 	: QWidget(parent)
 {
@@ -42,6 +45,11 @@ WindowLevelController::WindowLevelController(QWidget* parent)
 	connect(ui.m_btnReset, &QPushButton::clicked, this, [this]() {
 		emit requestResetWindowLevel();
 	});
+
+	// Auto button: percentile window/level from the cached histogram (no volume scan)
+	connect(ui.m_btnAuto, &QPushButton::clicked, this, [this]() {
+		emit requestAutoWindowLevel();
+	});
 }
 
 void WindowLevelController::setWindow(double w)
@@ -57,4 +65,42 @@ void WindowLevelController::setLevel(double l)
 	if (!ui.m_spinLevel) return;
 	QSignalBlocker b(ui.m_spinLevel);
 	ui.m_spinLevel->setValue(l);
-}
\ No newline at end of file
+}
+
+void WindowLevelController::setDataRange(double minValue, double maxValue, bool floatingPoint)
+{
+	if (!ui.m_spinWindow || !ui.m_spinLevel) return;
+	if (!std::isfinite(minValue) || !std::isfinite(maxValue)) return;
+
+	const double span = std::max(maxValue - minValue, floatingPoint ? 0.0 : 1.0);
+
+	// Integer data keeps the designer defaults (2 decimals, unit steps); float data needs
+	// about four significant digits below the span, e.g. 6 decimals for a 0..1 range.
+	int decimals = 2;
+	double step = 1.0;
+	if (floatingPoint && span > 0.0) {
+		decimals = std::clamp(4 - static_cast<int>(std::floor(std::log10(span))), 2, 10);
+		step = span / 1000.0;
+	}
+
+	// Windows may be negative (inverted ramp) and up to twice the span wide;
+	// levels may sit up to one span outside the data range.
+	double wMax = 2.0 * span;
+	double lMin = minValue - span;
+	double lMax = maxValue + span;
+	if (!floatingPoint) {
+		// Never narrower than the designer defaults for integer data
+		wMax = std::max(wMax, 65535.0);
+		lMin = std::min(lMin, -65535.0);
+		lMax = std::max(lMax, 65535.0);
+	}
+
+	QSignalBlocker bw(ui.m_spinWindow);
+	QSignalBlocker bl(ui.m_spinLevel);
+	ui.m_spinWindow->setDecimals(decimals);
+	ui.m_spinLevel->setDecimals(decimals);
+	ui.m_spinWindow->setRange(-wMax, wMax);
+	ui.m_spinLevel->setRange(lMin, lMax);
+	ui.m_spinWindow->setSingleStep(step);
+	ui.m_spinLevel->setSingleStep(step);
+}
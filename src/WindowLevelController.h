@@ -17,6 +17,9 @@ public Q_SLOTS:
 	// Set UI values (can be connected to view signals)
 	void setWindow(double w);
 	void setLevel(double l);
+	// Adapt spin box ranges, precision and step to the image's native scalar range.
+	// Floating-point data gets enough decimals to edit windows in physical units.
+	void setDataRange(double minValue, double maxValue, bool floatingPoint);
 
 Q_SIGNALS:
 	// interactive (fires while user adjusts when InteractiveApply is enabled)
@@ -25,6 +28,8 @@ Q_SIGNALS:
 	void windowLevelCommitted(double window, double level);
 	// request to reset window/level to baseline across views
 	void requestResetWindowLevel();
+	// request an automatic window/level from the image histogram
+	void requestAutoWindowLevel();
 
 private:
 	Ui::WindowLevelController ui;
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "ShiftScaleKernel.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Window/level-to-RGBA kernels used by SliceCompositor.
+//
+// Each value is mapped to a grey level g = clamp((double(in) + shift) * scale, 0, 255),
+// truncated, which is what vtkImageMapToWindowLevelColors does without a lookup table
+// (shift = window / 2 - level, scale = 255 / window). The output pixel is table[g] when a
+// 256-entry colour table is given and opaque grey otherwise. Pixels are packed words with
+// R in the low byte, i.e. R, G, B, A bytes in memory on the little-endian hosts we build
+// for. As in ShiftScaleKernel.h the arithmetic stays in double on every path, so the
+// vector results are bit-identical to the scalar reference, NaN maps to 0, and the AVX2
+// loops are chosen at run time.
+namespace WindowLevelKernel
+{
+	inline std::uint32_t grey(std::uint32_t g) { return g * 0x010101u | 0xFF000000u; }
+
+	inline std::uint32_t levelOne(double value, double shift, double scale)
+	{
+		double val = (value + shift) * scale;
+		if (val > 255.0) val = 255.0;
+		if (!(val >= 0.0)) val = 0.0; // also catches NaN
+		return static_cast<std::uint32_t>(val);
+	}
+
+	template <typename T>
+	inline void toRGBAScalar(const T* in, std::uint32_t* out, std::size_t n, double shift, double scale,
+		const std::uint32_t* table)
+	{
+		if (table) {
+			for (std::size_t i = 0; i < n; ++i) out[i] = table[levelOne(static_cast<double>(in[i]), shift, scale)];
+		}
+		else {
+			for (std::size_t i = 0; i < n; ++i) out[i] = grey(levelOne(static_cast<double>(in[i]), shift, scale));
+		}
+	}
+
+#if defined(CTANALYZERX_X86_64)
+	namespace detail
+	{
+		// Grey levels of 8 input values as 32-bit lanes
+		template <typename T>
+		CTANALYZERX_TARGET_AVX2 inline __m256i levels8(const T* p, __m256d shift, __m256d scale, __m256d zero, __m256d top)
+		{
+			__m256d lo, hi;
+			ShiftScaleKernel::detail::load8(p, lo, hi);
+			const __m128i a = ShiftScaleKernel::detail::clampTruncate(lo, shift, scale, zero, top);
+			const __m128i b = ShiftScaleKernel::detail::clampTruncate(hi, shift, scale, zero, top);
+			return _mm256_inserti128_si256(_mm256_castsi128_si256(a), b, 1);
+		}
+
+		// Maps whole groups of 8 and returns how many values it handled
+		template <typename T>
+		CTANALYZERX_TARGET_AVX2 std::size_t toRGBAAvx2(const T* in, std::uint32_t* out, std::size_t n,
+			double shift, double scale, const std::uint32_t* table)
+		{
+			const __m256d vShift = _mm256_set1_pd(shift);
+			const __m256d vScale = _mm256_set1_pd(scale);
+			const __m256d vZero = _mm256_setzero_pd();
+			const __m256d vTop = _mm256_set1_pd(255.0);
+			std::size_t i = 0;
+			if (table) {
+				const int* base = reinterpret_cast<const int*>(table);
+				for (; i + 8 <= n; i += 8) {
+					const __m256i g = levels8(in + i, vShift, vScale, vZero, vTop);
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_i32gather_epi32(base, g, 4));
+				}
+			}
+			else {
+				const __m256i vGrey = _mm256_set1_epi32(0x010101);
+				const __m256i vAlpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+				for (; i + 8 <= n; i += 8) {
+					const __m256i g = levels8(in + i, vShift, vScale, vZero, vTop);
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+						_mm256_or_si256(_mm256_mullo_epi32(g, vGrey), vAlpha));
+				}
+			}
+			return i;
+		}
+	}
+
+	template <typename T>
+	inline void toRGBA(const T* in, std::uint32_t* out, std::size_t n, double shift, double scale,
+		const std::uint32_t* table)
+	{
+		std::size_t i = 0;
+		if constexpr (ShiftScaleKernel::hasVectorPath<T>) {
+			if (CpuFeatures::hasAvx2()) i = detail::toRGBAAvx2(in, out, n, shift, scale, table);
+		}
+		toRGBAScalar(in + i, out + i, n - i, shift, scale, table);
+	}
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	namespace detail
+	{
+		// Grey levels of 4 input values as 32-bit lanes
+		template <typename T>
+		inline uint32x4_t levels4(const T* p, float64x2_t shift, float64x2_t scale, float64x2_t zero, float64x2_t top)
+		{
+			float64x2_t lo, hi;
+			ShiftScaleKernel::detail::load4(p, lo, hi);
+			return vmovl_u16(ShiftScaleKernel::detail::clampTruncate(lo, hi, shift, scale, zero, top));
+		}
+	}
+
+	template <typename T>
+	inline void toRGBA(const T* in, std::uint32_t* out, std::size_t n, double shift, double scale,
+		const std::uint32_t* table)
+	{
+		std::size_t i = 0;
+		if constexpr (ShiftScaleKernel::hasVectorPath<T>) {
+			const float64x2_t vShift = vdupq_n_f64(shift);
+			const float64x2_t vScale = vdupq_n_f64(scale);
+			const float64x2_t vZero = vdupq_n_f64(0.0);
+			const float64x2_t vTop = vdupq_n_f64(255.0);
+			if (table) {
+				// No gather on NEON; the level computation is still vectorized
+				std::uint32_t g[4];
+				for (; i + 4 <= n; i += 4) {
+					vst1q_u32(g, detail::levels4(in + i, vShift, vScale, vZero, vTop));
+					out[i] = table[g[0]];
+					out[i + 1] = table[g[1]];
+					out[i + 2] = table[g[2]];
+					out[i + 3] = table[g[3]];
+				}
+			}
+			else {
+				const uint32x4_t vAlpha = vdupq_n_u32(0xFF000000u);
+				for (; i + 4 <= n; i += 4) {
+					const uint32x4_t g = detail::levels4(in + i, vShift, vScale, vZero, vTop);
+					vst1q_u32(out + i, vorrq_u32(vmulq_n_u32(g, 0x010101u), vAlpha));
+				}
+			}
+		}
+		toRGBAScalar(in + i, out + i, n - i, shift, scale, table);
+	}
+
+#else
+	template <typename T>
+	inline void toRGBA(const T* in, std::uint32_t* out, std::size_t n, double shift, double scale,
+		const std::uint32_t* table)
+	{
+		toRGBAScalar(in, out, n, shift, scale, table);
+	}
+#endif
+}
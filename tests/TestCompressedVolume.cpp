@@ -0,0 +1,200 @@
+#include "CompressedVolume.h"
+#include "TestImages.h"
+#include "VolumeStatistics.h"
+
+#include <catch2/catch.hpp>
+
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTypeTraits.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+	// Partial bricks on every axis and an extent that does not start at 0
+	const int kExtent[6] = { -3, 41, 5, 38, 10, 44 };
+
+	// Values base + [0, 2^bits) with both ends recurring, so bricks pack at up to `bits`
+	// bits (widths that do not divide 64 straddle 64-bit words)
+	template <typename T>
+	vtkSmartPointer<vtkImageData> makeImage(int bits, unsigned seed)
+	{
+		const std::int64_t span = (std::int64_t(1) << bits) - 1;
+		const std::int64_t top = static_cast<std::int64_t>(vtkTypeTraits<T>::Max()) - span;
+		const std::int64_t base = std::max<std::int64_t>(vtkTypeTraits<T>::Min(), std::min(-span / 2, top));
+		vtkSmartPointer<vtkImageData> image = TestImages::random<T>(kExtent,
+			static_cast<double>(base), static_cast<double>(base + span), seed);
+
+		T* data = static_cast<T*>(image->GetScalarPointer());
+		const vtkIdType n = image->GetNumberOfPoints();
+		for (vtkIdType i = 0; i < n; i += 97) {
+			data[i] = static_cast<T>(base);
+			if (i + 1 < n) data[i + 1] = static_cast<T>(base + span);
+		}
+		return image;
+	}
+
+	template <typename T>
+	void requireSameVoxels(CompressedVolume& volume, vtkImageData* image)
+	{
+		const T* data = static_cast<const T*>(image->GetScalarPointer());
+		vtkIdType n = 0;
+		for (int k = kExtent[4]; k <= kExtent[5]; ++k) {
+			for (int j = kExtent[2]; j <= kExtent[3]; ++j) {
+				for (int i = kExtent[0]; i <= kExtent[1]; ++i, ++n) {
+					if (volume.voxelValue(i, j, k) != static_cast<double>(data[n])) {
+						FAIL("voxel (" << i << ", " << j << ", " << k << ") differs");
+					}
+				}
+			}
+		}
+	}
+
+	void requireSameSlices(CompressedVolume& volume, vtkImageData* image)
+	{
+		for (int axis = 0; axis < 3; ++axis) {
+			for (int index = kExtent[2 * axis]; index <= kExtent[2 * axis + 1]; ++index) {
+				vtkNew<vtkImageData> slice;
+				REQUIRE(volume.extractSlice(axis, index, slice));
+
+				int sliceExt[6];
+				slice->GetExtent(sliceExt);
+				vtkNew<vtkImageData> expected;
+				expected->SetExtent(sliceExt);
+				expected->AllocateScalars(image->GetScalarType(), 1);
+				expected->CopyAndCastFrom(image, sliceExt);
+
+				const std::size_t bytes = static_cast<std::size_t>(slice->GetNumberOfPoints()) * slice->GetScalarSize();
+				REQUIRE(std::memcmp(slice->GetScalarPointer(), expected->GetScalarPointer(), bytes) == 0);
+			}
+		}
+	}
+}
+
+TEMPLATE_TEST_CASE("Bricks pack and decode losslessly at every bit width", "[CompressedVolume]",
+	std::int8_t, std::uint8_t, std::int16_t, std::uint16_t)
+{
+	const int typeBits = static_cast<int>(8 * sizeof(TestType));
+	const int bits = GENERATE(1, 2, 3, 5, 7, 8, 11, 13, 15, 16);
+	if (bits > typeBits) return;
+
+	vtkSmartPointer<vtkImageData> image = makeImage<TestType>(bits, static_cast<unsigned>(bits));
+	std::shared_ptr<CompressedVolume> volume = CompressedVolume::fromImage(image);
+	REQUIRE(volume != nullptr);
+	REQUIRE(volume->compressedBytes() <= volume->uncompressedBytes() * bits / typeBits + 64 * 1024);
+
+	requireSameVoxels<TestType>(*volume, image);
+	requireSameSlices(*volume, image);
+
+	SECTION("A one-brick cache decodes the same values")
+	{
+		volume->setCacheBudgetBytes(1);
+		requireSameSlices(*volume, image);
+	}
+}
+
+TEST_CASE("Uniform bricks decode to their value", "[CompressedVolume]")
+{
+	vtkNew<vtkImageData> image;
+	image->SetExtent(const_cast<int*>(kExtent));
+	image->AllocateScalars(VTK_SHORT, 1);
+	auto* data = static_cast<std::int16_t*>(image->GetScalarPointer());
+	std::fill(data, data + image->GetNumberOfPoints(), std::int16_t(-1000));
+
+	std::shared_ptr<CompressedVolume> volume = CompressedVolume::fromImage(image);
+	REQUIRE(volume != nullptr);
+	requireSameVoxels<std::int16_t>(*volume, image);
+	requireSameSlices(*volume, image);
+}
+
+TEST_CASE("Slabs streamed in order give the same volume", "[CompressedVolume]")
+{
+	vtkSmartPointer<vtkImageData> image = makeImage<std::uint16_t>(12, 3);
+	CompressedVolume volume(kExtent, image->GetSpacing(), image->GetOrigin(), VTK_UNSIGNED_SHORT);
+	for (int z0 = kExtent[4]; z0 <= kExtent[5]; z0 += CompressedVolume::BrickSize) {
+		int slabExt[6] = { kExtent[0], kExtent[1], kExtent[2], kExtent[3],
+			z0, std::min(z0 + CompressedVolume::BrickSize - 1, kExtent[5]) };
+		vtkNew<vtkImageData> slab;
+		slab->SetExtent(slabExt);
+		slab->AllocateScalars(VTK_UNSIGNED_SHORT, 1);
+		slab->CopyAndCastFrom(image, slabExt);
+		REQUIRE(volume.appendSlab(slab));
+	}
+	REQUIRE(volume.isComplete());
+	requireSameVoxels<std::uint16_t>(volume, image);
+}
+
+TEST_CASE("Whole-volume passes see every voxel once", "[CompressedVolume]")
+{
+	vtkSmartPointer<vtkImageData> image = makeImage<std::int16_t>(11, 5);
+	std::shared_ptr<CompressedVolume> volume = CompressedVolume::fromImage(image);
+	REQUIRE(volume != nullptr);
+
+	SECTION("Bricks decode outside the cache")
+	{
+		std::vector<std::int16_t> brick(volume->brickBytes() / sizeof(std::int16_t));
+		vtkIdType voxels = 0;
+		for (vtkIdType b = 0; b < volume->numberOfBricks(); ++b) {
+			int ext[6];
+			volume->decodeBrick(b, brick.data(), ext);
+			std::size_t n = 0;
+			for (int k = ext[4]; k <= ext[5]; ++k) {
+				for (int j = ext[2]; j <= ext[3]; ++j) {
+					for (int i = ext[0]; i <= ext[1]; ++i, ++n, ++voxels) {
+						REQUIRE(brick[n] == *static_cast<const std::int16_t*>(image->GetScalarPointer(i, j, k)));
+					}
+				}
+			}
+		}
+		REQUIRE(voxels == image->GetNumberOfPoints());
+	}
+
+	SECTION("A reader gives the stored voxels")
+	{
+		volume->setCacheBudgetBytes(1);
+		CompressedVolume::Reader reader(*volume);
+		for (int k = kExtent[5]; k >= kExtent[4]; k -= 7) {
+			for (int j = kExtent[2]; j <= kExtent[3]; j += 3) {
+				for (int i = kExtent[0]; i <= kExtent[1]; ++i) {
+					REQUIRE(reader.value(i, j, k) == *static_cast<const std::int16_t*>(image->GetScalarPointer(i, j, k)));
+				}
+			}
+		}
+	}
+
+	SECTION("Statistics match those of the image")
+	{
+		std::shared_ptr<const VolumeStatistics> expected = VolumeStatistics::compute(image);
+		std::shared_ptr<const VolumeStatistics> stats = VolumeStatistics::compute(*volume);
+		REQUIRE(stats != nullptr);
+		REQUIRE(stats->count() == expected->count());
+		REQUIRE(stats->minimum() == expected->minimum());
+		REQUIRE(stats->maximum() == expected->maximum());
+		REQUIRE(stats->mean() == Approx(expected->mean()));
+		REQUIRE(stats->standardDeviation() == Approx(expected->standardDeviation()));
+		REQUIRE(stats->histogram() == expected->histogram());
+	}
+}
+
+TEST_CASE("The default cache holds a brick layer of every orientation", "[CompressedVolume]")
+{
+	// 2048 x 2048 x 3000 int16: YZ and XZ layers are 64 x 94 bricks of 64 KB (376 MB)
+	const int extent[6] = { 0, 2047, 0, 2047, 0, 2999 };
+	const double spacing[3] = { 1.0, 1.0, 1.0 };
+	const double origin[3] = { 0.0, 0.0, 0.0 };
+	CompressedVolume volume(extent, spacing, origin, VTK_SHORT);
+
+	const std::size_t brickBytes = std::size_t(32) * 32 * 32 * 2;
+	const std::size_t layerYZ = std::size_t(64) * 94 * brickBytes;
+	const std::size_t layerXY = std::size_t(64) * 64 * brickBytes;
+	REQUIRE(volume.cacheBudgetBytes() >= 3 * layerYZ + layerXY);
+
+	volume.setCacheBudgetBytes(std::size_t(64) << 20);
+	REQUIRE(volume.cacheBudgetBytes() == std::size_t(64) << 20);
+	volume.setCacheBudgetBytes(0);
+	REQUIRE(volume.cacheBudgetBytes() == volume.defaultCacheBudgetBytes());
+}
@@ -0,0 +1,57 @@
+#include "ImageShiftScaleFilter.h"
+#include "TestImages.h"
+
+#include <catch2/catch.hpp>
+
+#include <vtkImageData.h>
+#include <vtkImageShiftScale.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTypeTraits.h>
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+	// Rows of 37 values exercise the vector loops and their scalar tails
+	const int kExtent[6] = { 0, 36, 0, 18, 0, 5 };
+
+	// Values across the whole type range, so both clamps are hit
+	template <typename T>
+	vtkSmartPointer<vtkImageData> makeImage()
+	{
+		const double lo = std::is_floating_point_v<T> ? -1e6 : static_cast<double>(vtkTypeTraits<T>::Min());
+		const double hi = std::is_floating_point_v<T> ? 1e6 : static_cast<double>(vtkTypeTraits<T>::Max());
+		return TestImages::random<T>(kExtent, lo, hi, 7);
+	}
+
+	template <typename Filter>
+	vtkSmartPointer<vtkImageData> convert(vtkImageData* image, double shift, double scale)
+	{
+		vtkNew<Filter> filter;
+		filter->SetInputData(image);
+		filter->SetShift(shift);
+		filter->SetScale(scale);
+		filter->SetOutputScalarTypeToUnsignedShort();
+		filter->ClampOverflowOn();
+		filter->Update();
+		return filter->GetOutput();
+	}
+}
+
+TEMPLATE_TEST_CASE("ImageShiftScaleFilter matches vtkImageShiftScale", "[ImageShiftScaleFilter]",
+	std::int8_t, std::uint8_t, std::int16_t, std::uint16_t, std::int32_t, std::uint32_t, float, double)
+{
+	vtkSmartPointer<vtkImageData> image = makeImage<TestType>();
+	const double shift = GENERATE(0.0, 1024.0, -123.25);
+	const double scale = GENERATE(1.0, 0.37, 16.0);
+
+	vtkSmartPointer<vtkImageData> expected = convert<vtkImageShiftScale>(image, shift, scale);
+	vtkSmartPointer<vtkImageData> actual = convert<ImageShiftScaleFilter>(image, shift, scale);
+
+	REQUIRE(actual->GetScalarType() == VTK_UNSIGNED_SHORT);
+	REQUIRE(actual->GetNumberOfPoints() == expected->GetNumberOfPoints());
+	const std::size_t bytes = static_cast<std::size_t>(expected->GetNumberOfPoints()) * sizeof(unsigned short);
+	REQUIRE(std::memcmp(actual->GetScalarPointer(), expected->GetScalarPointer(), bytes) == 0);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vtkImageData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTypeTraits.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+
+// Random volumes shared by the tests and the benchmarks
+namespace TestImages
+{
+	// CT-like values: air, tissue and bone
+	constexpr double CTLow = -1200.0;
+	constexpr double CTHigh = 3500.0;
+
+	// Single-component image of `extent` with values drawn uniformly from [lo, hi]
+	// (whole numbers for integer types), the same for the same seed
+	template <typename T>
+	vtkSmartPointer<vtkImageData> random(const int extent[6], double lo, double hi, unsigned seed)
+	{
+		auto image = vtkSmartPointer<vtkImageData>::New();
+		image->SetExtent(const_cast<int*>(extent));
+		image->AllocateScalars(vtkTypeTraits<T>::VTK_TYPE_ID, 1);
+
+		std::mt19937 rng(seed);
+		T* data = static_cast<T*>(image->GetScalarPointer());
+		const vtkIdType n = image->GetNumberOfPoints();
+		if constexpr (std::is_integral_v<T>) {
+			std::uniform_int_distribution<std::int64_t> value(std::llround(lo), std::llround(hi));
+			for (vtkIdType i = 0; i < n; ++i) data[i] = static_cast<T>(value(rng));
+		}
+		else {
+			std::uniform_real_distribution<double> value(lo, hi);
+			for (vtkIdType i = 0; i < n; ++i) data[i] = static_cast<T>(value(rng));
+		}
+		return image;
+	}
+}
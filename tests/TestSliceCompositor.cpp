@@ -0,0 +1,112 @@
+#include "SliceCompositor.h"
+#include "TestImages.h"
+
+#include <catch2/catch.hpp>
+
+#include <vtkImageData.h>
+#include <vtkImageMapToWindowLevelColors.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTypeTraits.h>
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace {
+	// Rows of 37 values exercise the vector loops and their scalar tails
+	const int kExtent[6] = { 0, 36, 0, 28, 0, 22 };
+
+	// The whole volume and one slice per orientation, as vtkImageSliceMapper requests them.
+	// In the YZ slice the rows run along y, which is strided in the input.
+	const int kUpdateExtents[4][6] = {
+		{ 0, 36, 0, 28, 0, 22 },
+		{ 0, 36, 0, 28, 11, 11 },
+		{ 0, 36, 13, 13, 0, 22 },
+		{ 17, 17, 0, 28, 0, 22 }
+	};
+
+	template <typename T>
+	vtkSmartPointer<vtkImageData> makeImage(double& lo, double& hi)
+	{
+		// Wide types are kept to a CT-like range so the windows below resolve their values
+		const bool wide = std::is_floating_point_v<T> || sizeof(T) > 2;
+		lo = wide ? TestImages::CTLow : static_cast<double>(vtkTypeTraits<T>::Min());
+		hi = wide ? TestImages::CTHigh : static_cast<double>(vtkTypeTraits<T>::Max());
+		if (std::is_unsigned_v<T>) lo = 0.0;
+		return TestImages::random<T>(kExtent, lo, hi, 11);
+	}
+
+	template <typename Filter>
+	vtkSmartPointer<vtkImageData> composite(vtkImageData* image, double window, double level, const int updateExtent[6],
+		const std::vector<std::uint32_t>* table = nullptr)
+	{
+		vtkNew<Filter> filter;
+		filter->SetInputData(image);
+		filter->SetWindow(window);
+		filter->SetLevel(level);
+		filter->SetOutputFormatToRGBA();
+		if constexpr (std::is_same_v<Filter, SliceCompositor>) {
+			if (table) filter->setColorTable(*table);
+		}
+		filter->UpdateExtent(updateExtent);
+		return filter->GetOutput();
+	}
+
+	std::size_t scalarBytes(vtkImageData* image)
+	{
+		return static_cast<std::size_t>(image->GetNumberOfPoints()) * image->GetNumberOfScalarComponents() * image->GetScalarSize();
+	}
+}
+
+TEMPLATE_TEST_CASE("SliceCompositor matches vtkImageMapToWindowLevelColors", "[SliceCompositor]",
+	std::int8_t, std::uint8_t, std::int16_t, std::uint16_t, std::int32_t, std::uint32_t, float, double)
+{
+	double lo = 0.0, hi = 0.0;
+	vtkSmartPointer<vtkImageData> image = makeImage<TestType>(lo, hi);
+
+	// Full range, a narrow window low in the range, and a window of a few values. Levels
+	// are off the half-integer so unsigned char input is never passed through untouched
+	// (window 255 / level 127.5).
+	const int windowIndex = GENERATE(0, 1, 2);
+	const double span = hi - lo;
+	const double windows[3] = { span, span / 10.0, 3.0 };
+	const double levels[3] = { lo + span / 2.0 + 1.0, lo + span / 3.0, lo + span / 2.0 + 0.25 };
+	const double window = windows[windowIndex];
+	const double level = levels[windowIndex];
+
+	for (const auto& updateExtent : kUpdateExtents) {
+		vtkSmartPointer<vtkImageData> expected = composite<vtkImageMapToWindowLevelColors>(image, window, level, updateExtent);
+		vtkSmartPointer<vtkImageData> actual = composite<SliceCompositor>(image, window, level, updateExtent);
+
+		REQUIRE(actual->GetScalarType() == VTK_UNSIGNED_CHAR);
+		REQUIRE(actual->GetNumberOfScalarComponents() == 4);
+		REQUIRE(actual->GetNumberOfPoints() == expected->GetNumberOfPoints());
+		REQUIRE(std::memcmp(actual->GetScalarPointer(), expected->GetScalarPointer(), scalarBytes(expected)) == 0);
+	}
+}
+
+TEST_CASE("SliceCompositor indexes the colour table by the windowed grey level", "[SliceCompositor]")
+{
+	double lo = 0.0, hi = 0.0;
+	vtkSmartPointer<vtkImageData> image = makeImage<std::int16_t>(lo, hi);
+	const double window = (hi - lo) / 4.0;
+	const double level = lo + (hi - lo) / 2.0;
+
+	// A table that is not a grey ramp: each grey level g maps to (g, 255 - g, g / 2, 200)
+	std::vector<std::uint32_t> table(256);
+	for (std::uint32_t g = 0; g < 256; ++g) table[g] = g | (255 - g) << 8 | (g / 2) << 16 | 200u << 24;
+
+	for (const auto& updateExtent : kUpdateExtents) {
+		vtkSmartPointer<vtkImageData> grey = composite<vtkImageMapToWindowLevelColors>(image, window, level, updateExtent);
+		vtkSmartPointer<vtkImageData> colored = composite<SliceCompositor>(image, window, level, updateExtent, &table);
+		REQUIRE(colored->GetNumberOfPoints() == grey->GetNumberOfPoints());
+
+		const auto* greyRGBA = static_cast<const unsigned char*>(grey->GetScalarPointer());
+		const auto* coloredRGBA = static_cast<const std::uint32_t*>(colored->GetScalarPointer());
+		for (vtkIdType i = 0; i < grey->GetNumberOfPoints(); ++i) {
+			if (coloredRGBA[i] != table[greyRGBA[4 * i]]) FAIL("pixel " << i << " differs");
+		}
+	}
+}
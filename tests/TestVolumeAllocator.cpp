@@ -0,0 +1,186 @@
+#include "VolumeAllocator.h"
+
+#include <catch2/catch.hpp>
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+	// 512 x 512 x 64 shorts: 32 MB, above VolumeAllocator::MinimumBytes
+	const int kLargeExtent[6] = { 0, 511, 0, 511, 0, 63 };
+	// 256 x 256 x 64 shorts: 8 MB, below it
+	const int kSmallExtent[6] = { 0, 255, 0, 255, 0, 63 };
+
+	bool isAligned(const void* p, std::size_t alignment)
+	{
+		return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+	}
+
+	void fillRamp(vtkImageData* image)
+	{
+		auto* data = static_cast<std::int16_t*>(image->GetScalarPointer());
+		const vtkIdType n = image->GetNumberOfPoints();
+		for (vtkIdType i = 0; i < n; ++i) data[i] = static_cast<std::int16_t>(i * 7);
+	}
+
+	bool hasRamp(vtkImageData* image)
+	{
+		const auto* data = static_cast<const std::int16_t*>(image->GetScalarPointer());
+		const vtkIdType n = image->GetNumberOfPoints();
+		for (vtkIdType i = 0; i < n; ++i) {
+			if (data[i] != static_cast<std::int16_t>(i * 7)) return false;
+		}
+		return true;
+	}
+
+	// Restores the global switch when a test leaves
+	struct EnabledGuard
+	{
+		bool previous = VolumeAllocator::isEnabled();
+		explicit EnabledGuard(bool enabled) { VolumeAllocator::setEnabled(enabled); }
+		~EnabledGuard() { VolumeAllocator::setEnabled(previous); }
+	};
+}
+
+TEST_CASE("The allocator is off until enabled", "[VolumeAllocator]")
+{
+	// rehome() keeps two copies of the volume resident while it moves one
+	REQUIRE_FALSE(VolumeAllocator::isEnabled());
+}
+
+TEST_CASE("Raw buffers are aligned for SIMD and huge pages", "[VolumeAllocator]")
+{
+	REQUIRE(VolumeAllocator::allocate(0) == nullptr);
+
+	void* small = VolumeAllocator::allocate(1000);
+	REQUIRE(small != nullptr);
+	REQUIRE(isAligned(small, VolumeAllocator::Alignment));
+	VolumeAllocator::release(small);
+
+	void* large = VolumeAllocator::allocate(VolumeAllocator::HugePageSize * 3 + 5, false);
+	REQUIRE(large != nullptr);
+	REQUIRE(isAligned(large, VolumeAllocator::HugePageSize));
+	VolumeAllocator::release(large);
+}
+
+TEST_CASE("allocateScalars gives large volumes an allocator buffer", "[VolumeAllocator]")
+{
+	EnabledGuard enabled(true);
+	vtkNew<vtkImageData> image;
+	image->SetExtent(const_cast<int*>(kLargeExtent));
+	VolumeAllocator::allocateScalars(image, VTK_SHORT, 1);
+
+	vtkDataArray* scalars = image->GetPointData()->GetScalars();
+	REQUIRE(scalars != nullptr);
+	REQUIRE(scalars->GetDataType() == VTK_SHORT);
+	REQUIRE(scalars->GetNumberOfComponents() == 1);
+	REQUIRE(scalars->GetNumberOfTuples() == image->GetNumberOfPoints());
+	REQUIRE(isAligned(image->GetScalarPointer(), VolumeAllocator::HugePageSize));
+
+	fillRamp(image);
+	REQUIRE(hasRamp(image));
+
+	SECTION("Matching scalars are reused")
+	{
+		void* before = image->GetScalarPointer();
+		VolumeAllocator::allocateScalars(image, VTK_SHORT, 1);
+		REQUIRE(image->GetScalarPointer() == before);
+		REQUIRE(hasRamp(image));
+	}
+
+	SECTION("A different type or component count replaces them")
+	{
+		VolumeAllocator::allocateScalars(image, VTK_FLOAT, 1);
+		REQUIRE(image->GetScalarType() == VTK_FLOAT);
+		REQUIRE(image->GetPointData()->GetScalars()->GetNumberOfTuples() == image->GetNumberOfPoints());
+
+		VolumeAllocator::allocateScalars(image, VTK_FLOAT, 2);
+		REQUIRE(image->GetNumberOfScalarComponents() == 2);
+		REQUIRE(image->GetPointData()->GetScalars()->GetNumberOfTuples() == image->GetNumberOfPoints());
+	}
+
+	SECTION("Shallow copies keep the buffer alive")
+	{
+		vtkNew<vtkImageData> copy;
+		copy->ShallowCopy(image);
+		image->ReleaseData();
+		REQUIRE(hasRamp(copy));
+	}
+}
+
+TEST_CASE("allocateScalars falls back to vtkImageData::AllocateScalars", "[VolumeAllocator]")
+{
+	SECTION("Below the minimum size")
+	{
+		EnabledGuard enabled(true);
+		vtkNew<vtkImageData> image;
+		image->SetExtent(const_cast<int*>(kSmallExtent));
+		VolumeAllocator::allocateScalars(image, VTK_SHORT, 1);
+		REQUIRE(image->GetPointData()->GetScalars()->GetNumberOfTuples() == image->GetNumberOfPoints());
+		fillRamp(image);
+		REQUIRE(hasRamp(image));
+		// Too small to be worth moving either
+		void* before = image->GetScalarPointer();
+		REQUIRE_FALSE(VolumeAllocator::rehome(image));
+		REQUIRE(image->GetScalarPointer() == before);
+	}
+
+	SECTION("When disabled")
+	{
+		EnabledGuard enabled(false);
+		vtkNew<vtkImageData> image;
+		image->SetExtent(const_cast<int*>(kLargeExtent));
+		VolumeAllocator::allocateScalars(image, VTK_SHORT, 1);
+		REQUIRE(image->GetPointData()->GetScalars()->GetNumberOfTuples() == image->GetNumberOfPoints());
+		fillRamp(image);
+		void* before = image->GetScalarPointer();
+		REQUIRE_FALSE(VolumeAllocator::rehome(image));
+		REQUIRE(image->GetScalarPointer() == before);
+		REQUIRE(hasRamp(image));
+	}
+}
+
+TEST_CASE("rehome moves scalars into an allocator buffer", "[VolumeAllocator]")
+{
+	EnabledGuard enabled(true);
+	vtkNew<vtkImageData> image;
+	image->SetExtent(const_cast<int*>(kLargeExtent));
+	image->AllocateScalars(VTK_SHORT, 1);
+	image->GetPointData()->GetScalars()->SetName("Density");
+	fillRamp(image);
+
+	REQUIRE(VolumeAllocator::rehome(image));
+	vtkDataArray* scalars = image->GetPointData()->GetScalars();
+	REQUIRE(scalars->GetDataType() == VTK_SHORT);
+	REQUIRE(scalars->GetNumberOfTuples() == image->GetNumberOfPoints());
+	REQUIRE(std::strcmp(scalars->GetName(), "Density") == 0);
+	REQUIRE(isAligned(image->GetScalarPointer(), VolumeAllocator::HugePageSize));
+	REQUIRE(hasRamp(image));
+}
+
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+TEST_CASE("Adopted buffers are freed with their array", "[VolumeAllocator]")
+{
+	// glibc always serves blocks above 32 MB with mmap, so hblkhd tracks them exactly
+	EnabledGuard enabled(true);
+	const int extent[6] = { 0, 511, 0, 511, 0, 127 };
+	const std::size_t before = mallinfo2().hblkhd;
+	{
+		vtkNew<vtkImageData> image;
+		image->SetExtent(const_cast<int*>(extent));
+		VolumeAllocator::allocateScalars(image, VTK_SHORT, 1, false);
+		REQUIRE(mallinfo2().hblkhd >= before + (std::size_t(64) << 20));
+	}
+	REQUIRE(mallinfo2().hblkhd == before);
+}
+#endif
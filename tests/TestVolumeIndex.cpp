@@ -0,0 +1,198 @@
+#include "ImageLoader.h"
+#include "ImageSliceProvider.h"
+#include "VolumeIndex.h"
+
+#include <catch2/catch.hpp>
+
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 2048 x 2048 x 3000, the scan size that motivated 64-bit index math: 12.6e9 voxels
+static const int kLargeExtent[6] = { 0, 2047, 0, 2047, 0, 2999 };
+
+namespace {
+	// Stands in for a file reader: announces an unsigned short volume of the given extent
+	// and spacing and writes only the marked voxels, so huge volumes cost no page faults
+	class SyntheticReader : public vtkImageAlgorithm
+	{
+	public:
+		static SyntheticReader* New();
+		vtkTypeMacro(SyntheticReader, vtkImageAlgorithm);
+
+		int extent[6] = { 0, 0, 0, 0, 0, 0 };
+		double spacing[3] = { 1.0, 1.0, 1.0 };
+		std::vector<std::array<int, 3>> marks;
+		int executions = 0;
+
+	protected:
+		SyntheticReader() { this->SetNumberOfInputPorts(0); }
+
+		int RequestInformation(vtkInformation*, vtkInformationVector**, vtkInformationVector* outputVector) override
+		{
+			vtkInformation* outInfo = outputVector->GetInformationObject(0);
+			outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent, 6);
+			outInfo->Set(vtkDataObject::SPACING(), spacing, 3);
+			vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_UNSIGNED_SHORT, 1);
+			return 1;
+		}
+
+		void ExecuteDataWithInformation(vtkDataObject* output, vtkInformation* outInfo) override
+		{
+			++executions;
+			vtkImageData* image = this->AllocateOutputData(output, outInfo);
+			auto* data = static_cast<std::uint16_t*>(image->GetScalarPointer());
+			for (std::size_t m = 0; m < marks.size(); ++m) {
+				data[VolumeIndex::voxelOffset(extent, marks[m][0], marks[m][1], marks[m][2])] = static_cast<std::uint16_t>(1000 + m);
+			}
+		}
+	};
+	vtkStandardNewMacro(SyntheticReader);
+}
+
+TEST_CASE("Voxel counts past 2^31 are exact", "[VolumeIndex]")
+{
+	REQUIRE(VolumeIndex::voxelCount(kLargeExtent) == vtkIdType(2048) * 2048 * 3000);
+	REQUIRE(VolumeIndex::voxelCount(kLargeExtent) > vtkIdType(INT_MAX));
+
+	// Extents need not start at zero
+	const int shifted[6] = { -1024, 1023, 100, 2147, -5, 2994 };
+	REQUIRE(VolumeIndex::voxelCount(shifted) == VolumeIndex::voxelCount(kLargeExtent));
+
+	const int empty[6] = { 0, 9, 5, 4, 0, 9 };
+	REQUIRE(VolumeIndex::voxelCount(empty) == 0);
+}
+
+TEST_CASE("Voxel offsets past 2^31 are exact", "[VolumeIndex]")
+{
+	REQUIRE(VolumeIndex::voxelOffset(kLargeExtent, 0, 0, 0) == 0);
+	REQUIRE(VolumeIndex::voxelOffset(kLargeExtent, 1, 0, 0) == 1);
+	REQUIRE(VolumeIndex::voxelOffset(kLargeExtent, 0, 1, 0) == 2048);
+	REQUIRE(VolumeIndex::voxelOffset(kLargeExtent, 0, 0, 1) == vtkIdType(2048) * 2048);
+	// The last voxel is the count minus one; 32-bit math wraps long before that
+	REQUIRE(VolumeIndex::voxelOffset(kLargeExtent, 2047, 2047, 2999) == VolumeIndex::voxelCount(kLargeExtent) - 1);
+
+	// Index origins are subtracted before multiplying
+	const int shifted[6] = { -1024, 1023, 100, 2147, -5, 2994 };
+	REQUIRE(VolumeIndex::voxelOffset(shifted, -1024, 100, -5) == 0);
+	REQUIRE(VolumeIndex::voxelOffset(shifted, 1023, 2147, 2994) == VolumeIndex::voxelCount(shifted) - 1);
+}
+
+TEST_CASE("ValidateVolumeExtent accepts and rejects by size", "[ImageLoader]")
+{
+	std::string reason;
+
+	SECTION("Small volumes are accepted")
+	{
+		const int extent[6] = { 0, 511, 0, 511, 0, 511 };
+		REQUIRE(ImageLoader::ValidateVolumeExtent(extent, 1, 2, &reason));
+	}
+
+	SECTION("Volumes past 2^31 voxels need 64-bit ids")
+	{
+		const bool ok = ImageLoader::ValidateVolumeExtent(kLargeExtent, 1, 2, &reason);
+		if (sizeof(vtkIdType) >= 8 && sizeof(std::size_t) >= 8) {
+			REQUIRE(ok);
+		}
+		else {
+			REQUIRE_FALSE(ok);
+			REQUIRE_FALSE(reason.empty());
+		}
+	}
+
+	SECTION("Empty and inverted extents are rejected")
+	{
+		const int extent[6] = { 0, 99, 0, 99, 10, 9 };
+		REQUIRE_FALSE(ImageLoader::ValidateVolumeExtent(extent, 1, 2, &reason));
+		REQUIRE_FALSE(reason.empty());
+	}
+
+	SECTION("Voxel counts that overflow vtkIdType are rejected")
+	{
+		// (2^31 - 1)^3 voxels overflow even 64-bit ids
+		const int extent[6] = { 0, INT_MAX - 1, 0, INT_MAX - 1, 0, INT_MAX - 1 };
+		REQUIRE_FALSE(ImageLoader::ValidateVolumeExtent(extent, 1, 1, &reason));
+		REQUIRE_FALSE(reason.empty());
+	}
+
+	SECTION("Component counts that overflow vtkIdType are rejected")
+	{
+		// 2^62 voxels fit, 2^62 * 4 values do not
+		const int extent[6] = { 0, (1 << 21) - 1, 0, (1 << 21) - 1, 0, (1 << 20) - 1 };
+		if (sizeof(vtkIdType) >= 8) {
+			REQUIRE_FALSE(ImageLoader::ValidateVolumeExtent(extent, 4, 1, &reason));
+			REQUIRE_FALSE(reason.empty());
+		}
+	}
+}
+
+TEST_CASE("ImageLoader fails before reading when the resampled volume is too large", "[ImageLoader]")
+{
+	// 2^21 x 2^21 x 2 voxels resample to 2^21 x 2^21 x (2^22 + 1), past even 64-bit ids
+	vtkNew<SyntheticReader> reader;
+	const int extent[6] = { 0, (1 << 21) - 1, 0, (1 << 21) - 1, 0, 1 };
+	std::copy(extent, extent + 6, reader->extent);
+	reader->spacing[2] = double(1 << 22);
+
+	vtkNew<ImageLoader> loader;
+	loader->SetReader(reader);
+	loader->SetResampleKernel(ImageLoader::ResampleKernel::Linear);
+	const int warnings = vtkObject::GetGlobalWarningDisplay();
+	vtkObject::GlobalWarningDisplayOff();
+	loader->Update();
+	vtkObject::SetGlobalWarningDisplay(warnings);
+
+	// No extent was announced and the reader never allocated its input
+	REQUIRE(reader->executions == 0);
+	REQUIRE(loader->GetOutput()->GetNumberOfPoints() == 0);
+}
+
+// Allocates about 9 GB; hidden by default, run with `TestVolumeIndex [large]`
+TEST_CASE("A volume over 8 GB loads whole and slices read the right voxels", "[.][large]")
+{
+	if (sizeof(vtkIdType) < 8) return;
+
+	vtkNew<SyntheticReader> reader;
+	const int extent[6] = { 0, 2047, 0, 2047, 0, 1099 };
+	std::copy(extent, extent + 6, reader->extent);
+	reader->marks = { { 0, 0, 1099 }, { 2047, 2047, 1099 }, { 1000, 2047, 1050 } };
+
+	vtkNew<ImageLoader> loader;
+	loader->SetReader(reader);
+	loader->Update();
+	vtkImageData* image = loader->GetOutput();
+	REQUIRE(reader->executions == 1);
+
+	int outExtent[6];
+	image->GetExtent(outExtent);
+	REQUIRE(std::equal(outExtent, outExtent + 6, extent));
+	REQUIRE(image->GetNumberOfPoints() == VolumeIndex::voxelCount(extent));
+	REQUIRE(image->GetPointData()->GetScalars()->GetNumberOfTuples() == VolumeIndex::voxelCount(extent));
+
+	// The reader let go of its copy; the loader output holds the only one
+	REQUIRE(reader->GetOutput()->GetPointData()->GetScalars() == nullptr);
+
+	ImageSliceProvider provider(image);
+	for (std::size_t m = 0; m < reader->marks.size(); ++m) {
+		const int* ijk = reader->marks[m].data();
+		REQUIRE(provider.voxelValue(ijk[0], ijk[1], ijk[2]) == 1000 + m);
+
+		// The mark shows up at its in-plane position in all three orientations
+		for (int axis = 0; axis < 3; ++axis) {
+			vtkNew<vtkImageData> slice;
+			REQUIRE(provider.extractSlice(axis, ijk[axis], slice));
+			REQUIRE(slice->GetScalarComponentAsDouble(ijk[0], ijk[1], ijk[2], 0) == 1000 + m);
+		}
+	}
+}